@@ -0,0 +1,164 @@
+#ifndef BACKTESTER_HPP
+#define BACKTESTER_HPP
+
+#include "depth_parser.hpp"
+#include "order_book.hpp"
+#include "quote_engine.hpp"
+#include "rolling_volatility.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Событийный бэктест маркет-мейкинга на L2-данных одного символа.
+//
+// Рыночные события (снапшоты и diff стакана) подаются вызывающим в порядке времени.
+// Внутренние события — приход нашей заявки на биржу и отчет об исполнении стратегии —
+// лежат в куче по времени; перед каждым рыночным событием выполняются все
+// внутренние с временем не позже него. Между решением стратегии и биржей проходит
+// order_latency_ns, между исполнением и тем, что стратегия узнает о нем, —
+// report_latency_ns: стратегия котирует по инвентарю, известному ей, а PnL
+// считается по фактическому.
+//
+// Модель исполнения по очереди L2 (сделок в данных нет, только изменения уровней):
+//   - новая заявка встает в конец очереди своего уровня: впереди весь видимый объем;
+//   - уменьшение объема уровня сначала съедает очередь впереди нас;
+//   - уменьшение сверх нее на лучшем уровне стороны считается сделками по нашей заявке;
+//   - уровень исчез, и лучшая цена стороны ушла за нашу, или противоположная сторона
+//     дошла до нашей цены — заявка исполнена целиком (рынок прошел сквозь нее).
+// Заявки только пассивные (post-only): пересекающая стакан на момент прихода отклоняется.
+//
+// Память резервируется заранее; обработка события не аллоцирует (кроме роста кучи
+// сверх зарезервированного).
+class Backtester {
+public:
+    struct Config {
+        double gamma = 0.1;                           // Параметры Avellaneda-Stoikov
+        double T = 300.0;
+        double order_size = 1.0;
+        double tick_size = 0.01;                      // Котировки округляются наружу до тика
+        double max_inventory = 10.0;                  // Сторона, увеличивающая |инвентарь| сверх предела, не котируется
+        double maker_fee = 0.0;                       // Доля оборота; отрицательная — ребейт
+        uint64_t order_latency_ns = 1000000;          // Решение стратегии → биржа
+        uint64_t report_latency_ns = 1000000;         // Исполнение на бирже → стратегия
+        uint64_t quote_interval_ns = 0;               // Минимум между пересчетами котировки
+        uint64_t sigma_halflife_ns = 10000000000ull;  // EWMA волатильности mid
+        double min_sigma = 0.05;
+        uint64_t sample_interval_ns = 1000000000ull;  // Период выборок для SampleHandler
+    };
+
+    // Состояние на момент выборки
+    struct Sample {
+        uint64_t time_ns;
+        double mid;
+        double quote_bid;  // Наши заявки на бирже; 0 — стороны нет
+        double quote_ask;
+        double inventory;
+        double cash;
+        double equity;     // cash + inventory * mid
+    };
+
+    struct Stats {
+        uint64_t market_events;
+        uint64_t internal_events;   // Приходы заявок и отчеты
+        uint64_t order_updates;     // Заявок (замен и отмен) отправлено стратегией
+        uint64_t rejected;          // Post-only заявка пересекла стакан
+        uint64_t gaps;              // Пропуски в update id: до снапшота рынок не обрабатывается
+        uint64_t fills;
+        double buy_qty;
+        double sell_qty;
+        double volume;              // Оборот в валюте котировки
+        double fees;
+        double cash;
+        double inventory;
+        double equity;              // По последнему mid
+        double max_abs_inventory;
+        double max_drawdown;        // От пика equity
+    };
+
+    using SampleHandler = std::function<void(const Sample&)>;
+
+    explicit Backtester(Config config);
+
+    void set_sample_handler(SampleHandler handler) { on_sample_ = std::move(handler); }
+
+    // Рыночные события в неубывающем порядке time_ns
+    void on_snapshot(const DepthUpdate& snapshot, uint64_t time_ns);
+    void on_update(const DepthUpdate& update, uint64_t time_ns);
+
+    // Выполнение оставшихся внутренних событий (конец данных)
+    void finish();
+
+    Stats stats() const { return stats_; }
+    const OrderBook& book() const { return book_; }
+    const Config& config() const { return config_; }
+    // Тик в фиксированной точке, не меньше 1 (tick_size мельче 1e-8 не делит цены на ноль)
+    int64_t tick() const { return tick_; }
+
+private:
+    enum Side : uint8_t { BID = 0, ASK = 1 };
+
+    enum class EventType : uint8_t {
+        OrderArrival,  // Заявка стратегии дошла до биржи (qty = 0 — отмена)
+        FillReport,    // Стратегия узнает об исполнении
+        RejectReport   // Стратегия узнает об отклонении
+    };
+
+    struct Event {
+        uint64_t time_ns;
+        uint64_t seq;      // Порядок постановки при равном времени
+        EventType type;
+        uint8_t side;
+        int64_t price;     // Фиксированная точка
+        int64_t qty;
+    };
+
+    // Наша заявка на бирже
+    struct RestingOrder {
+        bool active = false;
+        int64_t price = 0;
+        int64_t qty = 0;          // Остаток
+        int64_t queue_ahead = 0;  // Видимый объем уровня впереди нас
+        int64_t level_qty = 0;    // Последний известный объем уровня (без нашей заявки)
+    };
+
+    // Что стратегия отправила на биржу по стороне
+    struct SentQuote {
+        int64_t price = 0;
+        int64_t qty = 0;
+    };
+
+    Config config_;
+    QuoteEngine engine_;
+    OrderBook book_;
+    RollingVolatility volatility_;
+    std::vector<Event> events_;  // Куча по (time_ns, seq)
+    uint64_t next_seq_ = 0;
+
+    RestingOrder orders_[2];
+    SentQuote sent_[2];
+    double known_inventory_ = 0.0;  // Инвентарь с точки зрения стратегии
+    int64_t tick_;
+    int64_t order_qty_;
+
+    uint64_t now_ = 0;
+    uint64_t last_quote_ns_ = 0;
+    uint64_t next_sample_ns_ = 0;
+    bool quoted_ = false;
+    double peak_equity_ = 0.0;
+    Stats stats_{};
+    SampleHandler on_sample_;
+
+    void push_event(uint64_t time_ns, EventType type, uint8_t side, int64_t price, int64_t qty);
+    void run_events(uint64_t until_ns);
+    void handle_event(const Event& event);
+    void place_order(uint8_t side, int64_t price, int64_t qty);
+    void match_level(uint8_t side, const PriceLevel* levels, size_t count);
+    void match_through(uint8_t side);
+    void fill(uint8_t side, int64_t qty);
+    void on_market(uint64_t time_ns);
+    void decide(uint64_t time_ns);
+    void mark(double mid);
+};
+
+#endif
@@ -1,51 +1,261 @@
 #ifndef BINANCE_CLIENT_HPP
 #define BINANCE_CLIENT_HPP
 
+#include "capture_log.hpp"
+#include "depth_parser.hpp"
+#include "market_data_event.hpp"
+#include "order_book.hpp"
+#include "stream_dispatch.hpp"
+#include "tls_session_cache.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <string>
 #include <functional>
+#include <memory>
+#include <random>
+#include <vector>
 #include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
 #include <boost/beast/websocket.hpp>
+#include <boost/asio/ssl/host_name_verification.hpp>
 #include <boost/asio/strand.hpp>
 #include <nlohmann/json.hpp>
 
 namespace beast = boost::beast;
 namespace websocket = beast::websocket;
+namespace http = beast::http;
 namespace net = boost::asio;
+namespace ssl = net::ssl;
 using tcp = net::ip::tcp;
 using json = nlohmann::json;
 
 class BinanceClient {
 public:
-    using MarketDataCallback = std::function<void(const json&)>;
-    
-    BinanceClient(net::io_context& ioc);
-    
-    // Подключение к WebSocket и подписка на данные
-    void connect_and_subscribe(const std::string& symbol, MarketDataCallback callback);
-    
     // Структура для хранения рыночных данных
     struct MarketData {
+        uint32_t symbol_id;        // Индекс символа в порядке подписки
+        const char* symbol;        // Имя символа из подписки ("ethusdt")
         double bid_price;
         double bid_qty;
         double ask_price;
         double ask_qty;
         double last_price;
         uint64_t event_time;
+        uint64_t recv_time_ns;     // Чтение кадра из сокета, нс по системным часам
+        uint64_t parse_time_ns;    // Кадр разобран (до обновления стакана)
+        uint64_t first_update_id;
+        uint64_t final_update_id;
+        double k;                  // QuoteEngine::depth_intensity по полосе 0 (set_depth_bands), иначе 0
+        const DepthUpdate* depth;  // Все уровни сообщения, валидны только внутри колбэка
+        const OrderBook* book;     // Стакан после применения сообщения
+
+        // Копия top-of-book для передачи в поток стратегии (MarketDataPipeline)
+        MarketDataEvent to_event() const {
+            uint64_t parse_delay = parse_time_ns > recv_time_ns ? parse_time_ns - recv_time_ns : 0;
+            return {static_cast<uint16_t>(symbol_id), 0,
+                    static_cast<uint32_t>(std::min<uint64_t>(parse_delay, UINT32_MAX)),
+                    bid_price, bid_qty, ask_price, ask_qty, event_time, recv_time_ns, k};
+        }
+    };
+
+    // Статистика по символу
+    struct SymbolStats {
+        uint64_t messages;         // Кадров, адресованных символу
+        uint64_t updates_applied;  // Применено к стакану
+        uint64_t stale_updates;    // Старее снапшота
+        uint64_t unsynced_updates; // Пришли до загрузки снапшота (буферизуются до него)
+        uint64_t unsynced_dropped; // Вытеснены из переполненного буфера
+        uint64_t gaps;             // Разрывы последовательности update id
+        uint64_t snapshots;        // Загружено снапшотов
+        uint64_t updates_lost;     // Пропущено update id (разрывы и переподключения)
+        uint64_t last_event_time;
     };
 
+    // Состояние соединения
+    enum class ConnectionState {
+        Idle,         // connect_and_subscribe еще не вызывался
+        Resolving,
+        Connecting,
+        Handshaking,
+        Streaming,
+        Backoff       // Ждем таймер перед следующей попыткой
+    };
+
+    // Экспоненциальная задержка переподключения с джиттером
+    struct ReconnectPolicy {
+        std::chrono::milliseconds initial_delay{100};
+        std::chrono::milliseconds max_delay{30000};
+        double multiplier = 2.0;
+        double jitter = 0.2;  // Задержка умножается на случайное число из [1 - jitter, 1 + jitter]
+    };
+
+    // Метрики соединения; можно читать из любого потока
+    struct ConnectionStats {
+        uint64_t connects;            // Успешных подключений
+        uint64_t disconnects;         // Потерь соединения
+        uint64_t failed_attempts;     // Неудачных попыток подключения
+        uint64_t disconnected_ns;     // Суммарное время без соединения, включая текущий разрыв
+        uint64_t updates_lost;        // Пропущено update id по всем символам
+        uint64_t tls_resumed;         // Подключений с возобновленной TLS-сессией
+        uint64_t last_connect_ns;     // Длительность последнего подключения: resolve, TCP, TLS, WebSocket
+    };
+
+    // Параметры транспорта. Задаются до connect_and_subscribe.
+    struct TransportConfig {
+        std::string host = "stream.binance.com";
+        std::string port = "9443";
+        std::string rest_host = "api.binance.com";
+        std::string rest_port = "443";
+        bool verify_peer = true;          // Проверка сертификата и имени хоста
+        bool session_resumption = true;   // Повторное использование TLS-сессии при переподключении
+        bool tcp_nodelay = true;
+        int receive_buffer_size = 0;      // SO_RCVBUF, 0 — значение ОС
+        int send_buffer_size = 0;         // SO_SNDBUF, 0 — значение ОС
+    };
+
+    using MarketDataCallback = std::function<void(const MarketData&)>;
+
+    BinanceClient(net::io_context& ioc);
+
+    // Подключение к WebSocket и подписка на данные. Все символы идут через
+    // одно combined-stream соединение, у каждого свой стакан и статистика.
+    void connect_and_subscribe(const std::vector<std::string>& symbols, MarketDataCallback callback);
+    void connect_and_subscribe(const std::string& symbol, MarketDataCallback callback);
+
+    // Символы и колбэк без подключения (воспроизведение захвата)
+    void set_symbols(const std::vector<std::string>& symbols);
+    void set_callback(MarketDataCallback callback) { callback_ = std::move(callback); }
+
+    // Загрузка снапшота стакана (тело ответа REST /api/v3/depth) и применение
+    // обновлений, накопленных, пока стакан не был синхронизирован: старее снапшота
+    // отбрасываются, первое должно содержать lastUpdateId + 1 (процедура Binance)
+    bool apply_snapshot(uint32_t symbol_id, const char* data, size_t size);
+
+    // Сколько diff-обновлений символа хранится до прихода снапшота
+    static constexpr size_t MAX_BUFFERED_UPDATES = 4096;
+
+    // Разбор кадра WebSocket, обновление стакана и вызов колбэка.
+    // Тот же путь используется при воспроизведении захвата (CaptureReplay).
+    void process_message(const char* data, size_t size, uint64_t recv_time_ns = 0);
+
+    size_t symbol_count() const { return feeds_.size(); }
+
+    // Индекс символа по имени в любом регистре; -1, если символ не подписан
+    int32_t find_symbol(const char* symbol) const;
+
+    const OrderBook& order_book(uint32_t symbol_id = 0) const { return feeds_[symbol_id]->book; }
+    const SymbolStats& symbol_stats(uint32_t symbol_id) const { return feeds_[symbol_id]->stats; }
+
+    // Полосы глубины (±pct от mid) у стаканов всех символов, см. OrderBook::add_depth_band.
+    // Действует и на символы, подписанные позже.
+    void set_depth_bands(const std::vector<double>& pcts);
+
+    // Запись всех сырых кадров в файл захвата (nullptr — отключить)
+    void enable_capture(CaptureWriter* capture) { capture_ = capture; }
+
+    void set_transport(const TransportConfig& transport);
+    void set_reconnect_policy(const ReconnectPolicy& policy) { reconnect_policy_ = policy; }
+    ConnectionState connection_state() const { return state_.load(std::memory_order_relaxed); }
+    ConnectionStats connection_stats() const;
+
 private:
+    struct BufferedUpdate {
+        std::string payload;
+        uint64_t recv_time_ns;
+    };
+
+    // Состояние одного символа
+    struct SymbolFeed {
+        std::string symbol;       // Нижний регистр, как в имени потока ("ethusdt")
+        std::string rest_symbol;  // Верхний регистр для REST ("ETHUSDT")
+        OrderBook book;
+        MarketData market_data{};
+        SymbolStats stats{};
+        uint64_t last_applied_id = 0;  // Последний примененный update id (для подсчета потерь)
+        bool snapshot_queued = false;
+        // Сырые diff-обновления, пришедшие без синхронизации (запрос снапшота в пути),
+        // не больше MAX_BUFFERED_UPDATES: при переполнении вытесняются старые
+        std::deque<BufferedUpdate> buffered;
+    };
+
+    using TlsStream = beast::ssl_stream<beast::tcp_stream>;
+    using WebSocket = websocket::stream<TlsStream>;
+
     net::io_context& ioc_;
-    websocket::stream<beast::tcp_stream> ws_;
+    net::strand<net::io_context::executor_type> strand_;
+    TransportConfig transport_;
+    ssl::context ssl_ctx_;
+    TlsSessionCache ws_session_;
+    TlsSessionCache rest_session_;
+    std::unique_ptr<WebSocket> ws_;  // Пересоздается на каждое подключение
+    std::unique_ptr<WebSocket> retired_ws_;  // Закрытый поток, пока завершаются его обработчики
     beast::flat_buffer buffer_;
+    tcp::resolver resolver_;
     net::steady_timer connection_timer_;
-    std::string host_ = "stream.binance.com";
-    std::string port_ = "9443";
+    net::steady_timer reconnect_timer_;
+    std::string stream_suffix_ = "@depth@100ms";
+    std::vector<double> depth_bands_;
     MarketDataCallback callback_;
+    std::unique_ptr<DepthUpdate> depth_;  // Буфер разбора, переиспользуется между сообщениями
+    CaptureWriter* capture_ = nullptr;
+    bool live_ = false;  // Есть сетевое подключение (иначе воспроизведение)
+
+    // Машина состояний переподключения. Поколение соединения отсекает
+    // обработчики, завершившиеся после закрытия старого сокета.
+    std::atomic<ConnectionState> state_{ConnectionState::Idle};
+    uint64_t generation_ = 0;
+    ReconnectPolicy reconnect_policy_;
+    uint32_t reconnect_attempt_ = 0;
+    std::mt19937 jitter_rng_{std::random_device{}()};
+    std::atomic<int64_t> disconnected_since_ns_{0};  // 0 — соединение установлено или еще не начиналось
+    std::atomic<uint64_t> connects_{0};
+    std::atomic<uint64_t> disconnects_{0};
+    std::atomic<uint64_t> failed_attempts_{0};
+    std::atomic<uint64_t> disconnected_ns_{0};
+    std::atomic<uint64_t> updates_lost_{0};
+    std::atomic<uint64_t> tls_resumed_{0};
+    std::atomic<uint64_t> last_connect_ns_{0};
+    int64_t connect_started_ns_ = 0;
+
+    std::vector<std::unique_ptr<SymbolFeed>> feeds_;
+    StreamDispatchTable stream_dispatch_;  // "ethusdt@depth@100ms" -> индекс символа
+    StreamDispatchTable symbol_dispatch_;  // "ethusdt" / "ETHUSDT" -> индекс символа
+
+    // Запрос снапшотов через REST на том же strand, что и WebSocket, по одному за раз
+    tcp::resolver rest_resolver_;
+    std::unique_ptr<TlsStream> rest_stream_;  // Новый TLS-поток на каждый запрос
+    beast::flat_buffer rest_buffer_;
+    http::request<http::empty_body> snapshot_request_;
+    http::response<http::string_body> snapshot_response_;
+    std::deque<uint32_t> snapshot_queue_;
+    bool snapshot_in_flight_ = false;
+    net::steady_timer snapshot_retry_timer_;
+    uint32_t snapshot_retry_attempt_ = 0;
+
+    void start_connect();
+    void prepare_tls(TlsStream& stream, const std::string& host, TlsSessionCache& session);
+    template <class Handler>
+    void async_connect_endpoints(beast::tcp_stream& stream, tcp::resolver::results_type results,
+                                 tcp::resolver::results_type::iterator it, Handler handler);
+    void on_connection_failed(uint64_t generation, beast::error_code ec, const char* stage);
+    void on_streaming();
+    std::chrono::milliseconds next_backoff(uint32_t attempt);
+
+    void start_connection_check(uint64_t generation);
+    void start_read(uint64_t generation);
+    void request_snapshot(uint32_t symbol_id);
+    void start_next_snapshot();
+    void on_snapshot_done(uint32_t symbol_id, bool ok);
+    std::string stream_target() const;
+    int32_t route_message(const char*& data, size_t& size) const;
+    void process_depth(uint32_t symbol_id, const char* data, size_t size, uint64_t recv_time_ns);
+    void buffer_update(SymbolFeed& feed, const char* data, size_t size, uint64_t recv_time_ns);
+    void replay_buffered(uint32_t symbol_id);
 
-    void start_connection_check();
-    
-    void on_read(beast::error_code ec, std::size_t bytes_transferred);
-    void run(const std::string& host, const std::string& port);
+    void on_read(uint64_t generation, beast::error_code ec, std::size_t bytes_transferred);
 };
 
-#endif // BINANCE_CLIENT_HPP
\ No newline at end of file
+#endif // BINANCE_CLIENT_HPP
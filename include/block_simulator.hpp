@@ -0,0 +1,130 @@
+#ifndef BLOCK_SIMULATOR_HPP
+#define BLOCK_SIMULATOR_HPP
+
+#include "work_stealing_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Onchain-исполнение по блокам. Цена рынка (тики биржи) видна стратегии только на
+// границах блоков, котировка — транзакция: подписывается по цене блока, ждет включения
+// (вероятность по приоритетной комиссии), становится живой с блока включения и
+// исполняется только на границах блоков. Между подписью и включением цена уходит —
+// по живой котировке первыми приходят арбитражеры.
+//
+// Все, что не зависит от параметров стратегии, считается один раз:
+//   BlockSchedule — моменты блоков (слоты с пропусками) и base fee по EIP-1559
+//   BlockTape     — цена на границе каждого блока (слияние с тиками), волатильность
+//                   и случайные величины блока (включение, поток сделок)
+// Прогоны наборов параметров только читают их (общие случайные величины для всех
+// наборов) и выполняются параллельно; результат не зависит от числа потоков.
+
+class BlockSchedule {
+public:
+    struct Config {
+        double slot_sec = 12.0;
+        double missed_slot_prob = 0.01;  // Слот без блока: следующий блок на слот позже
+        double base_fee_gwei = 20.0;     // В первом блоке и средний уровень
+        double min_base_fee_gwei = 0.1;
+        double fullness_spread = 0.5;    // Заполнение блока target·(1 + spread·(2U - 1) + спрос)
+        double demand_reversion = 0.05;  // Спрос: reversion·ln(base_fee_gwei / base fee) — возврат к уровню
+        uint64_t seed = 42;
+    };
+
+    // Блоки на слотах в [start_ns, end_ns)
+    BlockSchedule(uint64_t start_ns, uint64_t end_ns, Config config);
+
+    const Config& config() const { return config_; }
+    size_t blocks() const { return time_ns_.size(); }
+    const uint64_t* time_ns() const { return time_ns_.data(); }
+    const double* base_fee_gwei() const { return base_fee_gwei_.data(); }
+
+private:
+    Config config_;
+    std::vector<uint64_t> time_ns_;
+    std::vector<double> base_fee_gwei_;
+};
+
+class BlockTape {
+public:
+    struct Config {
+        size_t vol_window = 300;    // Блоков в окне волатильности (час при 12 с)
+        double min_sigma = 1e-4;    // Нижняя граница волатильности блока (доля цены)
+        uint64_t seed = 42;         // Поток 1 (поток 0 — у расписания)
+    };
+
+    // Тики (time_ns по возрастанию): цена блока — последний тик не позже блока,
+    // до первого тика — первый тик. schedule должен жить дольше ленты.
+    BlockTape(const BlockSchedule& schedule, const uint64_t* tick_ns, const double* tick_price, size_t ticks,
+              Config config);
+
+    const BlockSchedule& schedule() const { return schedule_; }
+    size_t blocks() const { return price_.size(); }
+    const double* price() const { return price_.data(); }
+    // Стандартное отклонение доходности за блок по окну vol_window
+    const double* sigma() const { return sigma_.data(); }
+    // U(0, 1) блока для включения ожидающей транзакции
+    const double* inclusion_draw() const { return inclusion_.data(); }
+    // -ln U блока (Exp(1), batch_log) для сделок потока на ask и bid: проверка
+    // u < rate·exp(-x) сводится к x < ln(rate) + E, без exp в прогоне
+    const double* ask_flow_draw() const { return ask_flow_.data(); }
+    const double* bid_flow_draw() const { return bid_flow_.data(); }
+
+private:
+    const BlockSchedule& schedule_;
+    std::vector<double> price_;
+    std::vector<double> sigma_;
+    std::vector<double> inclusion_;
+    std::vector<double> ask_flow_;
+    std::vector<double> bid_flow_;
+};
+
+// Котировка — Avellaneda-Stoikov (QuoteEngine) по цене и волатильности блока подписи
+// (sigma в единицах цены за блок, поэтому инвентарный член q·σ²·T — в долларах).
+// Транзакция котировки заменяет обе стороны сразу; после исполнения сторона снята
+// до следующей котировки.
+struct OnchainParams {
+    double gamma = 0.1;
+    double T = 1.0;                  // Горизонт в блоках
+    double min_spread = 0.001;       // Доля цены
+    double trade_size = 1.0;
+    double max_inventory = 10.0;     // Сторона, которая вывела бы за предел, не котируется
+    double requote = 0.0005;         // Переподписать, если цена ушла от опорной больше чем на долю
+    double tip_gwei = 1.0;           // Приоритетная комиссия
+    double max_fee_multiplier = 2.0; // max fee = base fee блока подписи · множитель
+    uint32_t ttl_blocks = 5;         // Не включенная за ttl блоков транзакция отбрасывается
+    // Вероятность включения в блок: tip / (tip + inclusion_tip_gwei), если base fee блока
+    // не выше max fee - tip (иначе меньший чаевой остаток)
+    double inclusion_tip_gwei = 1.0;
+    // Поток сделок: на стороне за блок с вероятностью flow_rate · exp(-flow_decay · δ / S),
+    // δ — расстояние котировки от цены блока. k для котирования — flow_decay / S.
+    double flow_rate = 0.5;
+    double flow_decay = 1000.0;
+};
+
+struct OnchainResult {
+    double pnl;              // cash + inventory · последняя цена блока, газ вычтен
+    double gas_paid;         // В валюте котировки (газ в ETH по цене блока)
+    double max_drawdown;
+    double final_inventory;
+    uint64_t fills;
+    uint64_t arbitrage_fills;  // Цена блока пересекла котировку
+    uint64_t txs_signed;
+    uint64_t txs_included;
+    uint64_t txs_expired;
+    double mean_inclusion_blocks;  // От блока подписи до включения
+    double mean_drift;             // |цена включения / цена подписи - 1|
+};
+
+OnchainResult simulate_onchain_run(const OnchainParams& params, const BlockTape& tape);
+
+// Результат i — params[i]. С pool — параллельно.
+std::vector<OnchainResult> run_onchain_sweep(const std::vector<OnchainParams>& params, const BlockTape& tape,
+                                             WorkStealingPool* pool = nullptr);
+
+// Строка — набор параметров: ключевые параметры и поля OnchainResult (ColumnWriter)
+bool write_onchain_results(const std::string& path, const std::vector<OnchainParams>& params,
+                           const std::vector<OnchainResult>& results);
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef CAPTURE_LOG_HPP
+#define CAPTURE_LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Формат файла захвата рыночных данных:
+//   CaptureFileHeader
+//   CaptureRecordHeader + payload (сырой кадр WebSocket), выровнено на 8 байт
+//   ...
+// Файл дописывается только в конец, при ротации обрезается до записанного размера.
+constexpr char CAPTURE_MAGIC[8] = {'M', 'D', 'C', 'A', 'P', '0', '0', '1'};
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr size_t CAPTURE_ALIGNMENT = 8;
+
+// Флаги записи
+constexpr uint32_t CAPTURE_FLAG_SNAPSHOT = 1;  // Тело REST-снапшота стакана, а не кадр WebSocket
+
+struct CaptureFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t created_ns;
+};
+
+struct CaptureRecordHeader {
+    uint64_t recv_time_ns;  // Локальное время получения кадра (UNIX, нс)
+    uint32_t payload_size;  // Размер кадра без выравнивания
+    uint32_t flags;         // CAPTURE_FLAG_*
+    char symbol[16];        // Тег символа, дополненный нулями
+};
+
+inline size_t capture_record_size(size_t payload_size) {
+    size_t size = sizeof(CaptureRecordHeader) + payload_size;
+    return (size + CAPTURE_ALIGNMENT - 1) & ~(CAPTURE_ALIGNMENT - 1);
+}
+
+// Запись сырых кадров в memory-mapped файлы с ротацией.
+// Поток io_context только копирует кадр в заранее выделенный кольцевой
+// буфер (без блокировок и системных вызовов); фоновый поток переносит
+// записи в отображенный файл. Следующий файл создается и отображается
+// заранее, поэтому ротация не задерживает ни чтение сокета, ни запись.
+class CaptureWriter {
+public:
+    struct Stats {
+        uint64_t records_written;
+        uint64_t bytes_written;
+        uint64_t records_dropped;  // Кольцевой буфер был переполнен
+        uint64_t files_rotated;
+    };
+
+    // base_path — префикс файлов (base_path.000000.mdcap, ...); занятые номера
+    // пропускаются. ring_bytes округляется вверх до степени двойки
+    CaptureWriter(const std::string& base_path,
+                  size_t ring_bytes = 64 << 20,
+                  size_t file_bytes = size_t(1) << 30);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool start();
+    void stop();  // Дописывает все накопленные записи и закрывает файл
+
+    // Вызывается из одного потока-производителя (поток io_context).
+    // Никогда не блокируется: при переполнении запись отбрасывается.
+    bool record(const char* symbol, const char* data, size_t size, uint64_t recv_time_ns,
+                uint32_t flags = 0);
+
+    Stats stats() const;
+
+private:
+    struct Segment {
+        std::string path;
+        int fd = -1;
+        char* data = nullptr;
+        size_t used = 0;
+    };
+
+    std::string base_path_;
+    size_t file_bytes_;
+    size_t ring_mask_;
+    std::unique_ptr<char[]> ring_;
+
+    // Счетчики байт, а не индексы: позиция в буфере = счетчик & ring_mask_
+    alignas(64) std::atomic<uint64_t> head_{0};  // Пишет производитель
+    alignas(64) std::atomic<uint64_t> tail_{0};  // Пишет фоновый поток
+
+    alignas(64) std::atomic<uint64_t> records_written_{0};
+    std::atomic<uint64_t> bytes_written_{0};
+    std::atomic<uint64_t> records_dropped_{0};
+    std::atomic<uint64_t> files_rotated_{0};
+
+    std::atomic<bool> running_{false};
+    std::thread writer_thread_;
+    Segment current_;
+    Segment next_;
+    uint64_t file_index_ = 0;
+
+    void copy_to_ring(uint64_t pos, const void* src, size_t size);
+    void copy_from_ring(uint64_t pos, void* dst, size_t size) const;
+    void writer_loop();
+    size_t drain();
+    bool open_segment(Segment& segment);
+    void close_segment(Segment& segment);
+    bool rotate();
+};
+
+#endif
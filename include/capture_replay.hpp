@@ -0,0 +1,76 @@
+#ifndef CAPTURE_REPLAY_HPP
+#define CAPTURE_REPLAY_HPP
+
+#include "capture_log.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BinanceClient;
+
+// Чтение файла захвата через mmap: записи отдаются указателями
+// прямо в отображенную память, без копирования.
+class CaptureReader {
+public:
+    explicit CaptureReader(const std::string& path);
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool is_open() const { return data_ != nullptr; }
+
+    // Следующая запись; false — конец файла или поврежденная запись
+    bool next(const CaptureRecordHeader*& header, const char*& payload);
+    void rewind() { offset_ = header_size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t header_size_ = 0;
+    size_t offset_ = 0;
+};
+
+// Воспроизведение захваченных файлов через тот же путь разбора,
+// что и у живого BinanceClient (process_message / apply_snapshot).
+class CaptureReplay {
+public:
+    enum class Mode {
+        AsFastAsPossible,  // Бэктесты и исследования
+        Paced              // По исходным временным меткам (с масштабом speed) для soak-тестов
+    };
+
+    struct Stats {
+        uint64_t messages;
+        uint64_t bytes;
+        double elapsed_sec;
+    };
+
+    using FrameHandler = std::function<void(const CaptureRecordHeader&, const char* payload)>;
+
+    // speed > 1 ускоряет воспроизведение в режиме Paced
+    CaptureReplay(std::vector<std::string> paths, Mode mode = Mode::AsFastAsPossible, double speed = 1.0);
+
+    // Теги символов, встречающиеся в файлах (в порядке первого появления)
+    std::vector<std::string> symbols() const;
+
+    // Воспроизведение в произвольный обработчик
+    Stats run(const FrameHandler& handler);
+
+    // Воспроизведение в клиент: снапшоты — в apply_snapshot, кадры — в process_message.
+    // Символы клиента должны быть заданы заранее (set_symbols).
+    Stats run(BinanceClient& client);
+
+    // Можно вызвать из другого потока
+    void stop() { stopped_ = true; }
+
+private:
+    std::vector<std::string> paths_;
+    Mode mode_;
+    double speed_;
+    std::atomic<bool> stopped_{false};
+};
+
+#endif
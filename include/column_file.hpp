@@ -0,0 +1,189 @@
+#ifndef COLUMN_FILE_HPP
+#define COLUMN_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+// Колоночный файл результатов (бэктесты, переборы параметров):
+//   ColumnFileHeader
+//   ColumnInfo[columns]
+//   чанки: для каждой группы из chunk_rows строк — блок каждой колонки,
+//          начало блока выровнено на 64 байта
+//   ColumnChunk[chunks * columns] — индекс блоков (чанк за чанком)
+//   ColumnFileFooter
+// Все значения 8-байтные. Блок хранится как есть (Raw — читается прямо из
+// отображенной памяти) или сжатым, если так короче:
+//   DeltaOfDelta — целые: zigzag изменения разности соседних значений, LEB128
+//                  (метки времени с постоянным шагом и счетчики — байт на строку)
+//   XorBytes     — double: XOR с битами предыдущего значения, на значение полубайт
+//                  с числом значащих байт и сами байты (неизменные значения — полбайта)
+// Индекс и футер пишутся при закрытии: файл без футера (прерванная запись) не читается.
+constexpr char COLUMN_FILE_MAGIC[8] = {'M', 'M', 'C', 'O', 'L', '0', '0', '1'};
+constexpr uint32_t COLUMN_FILE_VERSION = 1;
+constexpr size_t COLUMN_ALIGNMENT = 64;
+
+enum class ColumnType : uint32_t { U64 = 1, I64 = 2, F64 = 3 };
+enum class ColumnCodec : uint32_t { Raw = 0, DeltaOfDelta = 1, XorBytes = 2 };
+
+struct ColumnFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t columns;
+    uint64_t created_ns;
+};
+
+struct ColumnInfo {
+    char name[24];     // Дополнено нулями
+    ColumnType type;
+    ColumnCodec codec; // Сжатие, которое пробует писатель
+};
+
+struct ColumnChunk {
+    uint64_t offset;   // От начала файла
+    uint64_t bytes;
+    uint32_t rows;
+    ColumnCodec codec; // Фактическое: Raw, если сжатие не помогло
+};
+
+struct ColumnFileFooter {
+    uint64_t index_offset;
+    uint64_t chunks;
+    uint64_t rows;
+    char magic[8];
+};
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+// Значение строки: тип задается колонкой
+union ColumnValue {
+    uint64_t u;
+    int64_t i;
+    double f;
+
+    ColumnValue(uint64_t value) : u(value) {}
+    ColumnValue(int64_t value) : i(value) {}
+    ColumnValue(double value) : f(value) {}
+};
+
+// Запись строк по одной: значения копируются в буферы колонок текущего чанка,
+// кодирование и запись — раз в chunk_rows строк. Не потокобезопасен.
+class ColumnWriter {
+public:
+    struct Config {
+        size_t chunk_rows = 65536;
+        bool compress = true;
+    };
+
+    struct Stats {
+        uint64_t rows;
+        uint64_t chunks;
+        uint64_t raw_bytes;   // Значения без сжатия
+        uint64_t file_bytes;
+    };
+
+    ColumnWriter(const std::string& path, const std::vector<ColumnSpec>& columns)
+        : ColumnWriter(path, columns, Config{}) {}
+    ColumnWriter(const std::string& path, const std::vector<ColumnSpec>& columns, Config config);
+    ~ColumnWriter();  // Закрывает файл, если close не вызван
+
+    ColumnWriter(const ColumnWriter&) = delete;
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+    bool is_open() const { return file_ != nullptr; }
+    size_t columns() const { return columns_.size(); }
+
+    // Значения строки в порядке колонок (ровно columns() штук)
+    void append(const ColumnValue* row) {
+        for (size_t c = 0; c < columns_.size(); ++c) buffers_[c][filled_] = row[c].u;
+        if (++filled_ == config_.chunk_rows) flush_chunk();
+    }
+    void append(std::initializer_list<ColumnValue> row) { append(row.begin()); }
+
+    // Последний чанк, индекс и футер; false — ошибка записи
+    bool close();
+
+    Stats stats() const { return stats_; }
+
+private:
+    std::string path_;
+    Config config_;
+    std::vector<ColumnInfo> columns_;
+    std::vector<std::vector<uint64_t>> buffers_;  // Значения текущего чанка по колонкам
+    size_t filled_ = 0;
+    std::vector<ColumnChunk> index_;
+    std::vector<uint8_t> encoded_;
+    std::FILE* file_ = nullptr;
+    uint64_t offset_ = 0;
+    bool failed_ = false;
+    Stats stats_{};
+
+    void flush_chunk();
+    void write(const void* data, size_t bytes);
+    void pad_to_alignment();
+};
+
+// Чтение через mmap: открываются только заголовок и индекс, данные колонки
+// затрагиваются лишь при ее чтении. Несжатые блоки доступны без копирования.
+class ColumnReader {
+public:
+    explicit ColumnReader(const std::string& path);
+    ~ColumnReader();
+
+    ColumnReader(const ColumnReader&) = delete;
+    ColumnReader& operator=(const ColumnReader&) = delete;
+
+    bool is_open() const { return data_ != nullptr; }
+
+    uint64_t rows() const { return rows_; }
+    size_t columns() const { return columns_; }
+    size_t chunks() const { return chunks_; }
+    const ColumnInfo& column(size_t column) const { return info_[column]; }
+    // Номер колонки по имени, -1 — нет такой
+    int find(const std::string& name) const;
+
+    const ColumnChunk& chunk(size_t chunk, size_t column) const { return index_[chunk * columns_ + column]; }
+    // Блок Raw прямо в отображенной памяти (rows значений), иначе nullptr
+    const void* raw_chunk(size_t chunk, size_t column) const;
+
+    // Значения блока в out (chunk(...).rows штук по 8 байт); false — блок поврежден
+    bool read_chunk(size_t chunk, size_t column, void* out) const;
+    // Колонка целиком в out (rows() значений)
+    bool read_column(size_t column, void* out) const;
+
+    // Колонка по имени; тип T должен совпадать с типом колонки
+    template <class T>
+    bool read_column(const std::string& name, std::vector<T>& out) const {
+        int column = find(name);
+        if (column < 0 || info_[column].type != column_type<T>()) return false;
+        out.resize(rows_);
+        return read_column(static_cast<size_t>(column), out.data());
+    }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    const ColumnInfo* info_ = nullptr;
+    const ColumnChunk* index_ = nullptr;
+    size_t columns_ = 0;
+    size_t chunks_ = 0;
+    uint64_t rows_ = 0;
+
+    template <class T>
+    static constexpr ColumnType column_type();
+};
+
+template <>
+constexpr ColumnType ColumnReader::column_type<uint64_t>() { return ColumnType::U64; }
+template <>
+constexpr ColumnType ColumnReader::column_type<int64_t>() { return ColumnType::I64; }
+template <>
+constexpr ColumnType ColumnReader::column_type<double>() { return ColumnType::F64; }
+
+#endif
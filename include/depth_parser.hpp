@@ -0,0 +1,60 @@
+#ifndef DEPTH_PARSER_HPP
+#define DEPTH_PARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Цены и объемы храним в фиксированной точке с 8 знаками (как у Binance)
+constexpr int FIXED_POINT_DIGITS = 8;
+constexpr int64_t FIXED_POINT_SCALE = 100000000;
+
+inline double fixed_to_double(int64_t value) {
+    return static_cast<double>(value) / FIXED_POINT_SCALE;
+}
+
+inline int64_t double_to_fixed(double value) {
+    return static_cast<int64_t>(value * FIXED_POINT_SCALE + (value >= 0 ? 0.5 : -0.5));
+}
+
+struct PriceLevel {
+    int64_t price;  // Цена в фиксированной точке
+    int64_t qty;    // Объем в фиксированной точке (0 = уровень удален)
+};
+
+// Максимум уровней на сторону (лимит REST-снапшота /api/v3/depth)
+constexpr size_t MAX_DEPTH_LEVELS = 5000;
+
+// Разобранное сообщение @depth (diff) или REST-снапшот стакана
+struct DepthUpdate {
+    uint64_t event_time;       // "E"
+    uint64_t first_update_id;  // "U" (у снапшота равен lastUpdateId)
+    uint64_t final_update_id;  // "u" или "lastUpdateId"
+    char symbol[16];           // "s", пустая строка у снапшота
+    size_t bid_count;
+    size_t ask_count;
+    PriceLevel bids[MAX_DEPTH_LEVELS];
+    PriceLevel asks[MAX_DEPTH_LEVELS];
+};
+
+// Разбор десятичной строки ("2000.12345678") в фиксированную точку.
+// Лишние знаки после 8-го отбрасываются. Сдвигает p за конец числа.
+// false — нет ни одной цифры или целая часть длиннее 10 значащих цифр.
+bool parse_fixed_point(const char*& p, const char* end, int64_t& out);
+
+// Потоковый разбор сообщения стакана прямо из буфера сокета, без аллокаций.
+// Понимает diff-формат ("b"/"a", "U"/"u") и формат снапшота
+// ("bids"/"asks", "lastUpdateId"). Возвращает false, если сообщение
+// некорректно, не содержит обеих сторон или уровней больше MAX_DEPTH_LEVELS.
+bool parse_depth_update(const char* data, size_t size, DepthUpdate& out);
+
+// Разбор обертки combined stream: {"stream":"<name>","data":{...}}.
+// Возвращает указатели на имя потока и на начало объекта data внутри
+// исходного буфера. Если "stream" идет раньше "data" (как у Binance),
+// data не сканируется: payload_size — остаток буфера, парсер сообщения
+// сам остановится на закрывающей скобке. false — обертки нет
+// (первым ключом ожидается "stream" или "data").
+bool parse_stream_envelope(const char* data, size_t size,
+                           const char*& stream, size_t& stream_size,
+                           const char*& payload, size_t& payload_size);
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Формат бинарного журнала событий:
+//   EventLogFileHeader
+//   LogRecord, LogRecord, ... (фиксированный размер, без выравнивания между записями)
+constexpr char EVENT_LOG_MAGIC[8] = {'M', 'M', 'E', 'V', 'L', 'O', 'G', '1'};
+constexpr uint32_t EVENT_LOG_VERSION = 1;
+
+struct EventLogFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t created_ns;
+};
+
+enum class LogEventType : uint16_t {
+    Quote = 1,    // values: S_t, sigma, base_ask, base_bid, ask, bid, inventory
+    Fill = 2,     // code: LogFillSide; values: price, market_price, gas_cost, inventory
+    Warning = 3   // code: LogWarning; values зависят от кода
+};
+
+enum class LogFillSide : uint16_t { None = 0, Buy = 1, Sell = 2 };
+
+enum class LogWarning : uint16_t {
+    BothSidesTriggered = 1  // values: market_price, ask, bid
+};
+
+// Запись журнала: фиксированный размер, тривиально копируется в кольцо
+struct LogRecord {
+    static constexpr size_t MAX_VALUES = 9;
+
+    uint64_t time_ns;  // UNIX, нс
+    uint64_t seq;      // Номер записи в потоке-источнике (пропуски = потери)
+    uint16_t type;     // LogEventType
+    uint16_t code;
+    uint16_t thread;   // Индекс потока-источника в журнале
+    uint16_t count;    // Заполнено значений
+    double values[MAX_VALUES];
+};
+
+// Текстовое представление записи (без перевода строки); общее для журнала и декодера
+void format_log_record(const LogRecord& record, std::string& out);
+
+// Асинхронный журнал событий стратегии. Горячий поток только копирует запись
+// фиксированного размера в свое lock-free кольцо (SpscQueue) и никогда не
+// блокируется: при переполнении запись отбрасывается и учитывается в dropped.
+// Фоновый поток забирает записи из колец всех потоков и пишет их в файл —
+// текстом или как есть (бинарный формат, читается event_log_decode).
+class EventLog {
+public:
+    enum class Format { Text, Binary };
+
+    struct Config {
+        std::string path;                           // Пусто — текст в stdout
+        Format format = Format::Text;
+        size_t ring_capacity = 1 << 16;             // Записей на поток
+        std::chrono::microseconds idle_sleep{200};  // Пауза фонового потока без записей
+    };
+
+    struct Stats {
+        uint64_t written;
+        uint64_t dropped;  // Кольцо потока было заполнено
+        size_t threads;
+    };
+
+    static constexpr size_t MAX_THREADS = 64;
+
+    explicit EventLog(Config config);
+    ~EventLog();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    bool start();
+    void stop();  // Дописывает все накопленные записи и закрывает файл
+
+    // Из любого потока. Первая запись потока регистрирует его кольцо (под мьютексом,
+    // с аллокацией), дальше — без блокировок и аллокаций.
+    bool log(LogEventType type, uint16_t code, std::initializer_list<double> values);
+
+    Stats stats() const;
+
+private:
+    struct Producer {
+        explicit Producer(size_t capacity) : ring(capacity) {}
+
+        SpscQueue<LogRecord> ring;
+        std::thread::id owner;
+        uint16_t index = 0;
+        uint64_t seq = 0;
+        std::atomic<uint64_t> dropped{0};  // Пишет только поток-источник
+    };
+
+    Config config_;
+    uint64_t id_;  // Отличает журналы в кэше потока
+    std::unique_ptr<Producer> producers_[MAX_THREADS];  // Заполняются под мьютексом
+    std::atomic<size_t> producer_count_{0};             // Публикует новые кольца фоновому потоку
+    std::mutex register_mutex_;
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> unregistered_drops_{0};  // Потоков больше MAX_THREADS
+
+    std::atomic<bool> running_{false};
+    std::thread writer_thread_;
+    std::FILE* file_ = nullptr;
+    std::string text_;  // Буфер форматирования фонового потока
+
+    Producer* producer();
+    Producer* register_producer();
+    void writer_loop();
+    size_t drain();
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef FEED_RUNTIME_HPP
+#define FEED_RUNTIME_HPP
+
+#include "market_data_pipeline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+
+// Потоковая модель фида: сетевой поток крутит io_context (BinanceClient),
+// поток стратегии получает события через MarketDataPipeline.
+//   Blocking — io_context::run(), стратегия спит на пустой очереди: минимум CPU.
+//   BusyPoll — io_context::poll() в цикле и busy-spin стратегии, оба потока
+//              на выделенных (изолированных) ядрах: минимум задержки ценой двух ядер на 100%.
+class FeedRuntime {
+public:
+    enum class Mode {
+        Blocking,
+        BusyPoll
+    };
+
+    struct Config {
+        Mode mode = Mode::Blocking;
+        int network_core = -1;   // -1 — без привязки
+        int strategy_core = -1;
+        MarketDataPipeline::Config pipeline;  // idle и consumer_core задаются из mode и strategy_core
+    };
+
+    // Загрузка CPU потоком за время работы
+    struct ThreadUsage {
+        double cpu_sec;
+        double wall_sec;
+        double cpu_percent() const { return wall_sec > 0 ? cpu_sec / wall_sec * 100.0 : 0.0; }
+    };
+
+    struct Stats {
+        ThreadUsage network;
+        ThreadUsage strategy;
+        uint64_t polls;        // Итераций цикла poll() (BusyPoll)
+        uint64_t empty_polls;  // Из них без единого обработчика
+        MarketDataPipeline::Stats pipeline;
+    };
+
+    FeedRuntime(boost::asio::io_context& ioc, const Config& config, MarketDataPipeline::EventHandler handler);
+    ~FeedRuntime();
+
+    FeedRuntime(const FeedRuntime&) = delete;
+    FeedRuntime& operator=(const FeedRuntime&) = delete;
+
+    void start();
+    void stop();
+
+    // Вызывается из сетевого потока (колбэк BinanceClient)
+    bool publish(const MarketDataEvent& event) { return pipeline_.publish(event); }
+
+    Stats stats();
+
+    // "blocking" / "busy-poll"; false — неизвестное имя
+    static bool parse_mode(const std::string& name, Mode& mode);
+    static const char* mode_name(Mode mode);
+
+private:
+    boost::asio::io_context& ioc_;
+    Config config_;
+    MarketDataPipeline pipeline_;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_;
+    std::thread network_;
+    std::atomic<bool> running_{false};
+    std::chrono::steady_clock::time_point started_{};
+    std::chrono::steady_clock::time_point stopped_{};
+    double network_cpu_sec_ = 0.0;   // Фиксируется при остановке
+    double strategy_cpu_sec_ = 0.0;
+    std::atomic<uint64_t> polls_{0};
+    std::atomic<uint64_t> empty_polls_{0};
+
+    static MarketDataPipeline::Config pipeline_config(const Config& config);
+    void network_loop();
+};
+
+#endif
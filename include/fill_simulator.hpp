@@ -0,0 +1,33 @@
+#ifndef FILL_SIMULATOR_HPP
+#define FILL_SIMULATOR_HPP
+
+#include "quote_engine.hpp"
+#include "rng.hpp"
+
+enum class FillSide { None, Buy, Sell };
+
+struct Fill {
+    FillSide side;
+    double price;         // Цена нашей котировки, по которой прошла сделка
+    double market_price;  // Сгенерированная рыночная цена
+    bool conflict;        // Рыночная цена пересекла обе стороны (разрешено по инвентарю)
+};
+
+// Симуляция исполнения котировок: все случайные величины шага живут здесь,
+// QuoteEngine остается детерминированным. Собственный генератор: прогон
+// воспроизводится по seed независимо от других потоков.
+class FillSimulator {
+public:
+    void seed(uint64_t seed, uint64_t stream = 0) { rng_.seed(seed, stream); }
+
+    // Случайный сдвиг цены за время задержки onchain: N(0, sigma * sqrt(latency))
+    double latency_shift(double sigma, double latency);
+
+    // Рыночная цена mid_price + N(0, sigma); покупка, если она не выше bid, продажа — не ниже ask
+    Fill simulate(const Quote& quote, double mid_price, double sigma, double inventory);
+
+private:
+    Rng rng_;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef HISTORY_STORE_HPP
+#define HISTORY_STORE_HPP
+
+#include "rng.hpp"
+#include "work_stealing_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Исторические данные Binance: свечи и сделки из CSV-выгрузок
+// (data.binance.vision или задача 1.4) в кэш колоночных файлов по символу и дню.
+//
+// Разбор CSV: файл отображается в память и режется на куски по границам строк,
+// куски разбираются параллельно (WorkStealingPool) и склеиваются по порядку.
+// Строки, которые не разбираются (заголовок, мусор), пропускаются и считаются.
+//
+// Время в выгрузках — секунды, миллисекунды или микросекунды (Binance перешел на
+// микросекунды в 2025): единица определяется по величине значения, в памяти — нс.
+
+// Свеча: timestamp,open,high,low,close,volume[,...] (формат klines Binance и задачи 1.4)
+struct Kline {
+    uint64_t open_time_ns;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+};
+
+// Сделка: trades (id,price,qty,quote_qty,time,is_buyer_maker[,...]) или
+// aggTrades (agg_id,price,qty,first_id,last_id,time,is_buyer_maker[,...]) — по числу полей
+struct Trade {
+    uint64_t time_ns;
+    double price;
+    double qty;
+    bool buyer_maker;  // Агрессор — продавец (сделка по bid)
+};
+
+struct CsvParseStats {
+    uint64_t bytes;
+    uint64_t records;
+    uint64_t skipped;  // Неразобранные строки
+    uint64_t chunks;
+};
+
+// pool = nullptr — в текущем потоке. false — файл не открылся.
+bool parse_kline_csv(const std::string& path, std::vector<Kline>& out, WorkStealingPool* pool = nullptr,
+                     CsvParseStats* stats = nullptr);
+bool parse_trade_csv(const std::string& path, std::vector<Trade>& out, WorkStealingPool* pool = nullptr,
+                     CsvParseStats* stats = nullptr);
+
+// UTC-дата "YYYY-MM-DD" момента time_ns
+std::string utc_date(uint64_t time_ns);
+
+// Кэш: root/SYMBOL/klines/YYYY-MM-DD.mmcol и root/SYMBOL/trades/YYYY-MM-DD.mmcol
+// (ColumnWriter: время — DeltaOfDelta, около байта на запись у минутных свечей).
+// Импорт заменяет файлы дней, которые есть во входных данных.
+class HistoryStore {
+public:
+    enum class Kind {
+        Klines,
+        Trades
+    };
+
+    explicit HistoryStore(std::string root);
+
+    const std::string& root() const { return root_; }
+    std::string path(const std::string& symbol, Kind kind, const std::string& date) const;
+
+    // Записи сортируются по времени и раскладываются по UTC-дням; days — сколько файлов записано
+    bool import_klines(const std::string& symbol, std::vector<Kline> klines, size_t* days = nullptr);
+    bool import_trades(const std::string& symbol, std::vector<Trade> trades, size_t* days = nullptr);
+
+    // Дни в кэше по возрастанию
+    std::vector<std::string> dates(const std::string& symbol, Kind kind) const;
+
+    // Дни [first, last] включительно (пустая строка — без ограничения) подряд в out.
+    // false — нет ни одного дня или файл поврежден.
+    bool load_klines(const std::string& symbol, const std::string& first, const std::string& last,
+                     std::vector<Kline>& out) const;
+    bool load_trades(const std::string& symbol, const std::string& first, const std::string& last,
+                     std::vector<Trade>& out) const;
+
+private:
+    std::string root_;
+};
+
+// Эпизоды для обучения и бэктестов — окна подряд идущих свечей загруженной истории
+class KlineEpisodes {
+public:
+    explicit KlineEpisodes(std::vector<Kline> klines) : klines_(std::move(klines)) {}
+
+    size_t size() const { return klines_.size(); }
+    const std::vector<Kline>& klines() const { return klines_; }
+
+    // Окно из length свечей со случайным началом; nullptr — история короче
+    const Kline* sample(Rng& rng, size_t length) const {
+        if (length == 0 || length > klines_.size()) return nullptr;
+        return klines_.data() + rng.next_u64() % (klines_.size() - length + 1);
+    }
+
+private:
+    std::vector<Kline> klines_;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef INTENSITY_CALIBRATOR_HPP
+#define INTENSITY_CALIBRATOR_HPP
+
+#include "seqlock.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Онлайн-калибровка интенсивности исполнения λ(δ) = A·e^(−kδ) по сделкам рынка.
+//
+// Сделка на расстоянии δ = |price − mid| от середины попадает в корзину шириной
+// bucket_width. Счетчики корзин затухают экспоненциально по времени (halflife_ns),
+// поэтому число сделок в корзине, деленное на затухающее время наблюдения и ширину
+// корзины, оценивает плотность потока по δ: A·k·e^(−kδ). Прямая ln(плотность) от δ
+// подбирается взвешенным МНК (вес — число сделок в корзине): наклон дает k,
+// пересечение — ln(A·k).
+//
+// Затухание ленивое: вместо умножения всех корзин на e^(−dt/τ) вес новой сделки
+// растет как e^((t − t_ref)/τ). Общий множитель не меняет наклон, а суммы МНК
+// обновляются только по затронутой корзине — O(1) на сделку, память фиксирована.
+// Когда множитель становится слишком большим, корзины нормируются (O(bucket_count),
+// раз в десятки полупериодов).
+//
+// observe вызывает один поток (сетевой или симуляции). Оценка публикуется через
+// SeqLock: estimate() из любого потока без блокировок возвращает согласованную пару A, k.
+class IntensityCalibrator {
+public:
+    static constexpr size_t MAX_BUCKETS = 64;
+
+    struct Config {
+        double bucket_width = 0.1;                // Ширина корзины по δ, в единицах цены
+        size_t bucket_count = 32;                 // Корзины дальше bucket_width * bucket_count не учитываются
+        uint64_t halflife_ns = 60000000000ull;    // Полураспад веса сделки
+        size_t min_buckets = 3;                   // Непустых корзин для подбора
+    };
+
+    struct Estimate {
+        double A;          // Сделок в секунду на любом расстоянии
+        double k;          // Затухание по δ, 1 / единица цены
+        uint64_t time_ns;  // Время последней учтенной сделки
+        uint64_t trades;   // Всего учтено сделок
+        uint32_t buckets;  // Непустых корзин в подборе
+        uint32_t valid;    // 0 — подбора еще не было (k <= 0 или мало корзин)
+    };
+
+    IntensityCalibrator() : IntensityCalibrator(Config{}) {}
+    explicit IntensityCalibrator(Config config);
+
+    // Сделка по цене price при середине mid в момент time_ns.
+    // Время не должно убывать; сделка из прошлого учитывается с текущим весом.
+    void observe(double price, double mid, uint64_t time_ns);
+
+    // Подбор по текущим корзинам без публикации
+    Estimate fit() const;
+
+    // Последняя опубликованная оценка; из любого потока
+    Estimate estimate() const { return published_.load(); }
+
+    void reset();
+
+    const Config& config() const { return config_; }
+
+private:
+    // Ленивый множитель не больше e^RESCALE_LOG
+    static constexpr double RESCALE_LOG = 200.0;
+
+    Config config_;
+    double tau_ns_;       // halflife / ln 2
+    double inv_width_;
+
+    // Затухающие счетчики в масштабе e^(log_scale_), и их логарифмы
+    double counts_[MAX_BUCKETS];
+    double log_counts_[MAX_BUCKETS];
+
+    // Суммы взвешенного МНК по непустым корзинам: вес w = counts_[b], x — центр корзины, y = ln w
+    double sum_w_ = 0.0;
+    double sum_wx_ = 0.0;
+    double sum_wxx_ = 0.0;
+    double sum_wy_ = 0.0;
+    double sum_wxy_ = 0.0;
+    uint32_t nonempty_ = 0;
+
+    uint64_t ref_time_ = 0;    // Время, в котором вес сделки равен 1 (после нормировки)
+    uint64_t first_time_ = 0;
+    uint64_t last_time_ = 0;
+    double log_scale_ = 0.0;   // (last_time_ − ref_time_) / τ
+    uint64_t trades_ = 0;
+
+    SeqLock<Estimate> published_;
+
+    void add_to_sums(size_t bucket, double sign);
+    void rescale();
+};
+
+#endif
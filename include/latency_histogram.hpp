@@ -0,0 +1,111 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Гистограмма задержек в стиле HDR: логарифмические диапазоны, каждый
+// разбит на 128 линейных корзин, относительная погрешность не больше 1/128.
+// Память фиксирована (~35 КБ), диапазон до 2^40 нс (~18 минут).
+//
+// Запись — один поток: без блокировок, аллокаций и атомарных RMW,
+// только relaxed load/store счетчика. Снимок можно брать из любого потока.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 8;
+    static constexpr int MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr size_t BUCKET_COUNT =
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+
+    // Копия счетчиков для расчета перцентилей вне горячего пути
+    struct Snapshot {
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+
+        // Значение перцентиля (0..100); верхняя граница корзины
+        uint64_t percentile(double p) const;
+        uint64_t max() const;
+
+        // Записи, сделанные после снимка older (интервальная статистика)
+        Snapshot since(const Snapshot& older) const;
+    };
+
+    LatencyHistogram() : counts_(new std::atomic<uint64_t>[BUCKET_COUNT]) {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) counts_[i].store(0, std::memory_order_relaxed);
+    }
+    ~LatencyHistogram() { delete[] counts_; }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value) {
+        std::atomic<uint64_t>& count = counts_[index_of(value < MAX_VALUE ? value : MAX_VALUE)];
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot result;
+        result.counts.resize(BUCKET_COUNT);
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            result.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            result.total += result.counts[i];
+        }
+        return result;
+    }
+
+    static size_t index_of(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<size_t>(value);
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BUCKET_BITS + 1;
+        return static_cast<size_t>(shift) * SUB_BUCKET_HALF + static_cast<size_t>(value >> shift);
+    }
+
+    // Наибольшее значение, попадающее в корзину
+    static uint64_t highest_value_of(size_t index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        size_t shift = index / SUB_BUCKET_HALF - 1;
+        uint64_t mantissa = index - shift * SUB_BUCKET_HALF;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    std::atomic<uint64_t>* counts_;  // Массив выделяется один раз в конструкторе
+};
+
+inline uint64_t LatencyHistogram::Snapshot::percentile(double p) const {
+    if (total == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.5);
+    if (target < 1) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= target) return highest_value_of(i);
+    }
+    return max();
+}
+
+inline uint64_t LatencyHistogram::Snapshot::max() const {
+    for (size_t i = counts.size(); i-- > 0;) {
+        if (counts[i]) return highest_value_of(i);
+    }
+    return 0;
+}
+
+inline LatencyHistogram::Snapshot LatencyHistogram::Snapshot::since(const Snapshot& older) const {
+    Snapshot result;
+    result.counts = counts;
+    result.total = total;
+    if (older.counts.size() != counts.size()) return result;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        result.counts[i] -= older.counts[i];
+        result.total -= older.counts[i];
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef LATENCY_MONITOR_HPP
+#define LATENCY_MONITOR_HPP
+
+#include "latency_histogram.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+// Этапы пути tick-to-quote: задержка между соседними точками
+enum class LatencyStage : uint32_t {
+    ExchangeToReceive,   // MarketData::event_time -> чтение из сокета (включает расхождение часов)
+    ReceiveToParse,      // Чтение из сокета -> разбор и обновление стакана
+    ParseToStrategy,     // Разбор -> вход в стратегию (колбэк или очередь MarketDataPipeline)
+    StrategyToSpreads,   // Вход в стратегию -> результат calculate_spreads
+    SpreadsToQuote,      // Результат calculate_spreads -> отправка котировки
+    ReceiveToQuote,      // Полный локальный путь: сокет -> котировка
+    Count
+};
+
+const char* latency_stage_name(LatencyStage stage);
+
+// Временные метки одного тика по системным часам, нс от UNIX epoch.
+// 0 — точка неизвестна, этапы с ней не записываются.
+struct TickTimestamps {
+    uint64_t event_ns = 0;
+    uint64_t recv_ns = 0;
+    uint64_t parse_ns = 0;
+    uint64_t strategy_ns = 0;
+    uint64_t spreads_ns = 0;
+    uint64_t quote_ns = 0;
+};
+
+// Гистограммы по этапам. Запись — из одного потока (потока стратегии),
+// отчет — из любого, в том числе из фонового потока периодической выгрузки.
+class LatencyMonitor {
+public:
+    LatencyMonitor() = default;
+    ~LatencyMonitor();
+
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    void record(LatencyStage stage, uint64_t start_ns, uint64_t end_ns) {
+        if (!start_ns || !end_ns) return;
+        // Биржевые часы могут опережать локальные: отрицательная задержка считается нулевой
+        histograms_[static_cast<size_t>(stage)].record(end_ns > start_ns ? end_ns - start_ns : 0);
+    }
+
+    void record(const TickTimestamps& ts) {
+        record(LatencyStage::ExchangeToReceive, ts.event_ns, ts.recv_ns);
+        record(LatencyStage::ReceiveToParse, ts.recv_ns, ts.parse_ns);
+        record(LatencyStage::ParseToStrategy, ts.parse_ns, ts.strategy_ns);
+        record(LatencyStage::StrategyToSpreads, ts.strategy_ns, ts.spreads_ns);
+        record(LatencyStage::SpreadsToQuote, ts.spreads_ns, ts.quote_ns);
+        record(LatencyStage::ReceiveToQuote, ts.recv_ns, ts.quote_ns);
+    }
+
+    const LatencyHistogram& histogram(LatencyStage stage) const {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+    // Таблица p50/p99/p99.9/max по этапам. interval = true — только записи
+    // с прошлого интервального отчета, иначе за все время. Интервальные
+    // отчеты — из одного потока (при запущенной выгрузке только из нее).
+    void report(std::ostream& out, bool interval = false);
+
+    // Фоновая выгрузка отчета каждые period (интервальная статистика)
+    void start_reporting(std::chrono::milliseconds period, std::ostream& out);
+    void stop_reporting();
+
+private:
+    static constexpr size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::Count);
+
+    std::array<LatencyHistogram, STAGE_COUNT> histograms_;
+    std::array<LatencyHistogram::Snapshot, STAGE_COUNT> last_report_;
+
+    std::thread reporter_;
+    std::mutex reporter_mutex_;
+    std::condition_variable reporter_cv_;
+    bool reporting_ = false;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef MARKET_DATA_EVENT_HPP
+#define MARKET_DATA_EVENT_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+// Событие рынка фиксированного размера, которое сетевой поток
+// передает потоку стратегии (одна кэш-линия, без указателей).
+struct MarketDataEvent {
+    uint16_t symbol_id;        // Комбинированный поток Binance — не больше 1024 подписок
+    uint16_t flags;
+    uint32_t parse_delay_ns;   // Разбор кадра: parse - recv, нс (насыщение на UINT32_MAX)
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+    uint64_t event_time;       // Биржевое время события, мс
+    uint64_t recv_time_ns;     // Локальное время получения кадра, нс
+    double k;                  // Интенсивность по полосе глубины 0; 0 — полос нет, k по top-of-book
+
+    // Момент разбора кадра; 0 — время получения неизвестно
+    uint64_t parse_time_ns() const { return recv_time_ns ? recv_time_ns + parse_delay_ns : 0; }
+};
+
+static_assert(std::is_trivially_copyable<MarketDataEvent>::value, "MarketDataEvent must be copyable by memcpy");
+static_assert(sizeof(MarketDataEvent) == 64, "MarketDataEvent should fit one cache line");
+
+#endif
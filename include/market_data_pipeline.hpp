@@ -0,0 +1,110 @@
+#ifndef MARKET_DATA_PIPELINE_HPP
+#define MARKET_DATA_PIPELINE_HPP
+
+#include "market_data_event.hpp"
+#include "seqlock.hpp"
+#include "spsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Передача рыночных событий из сетевого потока (io_context) в отдельный
+// поток стратегии через ограниченную SPSC-очередь. Сетевой поток никогда
+// не выполняет код стратегии и не ждет его (кроме политики Block).
+class MarketDataPipeline {
+public:
+    enum class Backpressure {
+        DropNewest,  // Очередь полна — новое событие отбрасывается
+        Block,       // Очередь полна — сетевой поток ждет освобождения места
+        Conflate     // Храним только последний top-of-book по каждому символу
+    };
+
+    // Что делает поток стратегии, когда очередь пуста
+    enum class IdleStrategy {
+        BusySpin,  // Крутится без уступания CPU (выделенное ядро)
+        Yield,     // Короткий spin, затем yield
+        Park       // Короткий spin, затем сон до публикации нового события
+    };
+
+    struct Config {
+        size_t capacity = 4096;
+        Backpressure policy = Backpressure::Conflate;
+        uint32_t max_symbols = 64;  // Для Conflate: symbol_id < max_symbols
+        IdleStrategy idle = IdleStrategy::Yield;
+        int consumer_core = -1;     // Ядро для потока стратегии, -1 — без привязки
+    };
+
+    struct Stats {
+        uint64_t published;        // Принято от сетевого потока
+        uint64_t consumed;         // Передано стратегии
+        uint64_t dropped;          // Отброшено из-за переполнения
+        uint64_t conflated;        // Перезаписано более свежим событием того же символа
+        uint64_t queue_depth;      // Текущая глубина очереди
+        uint64_t max_queue_depth;  // Максимальная наблюдавшаяся глубина
+    };
+
+    using EventHandler = std::function<void(const MarketDataEvent&)>;
+
+    MarketDataPipeline(const Config& config, EventHandler handler);
+    ~MarketDataPipeline();
+
+    MarketDataPipeline(const MarketDataPipeline&) = delete;
+    MarketDataPipeline& operator=(const MarketDataPipeline&) = delete;
+
+    // Запуск собственного потока стратегии
+    void start();
+    void stop();
+
+    // Обработка накопленных событий в текущем потоке (если поток стратегии
+    // создается снаружи, например с привязкой к ядру). Возвращает число событий.
+    size_t poll();
+
+    // Вызывается только из сетевого потока
+    bool publish(const MarketDataEvent& event);
+
+    Stats stats() const;
+
+    // Процессорное время собственного потока стратегии
+    double consumer_cpu_seconds();
+
+private:
+    // Слот последнего top-of-book символа для политики Conflate
+    struct alignas(64) ConflationSlot {
+        SeqLock<MarketDataEvent> latest;
+        std::atomic<bool> pending{false};
+    };
+
+    Config config_;
+    EventHandler handler_;
+    SpscQueue<MarketDataEvent> events_;
+    SpscQueue<uint32_t> pending_symbols_;
+    std::unique_ptr<ConflationSlot[]> slots_;
+
+    std::atomic<bool> running_{false};
+    std::thread consumer_;
+
+    // Счетчики сетевого потока
+    alignas(64) std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> max_queue_depth_{0};
+
+    // Счетчики потока стратегии
+    alignas(64) std::atomic<uint64_t> consumed_{0};
+
+    // Сон потока стратегии (IdleStrategy::Park)
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    alignas(64) std::atomic<bool> parked_{false};
+
+    void consume_loop();
+    void note_queue_depth(size_t depth);
+    void park();
+    void wake_consumer();
+};
+
+#endif
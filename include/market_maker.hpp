@@ -1,7 +1,15 @@
 #ifndef MARKET_MAKER_HPP
 #define MARKET_MAKER_HPP
 
+#include "event_log.hpp"
+#include "fill_simulator.hpp"
+#include "intensity_calibrator.hpp"
 #include "inventory_manager.hpp"
+#include "order_book.hpp"
+#include "quote_engine.hpp"
+#include "step_report.hpp"
+#include <cstddef>
+#include <tuple>
 #include <utility>
 #include <vector>
 #include <string>
@@ -13,27 +21,56 @@ public:
     // Вычисление спредов по модели Avellaneda-Stoikov
     std::pair<double, double> calculate_spreads(double S_t, double sigma, double k, double q_t);
 
+    // То же для массивов (SoA, SIMD): ask[i], bid[i] по S_t[i], sigma[i], k[i], q[i]
+    void calculate_spreads_batch(const double* S_t, const double* sigma, const double* k, const double* q,
+                                 double* ask, double* bid, size_t n) const;
+
+    // Лестница из n уровней на сторону в буфер вызывающего (QuoteEngine::ladder)
+    template <size_t Capacity>
+    size_t calculate_ladder(double S_t, double sigma, double k, double q_t, const LadderLevel* levels, size_t n,
+                            QuoteLadder<Capacity>& out) const {
+        return engine_.ladder(S_t, sigma, k, q_t, levels, n, out);
+    }
+
     // Адаптация под onchain (с учетом latency и gas costs)
     std::pair<double, double> adjust_spreads_for_onchain(double S_t, double delta_a, double delta_b,
                                                         double latency, double sigma, double gas_cost,
                                                         double trade_size);
 
-    // Симуляция шага маркет-мейкинга
+    // Симуляция шага маркет-мейкинга: котировка (QuoteEngine), исполнение (FillSimulator),
+    // вывод — записи в журнал событий, если он подключен, иначе print_step_report в std::cout
     void step(double S_t, double sigma, double latency, double gas_cost, double trade_size);
 
-    // Получение данных с Binance (заглушка до реализации API)
+    // Seed генератора симуляции исполнения (иначе — поток по умолчанию от глобального seed)
+    void seed(uint64_t seed, uint64_t stream = 0) { fills_.seed(seed, stream); }
+
+    // Асинхронный журнал событий шага (nullptr — текстовый вывод в std::cout)
+    void set_event_log(EventLog* log) { log_ = log; }
+
+    // Калибровка k по рыночным сделкам шага: пока оценка есть, k берется из нее, а не
+    // из стакана. Шаг симуляции считается одной секундой (nullptr — без калибровки).
+    void set_intensity_calibrator(IntensityCalibrator* calibrator) { calibrator_ = calibrator; }
+
+    // Чистый расчет котировок для горячего пути
+    const QuoteEngine& quote_engine() const { return engine_; }
+
+    // Подключение L2-стакана, из которого стратегия берет рыночные данные
+    void attach_order_book(const OrderBook* book) { book_ = book; }
+
+    // Получение данных с Binance: из стакана, если он подключен и синхронизирован, иначе заглушка
     std::tuple<double, double, double, double, double> get_binance_data(const std::string& pair);
 
     // Получение onchain-метрик (заглушка до реализации web3)
     std::pair<double, double> get_onchain_metrics();
 
-    // Вычисление волатильности из исторических данных
+    // Вычисление волатильности по последним window ценам (для потока тиков — RollingVolatility)
     double calculate_volatility(const std::vector<double>& prices, int window = 5);
 
     // Расчет стоимости газа для сделки
     double calculate_gas_cost(double gas_price, double trade_size);
 
-    // Корректировка цены с учетом задержки
+    // Корректировка цены с учетом задержки: один нормальный шок за latency секунд
+    // (исполнение по блокам с включением по газу — block_simulator.hpp)
     double adjust_price_with_latency(double S_t, double sigma, double latency);
 
     // Корректировка спредов под PMM-пулы
@@ -42,10 +79,21 @@ public:
     // Оценка интенсивности ордеров (k)
     double estimate_order_intensity(double bid, double ask, double bid_volume, double ask_volume);
 
+    // По стакану: по полосе глубины band, если у стакана есть полосы, иначе по top-of-book. O(1).
+    double estimate_order_intensity(const OrderBook& book, size_t band = 0);
+
 private:
     double gamma_;  // Коэффициент риска
     double T_;      // Горизонт времени
+    QuoteEngine engine_;
+    FillSimulator fills_;
     InventoryManager inventory_;
+    const OrderBook* book_ = nullptr;
+    EventLog* log_ = nullptr;
+    IntensityCalibrator* calibrator_ = nullptr;
+    uint64_t sim_time_ns_ = 0;  // Время симуляции для калибратора
+
+    void log_step(const StepReport& report, double sigma, double quoted_inventory);
 };
 
 #endif
\ No newline at end of file
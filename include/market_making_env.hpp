@@ -1,10 +1,12 @@
 #ifndef MARKET_MAKING_ENV_HPP
 #define MARKET_MAKING_ENV_HPP
 
+#include "history_store.hpp"
 #include "market_maker.hpp"
+#include "rng.hpp"
+#include "rolling_volatility.hpp"
 #include <vector>
 #include <array>
-#include <random>
 
 class MarketMakingEnv {
 public:
@@ -18,6 +20,14 @@ public:
     
     // Get current state
     std::vector<double> get_state() const;
+
+    // Reproducible episodes: seeds the env generator (stream 0) and the
+    // market maker's fill simulation (stream 1)
+    void seed(uint64_t seed);
+
+    // Эпизоды из истории: reset берет случайное окно свечей (генератор env), mid
+    // шага — close очередной свечи. nullptr — заглушка MarketMaker::get_binance_data.
+    void set_episodes(const KlineEpisodes* episodes) { episodes_ = episodes; }
     
 private:
     MarketMaker& mm_;
@@ -25,7 +35,10 @@ private:
     double current_profit_;
     int current_step_;
     int max_steps_;
-    std::default_random_engine rng_;
+    Rng rng_;
+    RollingVolatility volatility_;  // По mid_price наблюдаемых шагов
+    const KlineEpisodes* episodes_ = nullptr;
+    const Kline* episode_ = nullptr;  // max_steps_ + 1 свечей текущего эпизода
     
     // State components
     double mid_price_;
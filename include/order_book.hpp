@@ -0,0 +1,95 @@
+#ifndef ORDER_BOOK_HPP
+#define ORDER_BOOK_HPP
+
+#include "depth_parser.hpp"
+#include <cstdint>
+#include <vector>
+
+// L2-стакан одного символа, поддерживаемый из diff-потока @depth.
+// Уровни лежат в непрерывных отсортированных массивах, лучший уровень
+// хранится в конце массива: изменения у вершины стакана (самые частые)
+// сдвигают лишь несколько элементов, а лучшая цена читается за O(1).
+// Память резервируется в конструкторе, обновления не аллоцируют.
+class OrderBook {
+public:
+    enum class UpdateResult {
+        Applied,    // Обновление применено
+        Stale,      // Обновление старее снапшота, пропущено
+        Gap,        // Пропуск в последовательности update id, нужен новый снапшот
+        NotSynced   // Снапшот еще не загружен
+    };
+
+    explicit OrderBook(size_t max_levels = MAX_DEPTH_LEVELS);
+
+    // Загрузка снапшота (REST /api/v3/depth), после нее принимаются diff-обновления
+    void apply_snapshot(const DepthUpdate& snapshot);
+
+    // Применение diff-обновления с проверкой first/last update id
+    UpdateResult apply_update(const DepthUpdate& update);
+
+    // Сброс в состояние ожидания снапшота
+    void reset();
+
+    bool is_synced() const { return synced_; }
+    uint64_t last_update_id() const { return last_update_id_; }
+
+    // Доступ к уровням: индекс 0 — лучший уровень стороны
+    size_t bid_levels() const { return bids_.size(); }
+    size_t ask_levels() const { return asks_.size(); }
+    const PriceLevel& bid(size_t i) const { return bids_[bids_.size() - 1 - i]; }
+    const PriceLevel& ask(size_t i) const { return asks_[asks_.size() - 1 - i]; }
+
+    bool has_top() const { return !bids_.empty() && !asks_.empty(); }
+    double best_bid() const { return bids_.empty() ? 0.0 : fixed_to_double(bids_.back().price); }
+    double best_ask() const { return asks_.empty() ? 0.0 : fixed_to_double(asks_.back().price); }
+    double best_bid_qty() const { return bids_.empty() ? 0.0 : fixed_to_double(bids_.back().qty); }
+    double best_ask_qty() const { return asks_.empty() ? 0.0 : fixed_to_double(asks_.back().qty); }
+    double mid_price() const { return (best_bid() + best_ask()) / 2; }
+
+    // Объем уровня с ценой price (фиксированная точка); 0 — уровня нет. O(log n).
+    int64_t bid_qty_at(int64_t price) const;
+    int64_t ask_qty_at(int64_t price) const;
+
+    // Суммарный объем уровней в пределах ±pct от mid-price (pct = 0.01 — 1%)
+    double bid_depth_within(double pct) const;
+    double ask_depth_within(double pct) const;
+
+    // Полосы глубины: тот же объем, что bid/ask_depth_within(pct), но поддерживается
+    // при каждом изменении уровня и сдвиге mid-price, чтение — O(1).
+    // Номер полосы — порядок добавления; false — уже MAX_DEPTH_BANDS полос.
+    static constexpr size_t MAX_DEPTH_BANDS = 4;
+    bool add_depth_band(double pct);
+    void clear_depth_bands() { band_count_ = 0; }
+    size_t depth_band_count() const { return band_count_; }
+    double depth_band_pct(size_t band) const { return bands_[band].pct; }
+    double bid_band_depth(size_t band) const { return fixed_to_double(bands_[band].bid_depth); }
+    double ask_band_depth(size_t band) const { return fixed_to_double(bands_[band].ask_depth); }
+
+private:
+    // Инвариант при bands_valid_: bid_depth — сумма bid с ценой >= bid_limit,
+    // ask_depth — сумма ask с ценой <= ask_limit (границы от текущего mid-price)
+    struct DepthBand {
+        double pct;
+        int64_t bid_limit;
+        int64_t ask_limit;
+        int64_t bid_depth;
+        int64_t ask_depth;
+    };
+
+    std::vector<PriceLevel> bids_;  // По возрастанию цены, лучший bid в конце
+    std::vector<PriceLevel> asks_;  // По убыванию цены, лучший ask в конце
+    size_t max_levels_;
+    uint64_t last_update_id_;
+    bool synced_;
+    bool awaiting_first_update_;  // Первое обновление после снапшота должно перекрыть lastUpdateId
+    DepthBand bands_[MAX_DEPTH_BANDS];
+    size_t band_count_ = 0;
+    bool bands_valid_ = false;  // Границы посчитаны от существующего mid-price
+
+    void set_level(std::vector<PriceLevel>& side, const PriceLevel& level, bool is_bid);
+    void add_band_delta(bool is_bid, int64_t price, int64_t delta);
+    void recompute_bands();
+    void update_bands();
+};
+
+#endif
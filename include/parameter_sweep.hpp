@@ -0,0 +1,78 @@
+#ifndef PARAMETER_SWEEP_HPP
+#define PARAMETER_SWEEP_HPP
+
+#include "fill_simulator.hpp"
+#include "path_generator.hpp"
+#include "work_stealing_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Перебор параметров стратегии (gamma, T, минимальный спред, объем сделки) на общих
+// ценовых путях. Пути строятся один раз и только читаются всеми прогонами; прогон —
+// пара (набор параметров, путь) со своим потоком Rng, поэтому результат не зависит
+// от числа потоков и порядка выполнения.
+
+struct SweepParams {
+    double gamma;
+    double T;
+    double min_spread;  // Доля цены
+    double trade_size;
+};
+
+struct SweepResult {
+    double pnl;                 // cash + inventory * последняя цена
+    double inventory_variance;  // Дисперсия инвентаря по шагам
+    double max_drawdown;        // От пика equity
+    double final_inventory;
+    uint64_t fills;
+};
+
+// Общие пути цены и волатильности для котирования (SoA: путь за путем)
+class PricePaths {
+public:
+    struct Config {
+        size_t paths = 16;
+        PathConfig model;  // Шаг — секунда; по умолчанию GBM, 3600 шагов, 0.05% за шаг
+    };
+
+    // Путь p — PathGenerator::generate_path(p). С pool пути строятся параллельно.
+    explicit PricePaths(Config config, WorkStealingPool* pool = nullptr);
+
+    const Config& config() const { return config_; }
+    size_t paths() const { return config_.paths; }
+    size_t steps() const { return config_.model.steps; }
+
+    const double* prices(size_t path) const { return prices_.data() + path * steps(); }
+    // Минутная волатильность доходностей по окну 60 шагов, не меньше 0.01 (как в run_simulation)
+    const double* sigma(size_t path) const { return sigma_.data() + path * steps(); }
+
+private:
+    Config config_;
+    PathGenerator generator_;
+    std::vector<double> prices_;
+    std::vector<double> sigma_;
+
+    void build(size_t path);
+};
+
+// Один прогон: котировка QuoteEngine на каждом шаге, сделка рынка — цена пути
+// плюс N(0, S_t * step_vol) через FillSimulator, PnL по цене пути.
+SweepResult simulate_sweep_run(const SweepParams& params, const PricePaths& paths, size_t path,
+                               FillSimulator& fills);
+
+// Все прогоны: результат run = combo * paths + path. Поток Rng прогона — RUN_STREAM_BASE + run,
+// а с common_random_numbers путей — RUN_STREAM_BASE + path: все наборы параметров видят
+// одни и те же сделки рынка, и разница между наборами оценивается с меньшей дисперсией.
+constexpr uint64_t SWEEP_RUN_STREAM_BASE = 1ull << 32;
+
+std::vector<SweepResult> run_parameter_sweep(const std::vector<SweepParams>& params, const PricePaths& paths,
+                                             WorkStealingPool& pool, uint64_t seed);
+
+// Результаты в колоночный файл (ColumnWriter): строка — прогон; колонки combo, path,
+// параметры набора и результаты SweepResult.
+bool write_sweep_results(const std::string& path, const std::vector<SweepParams>& params, size_t paths,
+                         const std::vector<SweepResult>& results);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PATH_GENERATOR_HPP
+#define PATH_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Генерация ценовых путей Монте-Карло пачками. Путь — steps цен подряд, пачка —
+// пути подряд (SoA: путь за путем), price[0] = s0. Для каждого пути шоки берутся
+// массивом из Rng, лог-приращения считаются векторизуемыми циклами, затем
+// префиксная сумма и batch_exp по всей пачке сразу.
+//
+// Модели (шаг — единица времени, все параметры на шаг):
+//   Gbm             — dlnS = drift - vol²/2 + vol·Z
+//   MertonJump      — плюс скачок с вероятностью jump_rate, размер ln J ~ N(jump_mean, jump_vol²),
+//                     компенсатор -jump_rate·(E[J] - 1) сохраняет E[S_t] = s0·e^{drift·t}
+//   RegimeSwitching — vol = step_vol или high_vol по марковской цепи из двух состояний
+//                     (старт в спокойном режиме)
+//
+// Шоки пути p зависят только от (seed, p) и параметров: у диффузии, скачков и режимов
+// свои потоки Rng. Пути воспроизводимы при любом разбиении на пачки и потоки выполнения.
+//   antithetic            — путь 2i+1 использует шоки пути 2i с обратным знаком
+//                           (режимы и моменты скачков общие); число путей лучше брать четным
+//   common_random_numbers — одни и те же шоки при любых параметрах модели: сравнение
+//                           стратегий или параметров на общих путях сходится быстрее.
+//                           Без него потоки зависят от параметров, и пути разных
+//                           конфигураций независимы.
+enum class PathModel {
+    Gbm,
+    MertonJump,
+    RegimeSwitching
+};
+
+struct PathConfig {
+    PathModel model = PathModel::Gbm;
+    size_t steps = 3600;
+    double s0 = 2000.0;
+    double drift = 0.0;          // Средняя лог-доходность сверх поправки -vol²/2
+    double step_vol = 0.0005;    // Стандартное отклонение доходности за шаг (спокойный режим)
+
+    double jump_rate = 0.001;    // Вероятность скачка за шаг
+    double jump_mean = 0.0;
+    double jump_vol = 0.01;
+
+    double high_vol = 0.002;     // Волатильность в напряженном режиме
+    double p_enter_high = 0.001; // Вероятность перехода за шаг
+    double p_exit_high = 0.01;
+
+    bool antithetic = false;
+    bool common_random_numbers = false;
+    uint64_t seed = 42;
+};
+
+class PathGenerator {
+public:
+    explicit PathGenerator(PathConfig config);
+
+    const PathConfig& config() const { return config_; }
+    size_t steps() const { return config_.steps; }
+
+    // Пути first .. first + count - 1 в out (count * steps значений)
+    void generate(size_t first, size_t count, double* out) const;
+
+    // Один путь; scratch — не меньше steps значений (для режимов)
+    void generate_path(size_t path, double* out, double* scratch) const;
+
+private:
+    PathConfig config_;
+    uint64_t stream_offset_;  // 0 с common_random_numbers, иначе — хеш параметров
+    double jump_compensator_;
+
+    // Логарифмы цен пути (до экспоненты); out[0] = ln s0
+    void log_increments(size_t path, double* out, double* scratch) const;
+};
+
+#endif
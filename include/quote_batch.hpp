@@ -0,0 +1,48 @@
+#ifndef QUOTE_BATCH_HPP
+#define QUOTE_BATCH_HPP
+
+#include <cstddef>
+
+// Пакетный расчет котировок Avellaneda-Stoikov в формате structure-of-arrays:
+// тысячи (ask, bid) за вызов для перебора параметров, многих символов и RL-роллаутов.
+// Ядра AVX-512 (8 котировок за итерацию), AVX2 (4) и скалярное выбираются
+// по возможностям процессора при первом вызове; сборка не требует -mavx.
+//
+// Логарифм считается своим полиномом (fdlibm) без ветвлений, минимальный
+// спред — через сравнение и blend, так что все ядра дают одинаковую
+// последовательность операций. Расхождение с MarketMaker::calculate_spreads
+// (std::log и if) не больше QUOTE_BATCH_TOLERANCE * max(1, |S_t|) по каждой цене.
+
+constexpr double QUOTE_BATCH_TOLERANCE = 1e-12;
+
+enum class SimdLevel {
+    Scalar,
+    Avx2,
+    Avx512
+};
+
+// Лучший доступный уровень для этого процессора
+SimdLevel detect_simd_level();
+const char* simd_level_name(SimdLevel level);
+
+// ask[i], bid[i] для S_t[i], sigma[i], k[i], q[i]; k[i] > 0.
+// min_spread — минимальная ширина котировки, доля цены (как у QuoteEngine).
+// Выходные массивы могут совпадать с входными.
+void calculate_spreads_batch(double gamma, double T, double min_spread,
+                             const double* S_t, const double* sigma, const double* k, const double* q,
+                             double* ask, double* bid, size_t n);
+
+// То же с явным выбором ядра (уровень выше доступного понижается)
+void calculate_spreads_batch(double gamma, double T, double min_spread,
+                             const double* S_t, const double* sigma, const double* k, const double* q,
+                             double* ask, double* bid, size_t n, SimdLevel level);
+
+// Натуральный логарифм массива; x[i] — положительные конечные нормальные числа.
+// Погрешность около 1 ulp.
+void batch_log(const double* x, double* out, size_t n, SimdLevel level = detect_simd_level());
+
+// Экспонента массива (fdlibm, около 1 ulp); x ограничивается [-708, 709].
+// Ядра расходятся не больше чем на 1 ulp (FMA в AVX-512). Выходной массив может совпадать с входным.
+void batch_exp(const double* x, double* out, size_t n, SimdLevel level = detect_simd_level());
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef QUOTE_ENGINE_HPP
+#define QUOTE_ENGINE_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+// Рыночное состояние для котирования. Заполняется вызывающим кодом
+// (фид, симулятор, среда RL) в заранее выделенной структуре.
+struct MarketState {
+    double price;          // Цена, вокруг которой котируем (S_t)
+    double bid;            // Лучшие цены и объемы стакана для оценки k
+    double ask;
+    double bid_qty;
+    double ask_qty;
+    double sigma;
+    double gas_price;      // wei
+    double trade_size;
+    double latency_shift;  // Сдвиг цены за время задержки onchain; случайный сдвиг сэмплирует вызывающий
+    double pool_depth;     // Глубина PMM-пула (QuotePipeline с PmmDepth)
+    double k;              // > 0 — готовая оценка k (по полосам глубины), иначе k по top-of-book
+};
+
+struct Quote {
+    double ask;            // Итоговые цены с учетом задержки
+    double bid;
+    double base_ask;       // Avellaneda-Stoikov до корректировок
+    double base_bid;
+    double k;              // Оценка интенсивности ордеров
+    double gas_cost;       // ETH на сделку trade_size
+};
+
+// Уровень лестницы котировок (PMM/RFQ): объем и собственные отступ и перекос
+struct LadderLevel {
+    double size;    // Объем уровня (переносится в выход как есть)
+    double offset;  // Дополнительное расстояние от S_t на каждую сторону, доля цены
+    double skew;    // Множитель инвентарного члена q·σ²·T для уровня (1 — как у calculate_spreads)
+};
+
+// Буфер лестницы фиксированной емкости: выделяется вызывающим один раз,
+// QuoteEngine::ladder только заполняет его (SoA, без аллокаций)
+template <size_t Capacity>
+struct QuoteLadder {
+    static constexpr size_t capacity = Capacity;
+
+    size_t levels = 0;  // Заполнено уровней
+    double ask[Capacity];
+    double bid[Capacity];
+    double size[Capacity];
+};
+
+// Чистый расчет котировки: без логирования, генераторов случайных чисел
+// и аллокаций, время выполнения ограничено (нет циклов и ветвлений по данным,
+// кроме выбора min/max). Исполнение (симуляция сделок) и отчеты — отдельные слои:
+// FillSimulator и StepReport.
+class QuoteEngine {
+public:
+    // min_spread — минимальная ширина котировки, доля цены
+    QuoteEngine(double gamma = 0.1, double T = 300.0, double min_spread = 0.001)
+        : gamma_(gamma), T_(T), min_spread_(min_spread) {}
+
+    Quote quote(const MarketState& state, double inventory) const noexcept;
+
+    // Avellaneda-Stoikov с минимальным спредом min_spread от цены (по умолчанию 0.1%)
+    void spreads(double S_t, double sigma, double k, double q_t, double& ask, double& bid) const noexcept;
+
+    // Лестница из n уровней на сторону за один проход. Общие члены (γ⁻¹·log(1 + γ/k),
+    // q·σ²·T, минимальный спред) считаются один раз; уровень i:
+    //   ask = S_t + spread_term + offset·S_t + skew·q·σ²·T, bid — симметрично,
+    // с тем же минимальным спредом, что и spreads(). Уровень с offset = 0, skew = 1
+    // совпадает со spreads(). Пишет min(n, capacity) уровней, возвращает их число.
+    size_t ladder(double S_t, double sigma, double k, double q_t, const LadderLevel* levels, size_t n,
+                  double* ask, double* bid, double* size, size_t capacity) const noexcept;
+
+    template <size_t Capacity>
+    size_t ladder(double S_t, double sigma, double k, double q_t, const LadderLevel* levels, size_t n,
+                  QuoteLadder<Capacity>& out) const noexcept {
+        out.levels = ladder(S_t, sigma, k, q_t, levels, n, out.ask, out.bid, out.size, Capacity);
+        return out.levels;
+    }
+
+    // k = средний объем на уровне / ширина спреда, в пределах [0.1, 100]
+    static double order_intensity(double bid, double ask, double bid_qty, double ask_qty) noexcept {
+        double spread_width = std::max(ask - bid, 0.0001);  // Защита от деления на 0
+        double total_volume = (bid_qty + ask_qty) / 2;
+        return std::clamp(total_volume / spread_width, 0.1, 100.0);
+    }
+
+    // k по полосе глубины: средний объем стороны в пределах ±pct от mid / ширина полосы,
+    // в тех же пределах [0.1, 100]
+    static double depth_intensity(double bid_depth, double ask_depth, double mid, double pct) noexcept {
+        double band_width = std::max(mid * pct, 0.0001);
+        double total_volume = (bid_depth + ask_depth) / 2;
+        return std::clamp(total_volume / band_width, 0.1, 100.0);
+    }
+
+    // Gas cost = gas_price * gas_limit * trade_size, в ETH
+    static double gas_cost(double gas_price, double trade_size) noexcept {
+        const double GAS_LIMIT_PER_ORDER = 100000;  // Примерное значение gas limit для ордера
+        return (gas_price * GAS_LIMIT_PER_ORDER * trade_size) / 1e18;  // Конвертируем wei в ETH
+    }
+
+    double gamma() const { return gamma_; }
+    double horizon() const { return T_; }
+    double min_spread() const { return min_spread_; }
+
+private:
+    double gamma_;  // Коэффициент риска
+    double T_;      // Горизонт времени
+    double min_spread_;
+};
+
+#endif
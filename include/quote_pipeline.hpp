@@ -0,0 +1,118 @@
+#ifndef QUOTE_PIPELINE_HPP
+#define QUOTE_PIPELINE_HPP
+
+#include "quote_engine.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Сборка расчета котировки из политик на этапе компиляции.
+// Каждая политика — тип со статической функцией
+//   static void apply(const QuoteParams&, const MarketState&, double inventory, Quote&) noexcept;
+// QuotePipeline<P1, P2, ...> вызывает их по порядку, и компилятор встраивает
+// всю цепочку в одну функцию без виртуальных вызовов и проверок флагов.
+// Сборка под площадку выбирает только нужные шаги: живой фид Binance (run_feed)
+// котирует через CexQuotePipeline. Dex/Pmm/Onchain-сборки пока используются только
+// в quote_pipeline_bench — фида этих площадок в дереве нет.
+
+struct QuoteParams {
+    double gamma;       // Коэффициент риска
+    double T;           // Горизонт времени
+    double min_spread;  // Минимальная ширина котировки, доля цены
+};
+
+namespace quote_policy {
+
+// Avellaneda-Stoikov: k из состояния или по top-of-book, ask/bid без ограничений на ширину.
+// Заполняет base_ask/base_bid и ask/bid.
+struct AvellanedaStoikov {
+    static void apply(const QuoteParams& p, const MarketState& s, double inventory, Quote& quote) noexcept {
+        quote.k = s.k > 0 ? s.k : QuoteEngine::order_intensity(s.bid, s.ask, s.bid_qty, s.ask_qty);
+        double spread_term = (1.0 / p.gamma) * std::log(1.0 + p.gamma / quote.k);
+        double inventory_term = inventory * s.sigma * s.sigma * p.T;
+        quote.ask = s.price + spread_term + inventory_term;
+        quote.bid = s.price - spread_term - inventory_term;
+        quote.base_ask = quote.ask;
+        quote.base_bid = quote.bid;
+    }
+};
+
+// Минимальная ширина min_spread от цены вокруг середины котировки; при неположительной
+// цене — 0.1, чтобы ask > bid. Без ветвлений: ширина берется через max.
+struct MinSpreadGuard {
+    static void apply(const QuoteParams& p, const MarketState& s, double, Quote& quote) noexcept {
+        double mid = (quote.ask + quote.bid) / 2;
+        double width = std::max(quote.ask - quote.bid, s.price * p.min_spread);
+        width = width > 0.0 ? width : 0.1;
+        quote.ask = mid + width / 2;
+        quote.bid = mid - width / 2;
+        quote.base_ask = quote.ask;
+        quote.base_bid = quote.bid;
+    }
+};
+
+// Сдвиг обеих сторон на изменение цены за время задержки onchain (state.latency_shift)
+struct LatencyShift {
+    static void apply(const QuoteParams&, const MarketState& s, double, Quote& quote) noexcept {
+        quote.ask += s.latency_shift;
+        quote.bid += s.latency_shift;
+    }
+};
+
+// Стоимость газа на сделку trade_size, переведенная в цену за единицу,
+// расширяет обе стороны: сделка должна окупать газ. QuoteEngine::quote газ
+// только сообщает (quote.gas_cost) и цены на него не сдвигает.
+struct GasPenalty {
+    static void apply(const QuoteParams&, const MarketState& s, double, Quote& quote) noexcept {
+        quote.gas_cost = QuoteEngine::gas_cost(s.gas_price, s.trade_size);
+        double per_unit = quote.gas_cost * s.price / std::max(s.trade_size, 1e-12);
+        quote.ask += per_unit;
+        quote.bid -= per_unit;
+    }
+};
+
+// Сужение спреда при глубоком PMM-пуле: ширина делится на sqrt(depth / 10),
+// глубина меньше 10 не сужает (как MarketMaker::adjust_spreads_for_pmm)
+struct PmmDepth {
+    static void apply(const QuoteParams&, const MarketState& s, double, Quote& quote) noexcept {
+        const double MIN_POOL_DEPTH = 10.0;
+        double reduction = std::sqrt(MIN_POOL_DEPTH / std::max(s.pool_depth, MIN_POOL_DEPTH));
+        double mid = (quote.ask + quote.bid) / 2;
+        quote.ask = mid + (quote.ask - mid) * reduction;
+        quote.bid = mid - (mid - quote.bid) * reduction;
+    }
+};
+
+} // namespace quote_policy
+
+template <class... Policies>
+class QuotePipeline {
+public:
+    QuotePipeline(double gamma = 0.1, double T = 300.0, double min_spread = 0.001) : params_{gamma, T, min_spread} {}
+
+    Quote quote(const MarketState& state, double inventory) const noexcept {
+        Quote result{};
+        (Policies::apply(params_, state, inventory, result), ...);
+        return result;
+    }
+
+    const QuoteParams& params() const { return params_; }
+
+private:
+    QuoteParams params_;
+};
+
+// Сборки под площадки. Cex совпадает с QuoteEngine::quote без задержки и газа.
+using CexQuotePipeline = QuotePipeline<quote_policy::AvellanedaStoikov, quote_policy::MinSpreadGuard>;
+
+// Цены как у QuoteEngine::quote: базовая модель, минимальный спред, задержка
+using OnchainQuotePipeline = QuotePipeline<quote_policy::AvellanedaStoikov, quote_policy::MinSpreadGuard,
+                                           quote_policy::LatencyShift>;
+
+using DexQuotePipeline = QuotePipeline<quote_policy::AvellanedaStoikov, quote_policy::MinSpreadGuard,
+                                       quote_policy::LatencyShift, quote_policy::GasPenalty>;
+
+using PmmQuotePipeline = QuotePipeline<quote_policy::AvellanedaStoikov, quote_policy::MinSpreadGuard,
+                                       quote_policy::LatencyShift, quote_policy::GasPenalty,
+                                       quote_policy::PmmDepth>;
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef RNG_HPP
+#define RNG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Генератор на счетчике Philox-4x32-10: выход — шифр от (ключ = seed, счетчик),
+// поэтому состояние — два 64-битных числа, поток stream задает непересекающуюся
+// последовательность для того же seed (независимые потоки для параллельных
+// прогонов без общей синхронизации). Нормальные величины — ziggurat (128 слоев).
+//
+// Не потокобезопасен: у каждого потока свой экземпляр (thread_rng() или явный Rng).
+class Rng {
+public:
+    using result_type = uint64_t;
+
+    // Seed и номер потока по умолчанию: глобальный seed (set_global_seed) и
+    // очередной номер из счетчика процесса — воспроизводимо при одном порядке создания
+    Rng();
+    explicit Rng(uint64_t seed, uint64_t stream = 0) { this->seed(seed, stream); }
+
+    void seed(uint64_t seed, uint64_t stream = 0) {
+        key_ = seed;
+        stream_ = stream;
+        counter_ = 0;
+        index_ = 2;
+    }
+
+    uint64_t seed_value() const { return key_; }
+    uint64_t stream() const { return stream_; }
+
+    // Пропуск n блоков (2 * n 64-битных чисел) за O(1)
+    void discard_blocks(uint64_t n) {
+        counter_ += n;
+        index_ = 2;
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<uint64_t>::max(); }
+
+    result_type operator()() { return next_u64(); }
+
+    uint64_t next_u64() {
+        if (index_ == 2) {
+            generate_block(counter_++, block_);
+            index_ = 0;
+        }
+        return block_[index_++];
+    }
+
+    // Равномерно в [0, 1), 53 бита
+    double uniform() { return static_cast<double>(next_u64() >> 11) * 0x1.0p-53; }
+
+    // Стандартная нормальная величина
+    double normal();
+    double normal(double mean, double stddev) { return mean + stddev * normal(); }
+
+    // Массивы: out[i] = mean + stddev * N(0, 1) и равномерные в [0, 1)
+    void fill_normal(double* out, size_t n, double mean = 0.0, double stddev = 1.0);
+    void fill_uniform(double* out, size_t n);
+
+    // Блок Philox-4x32-10 для счетчика (counter, stream): два 64-битных числа
+    void generate_block(uint64_t counter, uint64_t out[2]) const;
+
+    // Блоки counter .. counter + blocks - 1 подряд в out (2 * blocks чисел)
+    void generate_blocks(uint64_t counter, size_t blocks, uint64_t* out) const;
+
+private:
+    static constexpr size_t BULK_BLOCKS = 128;  // Блоков на порцию fill_normal / fill_uniform
+
+    uint64_t key_ = 0;
+    uint64_t stream_ = 0;
+    uint64_t counter_ = 0;
+    uint64_t block_[2] = {0, 0};
+    unsigned index_ = 2;  // Следующее слово в block_; 2 — блок исчерпан
+};
+
+// Глобальный seed для генераторов по умолчанию (thread_rng и Rng()). Без вызова —
+// случайный seed из std::random_device. Вызывать до создания генераторов.
+void set_global_seed(uint64_t seed);
+uint64_t global_seed();
+
+// Генератор текущего потока
+Rng& thread_rng();
+
+#endif
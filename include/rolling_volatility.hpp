@@ -0,0 +1,78 @@
+#ifndef ROLLING_VOLATILITY_HPP
+#define ROLLING_VOLATILITY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Потоковая оценка волатильности логарифмических доходностей.
+// Обновление — O(число горизонтов) на тик: доходность считается один раз
+// и попадает во все горизонты. Память фиксирована: общий кольцевой буфер
+// доходностей размера capacity, больше ничего не растет.
+//
+// Горизонты:
+//   Window     — скользящее окно из window последних доходностей (Welford add/remove)
+//   TimeWindow — доходности за последние duration_ns (не больше capacity штук)
+//   Ewma       — экспоненциальное сглаживание; вес по числу тиков или по времени
+class RollingVolatility {
+public:
+    enum class Kind {
+        Window,
+        TimeWindow,
+        Ewma
+    };
+
+    struct Horizon {
+        Kind kind = Kind::Window;
+        size_t window = 0;          // Window
+        uint64_t duration_ns = 0;   // TimeWindow
+        double alpha = 0.0;         // Ewma: вес нового наблюдения
+        uint64_t halflife_ns = 0;   // Ewma: если задан, вес зависит от времени между тиками
+
+        static Horizon rolling(size_t window);
+        static Horizon timed(uint64_t duration_ns);
+        static Horizon ewma(double alpha);
+        static Horizon ewma_halflife(uint64_t halflife_ns);
+    };
+
+    // capacity = 0 — по самому длинному окну Window (для TimeWindow задается явно).
+    // scale умножает стандартное отклонение (например, sqrt(60) для перевода в минуты).
+    RollingVolatility(std::vector<Horizon> horizons, size_t capacity = 0, double scale = 1.0);
+
+    // Новая цена; time_ns нужен только для TimeWindow и Ewma с halflife_ns
+    void update(double price, uint64_t time_ns = 0);
+    void reset();
+
+    // Стандартное отклонение доходности горизонта * scale; 0, пока доходностей меньше двух
+    double volatility(size_t horizon = 0) const;
+    double variance(size_t horizon = 0) const;
+    size_t count(size_t horizon = 0) const { return states_[horizon].n; }
+    size_t horizon_count() const { return states_.size(); }
+    size_t capacity() const { return returns_.size(); }
+
+private:
+    struct State {
+        Horizon horizon;
+        uint64_t tail = 0;      // Порядковый номер самой старой доходности в окне
+        size_t n = 0;
+        double mean = 0.0;
+        double m2 = 0.0;        // Сумма квадратов отклонений (Welford); у Ewma — сама дисперсия
+        size_t removals = 0;    // Удалений с последнего пересчета
+    };
+
+    std::vector<State> states_;
+    std::vector<double> returns_;   // Кольцевой буфер, индекс — номер доходности % capacity
+    std::vector<uint64_t> times_;
+    uint64_t head_ = 0;             // Номер следующей доходности
+    double scale_;
+    double last_price_ = 0.0;
+    uint64_t last_time_ = 0;
+    bool has_price_ = false;
+
+    void add(State& state, double value);
+    void remove_oldest(State& state);
+    void resync(State& state);
+    void update_ewma(State& state, double value, uint64_t dt_ns);
+};
+
+#endif
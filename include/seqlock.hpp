@@ -0,0 +1,47 @@
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Публикация значения одним писателем для любого числа читателей без блокировок.
+// Писатель никогда не ждет; читатель повторяет чтение, если попал на запись.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock stores trivially copyable values");
+
+public:
+    SeqLock() : value_{} {}
+
+    void store(const T& value) {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);  // Нечетное значение — идет запись
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&value_, &value, sizeof(T));
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        T result;
+        uint64_t before;
+        uint64_t after;
+        do {
+            before = seq_.load(std::memory_order_acquire);
+            std::memcpy(&result, &value_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = seq_.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+        return result;
+    }
+
+    // Номер версии: меняется при каждой записи
+    uint64_t version() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    T value_;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Ограниченная lock-free очередь один производитель / один потребитель.
+// Емкость округляется до степени двойки, память выделяется один раз
+// в конструкторе. Индексы производителя и потребителя лежат в разных
+// кэш-линиях, каждая сторона кэширует чужой индекс, чтобы не читать
+// общую линию на каждой операции.
+template <typename T>
+class SpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue stores trivially copyable events");
+
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        mask_ = size - 1;
+        buffer_.reset(new T[size]);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Только поток-производитель
+    bool try_push(const T& value) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) return false;
+        }
+        buffer_[head & mask_] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток-потребитель
+    bool try_pop(T& value) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_) return false;
+        }
+        value = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Приблизительная глубина очереди (можно читать из любого потока)
+    size_t size() const {
+        uint64_t tail = tail_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        return head >= tail ? static_cast<size_t>(head - tail) : 0;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    size_t mask_;
+    std::unique_ptr<T[]> buffer_;
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;  // Копия tail_ у производителя
+
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_ = 0;  // Копия head_ у потребителя
+};
+
+#endif
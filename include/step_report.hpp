@@ -0,0 +1,18 @@
+#ifndef STEP_REPORT_HPP
+#define STEP_REPORT_HPP
+
+#include "fill_simulator.hpp"
+#include "quote_engine.hpp"
+#include <ostream>
+
+// Итог шага симуляции для вывода; форматирование отделено от расчета котировок
+struct StepReport {
+    double S_t;
+    double inventory;  // После сделки
+    Quote quote;
+    Fill fill;
+};
+
+void print_step_report(std::ostream& out, const StepReport& report);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef STREAM_DISPATCH_HPP
+#define STREAM_DISPATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Таблица маршрутизации имени потока ("ethusdt@depth@100ms") в индекс символа.
+// Строится один раз при подписке: открытая адресация по 64-битному FNV-1a,
+// при вставке проверяется, что хэши всех имен различны. На горячем пути
+// считается только хэш имени, сравнения строк нет.
+class StreamDispatchTable {
+public:
+    static constexpr int32_t NOT_FOUND = -1;
+
+    static uint64_t hash(const char* data, size_t size) {
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ull;
+        }
+        return h | 1;  // 0 зарезервирован под пустую ячейку
+    }
+
+    // Очистка перед заполнением; expected — ожидаемое число имен
+    void reset(size_t expected) {
+        size_t size = 4;
+        while (size < expected * 4) size <<= 1;
+        mask_ = size - 1;
+        count_ = 0;
+        slots_.assign(size, Slot{0, NOT_FOUND});
+    }
+
+    // false — таблица заполнена или хэш совпал с уже добавленным именем
+    bool insert(const std::string& name, int32_t id) {
+        if ((count_ + 1) * 2 > slots_.size()) return false;
+        uint64_t h = hash(name.data(), name.size());
+        size_t pos = h & mask_;
+        while (slots_[pos].hash != 0) {
+            if (slots_[pos].hash == h) return slots_[pos].id == id;
+            pos = (pos + 1) & mask_;
+        }
+        slots_[pos] = Slot{h, id};
+        ++count_;
+        return true;
+    }
+
+    int32_t find(const char* data, size_t size) const {
+        if (slots_.empty()) return NOT_FOUND;
+        uint64_t h = hash(data, size);
+        for (size_t pos = h & mask_;; pos = (pos + 1) & mask_) {
+            const Slot& slot = slots_[pos];
+            if (slot.hash == h) return slot.id;
+            if (slot.hash == 0) return NOT_FOUND;
+        }
+    }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        int32_t id;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    size_t count_ = 0;
+};
+
+#endif
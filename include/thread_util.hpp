@@ -0,0 +1,33 @@
+#ifndef THREAD_UTIL_HPP
+#define THREAD_UTIL_HPP
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+// Подсказка процессору внутри цикла ожидания
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Привязка текущего потока к ядру; core < 0 — без привязки.
+// false — ядро недоступно (нет такого ядра или запрещено cpuset).
+inline bool pin_current_thread(int core) {
+    if (core < 0) return true;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+// Процессорное время потока в секундах (user + system)
+inline double thread_cpu_seconds(pthread_t thread) {
+    clockid_t clock;
+    timespec ts;
+    if (pthread_getcpuclockid(thread, &clock) != 0 || clock_gettime(clock, &ts) != 0) return 0.0;
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TLS_SESSION_CACHE_HPP
+#define TLS_SESSION_CACHE_HPP
+
+#include <openssl/ssl.h>
+
+// Клиентская TLS-сессия одного хоста для возобновления при переподключении.
+// Сессия (session ticket) запоминается из колбэка OpenSSL и подставляется
+// в следующее соединение: вместо полного handshake — сокращенный, без
+// обмена сертификатами и асимметричной криптографии.
+class TlsSessionCache {
+public:
+    TlsSessionCache() = default;
+    ~TlsSessionCache();
+
+    TlsSessionCache(const TlsSessionCache&) = delete;
+    TlsSessionCache& operator=(const TlsSessionCache&) = delete;
+
+    // Включает клиентский кэш сессий в контексте (один раз на SSL_CTX)
+    static void enable(SSL_CTX* ctx);
+
+    // Вызывается до handshake: предлагает сохраненную сессию и подписывает
+    // соединение на новые тикеты
+    void attach(SSL* ssl);
+
+    void clear();
+    bool has_session() const { return session_ != nullptr; }
+
+    // Соединение закрывается без close_notify (обрыв, таймаут): помечаем его
+    // как корректно завершенное, иначе OpenSSL запретит возобновлять сессию
+    static void mark_closed(SSL* ssl);
+
+private:
+    static int on_new_session(SSL* ssl, SSL_SESSION* session);
+    static int ex_index();
+
+    SSL_SESSION* session_ = nullptr;
+};
+
+#endif
@@ -1,21 +1,26 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include "rng.hpp"
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <ctime>
-#include <random>
 
 namespace utils {
     inline double log(double x) { return std::log(x); }
     
-    // Улучшенная реализация нормального распределения с использованием Box-Muller transform
+    // Нормальное распределение из генератора текущего потока (thread_rng):
+    // потокобезопасно, воспроизводимо при set_global_seed
     inline double normal_dist(double mean, double stddev) {
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        static std::normal_distribution<double> dist(0, 1);
-        
-        return mean + stddev * dist(gen);
+        return thread_rng().normal(mean, stddev);
+    }
+
+    // Время по системным часам в наносекундах от UNIX epoch (для сопоставления с биржевым)
+    inline uint64_t wall_clock_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
     }
 }
 
@@ -0,0 +1,75 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с кражей работы для параллельных прогонов (перебор параметров,
+// Монте-Карло). Задачи — индексы [0, n): каждый поток получает свой непрерывный
+// диапазон и берет индексы с его начала; поток без работы забирает половину
+// конца диапазона у другого. Блокировки — только мьютекс диапазона (на своей
+// кэш-линии), которого владелец почти всегда не ждет: задачи крупные
+// (миллисекунды), кражи редки.
+//
+// Результат задачи должен зависеть только от индекса, а не от номера потока
+// и порядка выполнения: тогда прогон воспроизводим при любом числе потоков.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(size_t index, size_t worker)>;
+
+    struct Stats {
+        uint64_t tasks;
+        uint64_t steals;
+    };
+
+    // threads = 0 — по числу ядер; pin — привязать поток i к ядру i
+    explicit WorkStealingPool(size_t threads = 0, bool pin = false);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    size_t size() const { return threads_.size(); }
+
+    // task(i, worker) для всех i из [0, n); возвращается после завершения всех.
+    // Первое исключение задачи пробрасывается отсюда (остальные задачи доделываются).
+    void parallel_for(size_t n, const Task& task);
+
+    Stats stats() const;
+
+private:
+    struct alignas(64) Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    std::vector<std::thread> threads_;
+    std::unique_ptr<Range[]> ranges_;
+
+    std::mutex mutex_;  // Задание и ожидание его завершения
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const Task* task_ = nullptr;
+    uint64_t generation_ = 0;
+    size_t active_ = 0;  // Потоков, еще работающих над заданием
+    bool stopping_ = false;
+    std::exception_ptr error_;
+
+    std::atomic<uint64_t> tasks_{0};
+    std::atomic<uint64_t> steals_{0};
+
+    void worker_loop(size_t worker, bool pin);
+    bool pop(size_t worker, size_t& index);
+    bool steal(size_t worker);
+};
+
+#endif
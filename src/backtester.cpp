@@ -0,0 +1,261 @@
+#include "backtester.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Куча std::push_heap — max-heap, поэтому «больше» — позже
+struct LaterEvent {
+    template <class E>
+    bool operator()(const E& a, const E& b) const {
+        return a.time_ns != b.time_ns ? a.time_ns > b.time_ns : a.seq > b.seq;
+    }
+};
+
+int64_t floor_to_tick(int64_t price, int64_t tick) {
+    int64_t q = price / tick;
+    if (price % tick != 0 && price < 0) --q;
+    return q * tick;
+}
+
+int64_t ceil_to_tick(int64_t price, int64_t tick) {
+    int64_t q = price / tick;
+    if (price % tick != 0 && price > 0) ++q;
+    return q * tick;
+}
+
+} // namespace
+
+Backtester::Backtester(Config config)
+    : config_(config),
+      engine_(config.gamma, config.T),
+      volatility_({RollingVolatility::Horizon::ewma_halflife(config.sigma_halflife_ns)}, 0, std::sqrt(60.0)),
+      tick_(std::max<int64_t>(double_to_fixed(config.tick_size), 1)),
+      order_qty_(double_to_fixed(config.order_size)) {
+    events_.reserve(1024);
+}
+
+void Backtester::on_snapshot(const DepthUpdate& snapshot, uint64_t time_ns) {
+    run_events(time_ns);
+    now_ = time_ns;
+    ++stats_.market_events;
+    book_.apply_snapshot(snapshot);
+
+    // Позиция в очереди не может быть больше нового объема уровня
+    for (uint8_t side = BID; side <= ASK; ++side) {
+        RestingOrder& order = orders_[side];
+        if (!order.active) continue;
+        order.level_qty = side == BID ? book_.bid_qty_at(order.price) : book_.ask_qty_at(order.price);
+        order.queue_ahead = std::min(order.queue_ahead, order.level_qty);
+        match_through(side);
+    }
+    on_market(time_ns);
+}
+
+void Backtester::on_update(const DepthUpdate& update, uint64_t time_ns) {
+    run_events(time_ns);
+    now_ = time_ns;
+    ++stats_.market_events;
+
+    switch (book_.apply_update(update)) {
+        case OrderBook::UpdateResult::Applied:
+            break;
+        case OrderBook::UpdateResult::Gap:
+            ++stats_.gaps;
+            return;
+        case OrderBook::UpdateResult::Stale:
+        case OrderBook::UpdateResult::NotSynced:
+            return;
+    }
+
+    if (orders_[BID].active) {
+        match_level(BID, update.bids, update.bid_count);
+        match_through(BID);
+    }
+    if (orders_[ASK].active) {
+        match_level(ASK, update.asks, update.ask_count);
+        match_through(ASK);
+    }
+    on_market(time_ns);
+}
+
+void Backtester::finish() {
+    run_events(UINT64_MAX);
+}
+
+void Backtester::push_event(uint64_t time_ns, EventType type, uint8_t side, int64_t price, int64_t qty) {
+    events_.push_back(Event{time_ns, next_seq_++, type, side, price, qty});
+    std::push_heap(events_.begin(), events_.end(), LaterEvent{});
+}
+
+void Backtester::run_events(uint64_t until_ns) {
+    while (!events_.empty() && events_.front().time_ns <= until_ns) {
+        std::pop_heap(events_.begin(), events_.end(), LaterEvent{});
+        Event event = events_.back();
+        events_.pop_back();
+        now_ = event.time_ns;
+        ++stats_.internal_events;
+        handle_event(event);
+    }
+}
+
+void Backtester::handle_event(const Event& event) {
+    SentQuote& sent = sent_[event.side];
+    switch (event.type) {
+        case EventType::OrderArrival:
+            place_order(event.side, event.price, event.qty);
+            break;
+        case EventType::FillReport:
+            known_inventory_ += fixed_to_double(event.side == BID ? event.qty : -event.qty);
+            // Заявка исполнена целиком — сторону нужно котировать заново
+            if (sent.price == event.price) {
+                sent.qty -= event.qty;
+                if (sent.qty <= 0) sent = SentQuote{};
+            }
+            break;
+        case EventType::RejectReport:
+            if (sent.price == event.price) sent = SentQuote{};
+            break;
+    }
+}
+
+void Backtester::place_order(uint8_t side, int64_t price, int64_t qty) {
+    RestingOrder& order = orders_[side];
+    if (qty <= 0) {
+        order.active = false;
+        return;
+    }
+
+    // Post-only: за время задержки рынок мог дойти до нашей цены
+    bool crosses = side == BID ? book_.ask_levels() > 0 && price >= book_.ask(0).price
+                               : book_.bid_levels() > 0 && price <= book_.bid(0).price;
+    if (crosses) {
+        order.active = false;
+        ++stats_.rejected;
+        push_event(now_ + config_.report_latency_ns, EventType::RejectReport, side, price, qty);
+        return;
+    }
+
+    // Замена заявки: в конец очереди уровня
+    int64_t level = side == BID ? book_.bid_qty_at(price) : book_.ask_qty_at(price);
+    order = RestingOrder{true, price, qty, level, level};
+}
+
+void Backtester::match_level(uint8_t side, const PriceLevel* levels, size_t count) {
+    RestingOrder& order = orders_[side];
+    for (size_t i = 0; i < count; ++i) {
+        if (levels[i].price != order.price) continue;
+
+        int64_t decrease = order.level_qty - levels[i].qty;
+        order.level_qty = levels[i].qty;
+        if (decrease <= 0) return;  // Новые заявки встают за нами
+
+        int64_t ahead = std::min(decrease, order.queue_ahead);
+        order.queue_ahead -= ahead;
+        int64_t excess = decrease - ahead;
+
+        // Сделки идут только по лучшему уровню: наша цена не хуже лучшей цены стороны
+        bool at_best = side == BID ? book_.bid_levels() == 0 || order.price >= book_.bid(0).price
+                                   : book_.ask_levels() == 0 || order.price <= book_.ask(0).price;
+        if (!at_best) return;
+        if (levels[i].qty == 0) {
+            fill(side, order.qty);  // Уровень снесен сделками
+        } else if (excess > 0) {
+            fill(side, std::min(excess, order.qty));
+        }
+        return;
+    }
+}
+
+void Backtester::match_through(uint8_t side) {
+    RestingOrder& order = orders_[side];
+    if (!order.active) return;
+    bool through = side == BID ? book_.ask_levels() > 0 && book_.ask(0).price <= order.price
+                               : book_.bid_levels() > 0 && book_.bid(0).price >= order.price;
+    if (through) fill(side, order.qty);
+}
+
+void Backtester::fill(uint8_t side, int64_t qty) {
+    RestingOrder& order = orders_[side];
+    if (qty <= 0) return;
+
+    double price = fixed_to_double(order.price);
+    double filled = fixed_to_double(qty);
+    double notional = price * filled;
+    double fee = notional * config_.maker_fee;
+    if (side == BID) {
+        stats_.inventory += filled;
+        stats_.cash -= notional;
+        stats_.buy_qty += filled;
+    } else {
+        stats_.inventory -= filled;
+        stats_.cash += notional;
+        stats_.sell_qty += filled;
+    }
+    stats_.cash -= fee;
+    stats_.fees += fee;
+    stats_.volume += notional;
+    ++stats_.fills;
+    stats_.max_abs_inventory = std::max(stats_.max_abs_inventory, std::fabs(stats_.inventory));
+
+    order.qty -= qty;
+    if (order.qty <= 0) order.active = false;
+    push_event(now_ + config_.report_latency_ns, EventType::FillReport, side, order.price, qty);
+}
+
+void Backtester::on_market(uint64_t time_ns) {
+    if (!book_.has_top()) return;
+    double mid = book_.mid_price();
+    volatility_.update(mid, time_ns);
+    mark(mid);
+
+    if (!quoted_ || time_ns - last_quote_ns_ >= config_.quote_interval_ns) {
+        decide(time_ns);
+        last_quote_ns_ = time_ns;
+        quoted_ = true;
+    }
+
+    if (on_sample_ && config_.sample_interval_ns > 0 && time_ns >= next_sample_ns_) {
+        Sample sample;
+        sample.time_ns = time_ns;
+        sample.mid = mid;
+        sample.quote_bid = orders_[BID].active ? fixed_to_double(orders_[BID].price) : 0.0;
+        sample.quote_ask = orders_[ASK].active ? fixed_to_double(orders_[ASK].price) : 0.0;
+        sample.inventory = stats_.inventory;
+        sample.cash = stats_.cash;
+        sample.equity = stats_.equity;
+        on_sample_(sample);
+        next_sample_ns_ = (time_ns / config_.sample_interval_ns + 1) * config_.sample_interval_ns;
+    }
+}
+
+void Backtester::decide(uint64_t time_ns) {
+    double sigma = std::max(volatility_.volatility(0), config_.min_sigma);
+    double k = QuoteEngine::order_intensity(book_.best_bid(), book_.best_ask(),
+                                            book_.best_bid_qty(), book_.best_ask_qty());
+    double ask, bid;
+    engine_.spreads(book_.mid_price(), sigma, k, known_inventory_, ask, bid);
+
+    // Наружу до тика и не хуже лучшей цены противоположной стороны (post-only)
+    SentQuote desired[2];
+    desired[BID].price = std::min(floor_to_tick(double_to_fixed(bid), tick_), book_.ask(0).price - tick_);
+    desired[ASK].price = std::max(ceil_to_tick(double_to_fixed(ask), tick_), book_.bid(0).price + tick_);
+    desired[BID].qty = known_inventory_ + config_.order_size <= config_.max_inventory ? order_qty_ : 0;
+    desired[ASK].qty = known_inventory_ - config_.order_size >= -config_.max_inventory ? order_qty_ : 0;
+
+    for (uint8_t side = BID; side <= ASK; ++side) {
+        SentQuote& want = desired[side];
+        if (want.qty == 0) want.price = 0;
+        SentQuote& sent = sent_[side];
+        if (want.price == sent.price && want.qty == sent.qty) continue;
+        sent = want;
+        ++stats_.order_updates;
+        push_event(time_ns + config_.order_latency_ns, EventType::OrderArrival, side, want.price, want.qty);
+    }
+}
+
+void Backtester::mark(double mid) {
+    stats_.equity = stats_.cash + stats_.inventory * mid;
+    peak_equity_ = std::max(peak_equity_, stats_.equity);
+    stats_.max_drawdown = std::max(stats_.max_drawdown, peak_equity_ - stats_.equity);
+}
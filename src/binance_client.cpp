@@ -1,118 +1,555 @@
 #include "binance_client.hpp"
+#include "quote_engine.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <iostream>
-#include <thread>
+
+namespace {
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
 
 BinanceClient::BinanceClient(net::io_context& ioc)
     : ioc_(ioc),
-      ws_(net::make_strand(ioc)),
-      connection_timer_(net::make_strand(ioc)) {}
+      strand_(net::make_strand(ioc)),
+      ssl_ctx_(ssl::context::tls_client),
+      resolver_(strand_),
+      connection_timer_(strand_),
+      reconnect_timer_(strand_),
+      depth_(std::make_unique<DepthUpdate>()),
+      rest_resolver_(strand_),
+      snapshot_retry_timer_(strand_) {
+    // Резервируем буфер заранее, чтобы чтение не аллоцировало на каждом кадре
+    buffer_.reserve(1 << 16);
 
-void BinanceClient::connect_and_subscribe(const std::string& symbol, MarketDataCallback callback) {
+    ssl_ctx_.set_default_verify_paths();
+    TlsSessionCache::enable(ssl_ctx_.native_handle());
+    set_transport(transport_);
+}
+
+void BinanceClient::set_transport(const TransportConfig& transport) {
+    transport_ = transport;
+    ssl_ctx_.set_verify_mode(transport_.verify_peer ? ssl::verify_peer : ssl::verify_none);
+
+    // Сессия другого хоста бесполезна
+    ws_session_.clear();
+    rest_session_.clear();
+}
+
+void BinanceClient::connect_and_subscribe(const std::vector<std::string>& symbols, MarketDataCallback callback) {
     callback_ = callback;
-    run(host_, port_);
-    
-    // Подписка на стакан ордеров и сделки
-    std::string stream = symbol + "@depth@100ms";
-    ws_.async_write(
-        net::buffer(stream),
-        [this](beast::error_code ec, std::size_t) {
-            if(ec) {
-                std::cerr << "Subscribe error: " << ec.message() << std::endl;
-                return;
+    set_symbols(symbols);
+    live_ = true;
+    net::dispatch(strand_, [this]() { start_connect(); });
+}
+
+void BinanceClient::connect_and_subscribe(const std::string& symbol, MarketDataCallback callback) {
+    connect_and_subscribe(std::vector<std::string>{symbol}, callback);
+}
+
+void BinanceClient::set_symbols(const std::vector<std::string>& symbols) {
+    feeds_.clear();
+    stream_dispatch_.reset(symbols.size());
+    symbol_dispatch_.reset(symbols.size() * 2);
+
+    for (const auto& name : symbols) {
+        auto feed = std::make_unique<SymbolFeed>();
+        feed->symbol = name;
+        feed->rest_symbol = name;
+        std::transform(feed->symbol.begin(), feed->symbol.end(), feed->symbol.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        std::transform(feed->rest_symbol.begin(), feed->rest_symbol.end(), feed->rest_symbol.begin(),
+                       [](unsigned char c) { return std::toupper(c); });
+
+        int32_t id = static_cast<int32_t>(feeds_.size());
+        if (!stream_dispatch_.insert(feed->symbol + stream_suffix_, id) ||
+            !symbol_dispatch_.insert(feed->symbol, id) ||
+            !symbol_dispatch_.insert(feed->rest_symbol, id)) {
+            std::cerr << "Duplicate or colliding symbol ignored: " << name << std::endl;
+            continue;
+        }
+
+        for (double pct : depth_bands_) feed->book.add_depth_band(pct);
+        feed->market_data.symbol_id = static_cast<uint32_t>(id);
+        feeds_.push_back(std::move(feed));
+        feeds_.back()->market_data.symbol = feeds_.back()->symbol.c_str();
+    }
+}
+
+void BinanceClient::set_depth_bands(const std::vector<double>& pcts) {
+    depth_bands_ = pcts;
+    if (depth_bands_.size() > OrderBook::MAX_DEPTH_BANDS) {
+        std::cerr << "Only " << OrderBook::MAX_DEPTH_BANDS << " depth bands are supported" << std::endl;
+        depth_bands_.resize(OrderBook::MAX_DEPTH_BANDS);
+    }
+    for (auto& feed : feeds_) {
+        feed->book.clear_depth_bands();
+        for (double pct : depth_bands_) feed->book.add_depth_band(pct);
+    }
+}
+
+int32_t BinanceClient::find_symbol(const char* symbol) const {
+    return symbol_dispatch_.find(symbol, std::strlen(symbol));
+}
+
+std::string BinanceClient::stream_target() const {
+    // /stream?streams=ethusdt@depth@100ms/btcusdt@depth@100ms
+    std::string target = "/stream?streams=";
+    for (size_t i = 0; i < feeds_.size(); ++i) {
+        if (i) target += "/";
+        target += feeds_[i]->symbol + stream_suffix_;
+    }
+    return target;
+}
+
+void BinanceClient::prepare_tls(TlsStream& stream, const std::string& host, TlsSessionCache& session) {
+    SSL* ssl = stream.native_handle();
+    // SNI: без него CDN не выберет сертификат
+    SSL_set_tlsext_host_name(ssl, host.c_str());
+    if(transport_.verify_peer) {
+        stream.set_verify_callback(ssl::host_name_verification(host));
+    }
+    if(transport_.session_resumption) {
+        session.attach(ssl);
+    }
+}
+
+// Последовательный перебор адресов резолвера. Сокет открывается вручную,
+// чтобы опции легли до connect: размер буфера приема влияет на window scale,
+// который согласуется уже в SYN.
+template <class Handler>
+void BinanceClient::async_connect_endpoints(beast::tcp_stream& stream, tcp::resolver::results_type results,
+                                            tcp::resolver::results_type::iterator it, Handler handler) {
+    if(it == results.end()) {
+        return handler(beast::error_code(net::error::host_not_found));
+    }
+
+    beast::error_code ec;
+    tcp::socket& socket = stream.socket();
+    socket.close(ec);
+    socket.open(it->endpoint().protocol(), ec);
+    if(!ec && transport_.tcp_nodelay) socket.set_option(tcp::no_delay(true), ec);
+    if(!ec && transport_.receive_buffer_size > 0) {
+        socket.set_option(net::socket_base::receive_buffer_size(transport_.receive_buffer_size), ec);
+    }
+    if(!ec && transport_.send_buffer_size > 0) {
+        socket.set_option(net::socket_base::send_buffer_size(transport_.send_buffer_size), ec);
+    }
+    if(!ec) socket.set_option(net::socket_base::keep_alive(true), ec);
+    if(ec) return handler(ec);
+
+    stream.async_connect(it->endpoint(),
+        [this, &stream, results, it, handler](beast::error_code ec) mutable {
+            if(!ec || ec == net::error::operation_aborted || ec == beast::error::timeout) {
+                return handler(ec);
             }
-            
-            // Начинаем чтение данных
-            ws_.async_read(
-                buffer_,
-                beast::bind_front_handler(
-                    &BinanceClient::on_read,
-                    this));
+            async_connect_endpoints(stream, results, std::next(it), std::move(handler));
         });
 }
 
-void BinanceClient::run(const std::string& host, const std::string& port) {
-    auto on_fail = [this, host, port](beast::error_code ec, const std::string& msg) {
-        std::cerr << "Binance connection error (" << msg << "): " << ec.message() << std::endl;
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        run(host, port); // Переподключение через 5 секунд
-    };
+void BinanceClient::start_connect() {
+    uint64_t generation = ++generation_;
+    connect_started_ns_ = steady_ns();
 
-    tcp::resolver resolver(ioc_);
-    beast::get_lowest_layer(ws_).async_connect(
-        resolver.resolve(host, port),
-        [this, on_fail](beast::error_code ec, tcp::resolver::results_type::endpoint_type) {
-            if(ec) return on_fail(ec, "connect");
-            
-            // SSL handshake
-            beast::get_lowest_layer(ws_).socket().set_option(
-                net::socket_base::keep_alive(true));
-            
-            // WebSocket handshake
-            ws_.async_handshake(
-                host_, "/ws",
-                [this, on_fail](beast::error_code ec) {
-                    if(ec) return on_fail(ec, "handshake");
-                    
-                    // Запускаем таймер проверки соединения
-                    start_connection_check();
+    // Beast-поток нельзя переиспользовать после закрытия: создаем новый,
+    // старый живет до следующей попытки, пока завершаются его обработчики
+    retired_ws_ = std::move(ws_);
+    ws_ = std::make_unique<WebSocket>(strand_, ssl_ctx_);
+    buffer_.consume(buffer_.size());
+    prepare_tls(ws_->next_layer(), transport_.host, ws_session_);
+
+    state_ = ConnectionState::Resolving;
+    resolver_.async_resolve(transport_.host, transport_.port,
+        [this, generation](beast::error_code ec, tcp::resolver::results_type results) {
+            if(generation != generation_) return;
+            if(ec) return on_connection_failed(generation, ec, "resolve");
+
+            state_ = ConnectionState::Connecting;
+            beast::tcp_stream& tcp_stream = beast::get_lowest_layer(*ws_);
+            tcp_stream.expires_after(std::chrono::seconds(10));
+            async_connect_endpoints(tcp_stream, results, results.begin(),
+                [this, generation](beast::error_code ec) {
+                    if(generation != generation_) return;
+                    if(ec) return on_connection_failed(generation, ec, "connect");
+
+                    state_ = ConnectionState::Handshaking;
+                    ws_->next_layer().async_handshake(ssl::stream_base::client,
+                        [this, generation](beast::error_code ec) {
+                            if(generation != generation_) return;
+                            if(ec) return on_connection_failed(generation, ec, "tls handshake");
+
+                            if(SSL_session_reused(ws_->next_layer().native_handle())) ++tls_resumed_;
+
+                            // WebSocket handshake: подписка на все символы задается путем combined stream
+                            ws_->async_handshake(transport_.host, stream_target(),
+                                [this, generation](beast::error_code ec) {
+                                    if(generation != generation_) return;
+                                    if(ec) return on_connection_failed(generation, ec, "handshake");
+
+                                    // Дальше за живостью следит ping, таймаут TCP больше не нужен
+                                    beast::get_lowest_layer(*ws_).expires_never();
+                                    on_streaming();
+                                    start_connection_check(generation);
+                                    start_read(generation);
+                                });
+                        });
                 });
         });
 }
 
-void BinanceClient::start_connection_check() {
+void BinanceClient::on_streaming() {
+    state_ = ConnectionState::Streaming;
+    last_connect_ns_ = static_cast<uint64_t>(steady_ns() - connect_started_ns_);
+    ++connects_;
+    reconnect_attempt_ = 0;
+
+    int64_t since = disconnected_since_ns_.exchange(0);
+    if(since) disconnected_ns_ += static_cast<uint64_t>(steady_ns() - since);
+
+    // Пока соединения не было, обновления стаканов потеряны: стаканы строятся заново
+    // от снапшотов, буферизуются только diff-обновления нового соединения
+    for(uint32_t id = 0; id < feeds_.size(); ++id) {
+        feeds_[id]->buffered.clear();
+        request_snapshot(id);
+    }
+}
+
+void BinanceClient::on_connection_failed(uint64_t generation, beast::error_code ec, const char* stage) {
+    // Ошибка уже обработана (например, упали и чтение, и ping)
+    if(generation != generation_ || state_ == ConnectionState::Backoff) return;
+
+    if(state_ == ConnectionState::Streaming) {
+        ++disconnects_;
+    } else {
+        ++failed_attempts_;
+    }
+    int64_t expected = 0;
+    disconnected_since_ns_.compare_exchange_strong(expected, steady_ns());
+
+    // Новое поколение: обработчики закрываемого сокета будут проигнорированы
+    ++generation_;
+    TlsSessionCache::mark_closed(ws_->next_layer().native_handle());
+    beast::get_lowest_layer(*ws_).close();
+    connection_timer_.cancel();
+
+    auto delay = next_backoff(reconnect_attempt_++);
+    std::cerr << "Binance connection error (" << stage << "): " << ec.message()
+              << ", reconnecting in " << delay.count() << " ms" << std::endl;
+
+    // Ожидание на таймере не блокирует io_context: остальные обработчики продолжают работать
+    state_ = ConnectionState::Backoff;
+    reconnect_timer_.expires_after(delay);
+    reconnect_timer_.async_wait([this](beast::error_code ec) {
+        if(ec) return;
+        start_connect();
+    });
+}
+
+std::chrono::milliseconds BinanceClient::next_backoff(uint32_t attempt) {
+    const ReconnectPolicy& policy = reconnect_policy_;
+    double delay = static_cast<double>(policy.initial_delay.count());
+    for(uint32_t i = 0; i < attempt && delay < policy.max_delay.count(); ++i) {
+        delay *= policy.multiplier;
+    }
+    delay = std::min(delay, static_cast<double>(policy.max_delay.count()));
+
+    std::uniform_real_distribution<double> jitter(1.0 - policy.jitter, 1.0 + policy.jitter);
+    return std::chrono::milliseconds(static_cast<int64_t>(delay * jitter(jitter_rng_)));
+}
+
+BinanceClient::ConnectionStats BinanceClient::connection_stats() const {
+    uint64_t disconnected = disconnected_ns_.load(std::memory_order_relaxed);
+    int64_t since = disconnected_since_ns_.load(std::memory_order_relaxed);
+    if(since) disconnected += static_cast<uint64_t>(steady_ns() - since);
+
+    return {
+        connects_.load(std::memory_order_relaxed),
+        disconnects_.load(std::memory_order_relaxed),
+        failed_attempts_.load(std::memory_order_relaxed),
+        disconnected,
+        updates_lost_.load(std::memory_order_relaxed),
+        tls_resumed_.load(std::memory_order_relaxed),
+        last_connect_ns_.load(std::memory_order_relaxed)
+    };
+}
+
+void BinanceClient::start_connection_check(uint64_t generation) {
     connection_timer_.expires_after(std::chrono::seconds(30));
     connection_timer_.async_wait(
-        [this](beast::error_code ec) {
-            if(ec) return;
-            
+        [this, generation](beast::error_code ec) {
+            if(ec || generation != generation_) return;
+
             // Отправляем ping
-            ws_.async_ping({},
-                [this](beast::error_code ec) {
-                    if(ec) {
-                        std::cerr << "Connection lost, reconnecting..." << std::endl;
-                        run(host_, port_);
-                    } else {
-                        start_connection_check();
-                    }
+            ws_->async_ping({},
+                [this, generation](beast::error_code ec) {
+                    if(generation != generation_) return;
+                    if(ec) return on_connection_failed(generation, ec, "ping");
+                    start_connection_check(generation);
                 });
         });
 }
 
-void BinanceClient::on_read(beast::error_code ec, std::size_t) {
-    if(ec) {
-        std::cerr << "Read error: " << ec.message() << std::endl;
-        
-        // Попытка переподключения через 5 секунд
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-        run(host_, port_);
-        return;
+void BinanceClient::start_read(uint64_t generation) {
+    ws_->async_read(
+        buffer_,
+        [this, generation](beast::error_code ec, std::size_t bytes_transferred) {
+            on_read(generation, ec, bytes_transferred);
+        });
+}
+
+void BinanceClient::on_read(uint64_t generation, beast::error_code ec, std::size_t) {
+    uint64_t recv_time_ns = utils::wall_clock_ns();
+
+    if(generation != generation_) return;
+    if(ec) return on_connection_failed(generation, ec, "read");
+
+    // Разбираем кадр прямо из flat_buffer, без копирования в строку и json DOM
+    auto frame = buffer_.data();
+    process_message(static_cast<const char*>(frame.data()), frame.size(), recv_time_ns);
+    buffer_.consume(buffer_.size());
+
+    // Читаем следующее сообщение
+    start_read(generation);
+}
+
+int32_t BinanceClient::route_message(const char*& data, size_t& size) const {
+    const char* stream;
+    size_t stream_size;
+    const char* payload;
+    size_t payload_size;
+    if(parse_stream_envelope(data, size, stream, stream_size, payload, payload_size)) {
+        data = payload;
+        size = payload_size;
+        return stream_dispatch_.find(stream, stream_size);
     }
-    
+
+    // Кадр без обертки (raw stream): единственный символ
+    return feeds_.size() == 1 ? 0 : StreamDispatchTable::NOT_FOUND;
+}
+
+void BinanceClient::process_message(const char* data, size_t size, uint64_t recv_time_ns) {
+    const char* frame = data;
+    size_t frame_size = size;
+    int32_t id = route_message(data, size);
+
+    if(capture_) {
+        const char* tag = id >= 0 ? feeds_[id]->symbol.c_str() : "";
+        capture_->record(tag, frame, frame_size, recv_time_ns);
+    }
+    if(id < 0) return;
+    ++feeds_[id]->stats.messages;
+    process_depth(static_cast<uint32_t>(id), data, size, recv_time_ns);
+}
+
+void BinanceClient::process_depth(uint32_t id, const char* data, size_t size, uint64_t recv_time_ns) {
+    SymbolFeed& feed = *feeds_[id];
+    if(!parse_depth_update(data, size, *depth_)) return;
+    uint64_t parse_time_ns = utils::wall_clock_ns();
+
+    switch(feed.book.apply_update(*depth_)) {
+        case OrderBook::UpdateResult::Applied:
+            ++feed.stats.updates_applied;
+            feed.last_applied_id = depth_->final_update_id;
+            break;
+        case OrderBook::UpdateResult::Gap:
+            ++feed.stats.gaps;
+            std::cerr << "Order book gap for " << feed.symbol << ", requesting snapshot" << std::endl;
+            request_snapshot(id);
+            // Само обновление новее разрыва: может понадобиться после следующего снапшота
+            buffer_update(feed, data, size, recv_time_ns);
+            return;
+        case OrderBook::UpdateResult::Stale:
+            ++feed.stats.stale_updates;
+            return;
+        case OrderBook::UpdateResult::NotSynced:
+            // Снапшот еще в пути: обновления после его среза понадобятся, когда он придет
+            ++feed.stats.unsynced_updates;
+            buffer_update(feed, data, size, recv_time_ns);
+            return;
+    }
+
+    // Обработка данных стакана
+    const DepthUpdate& depth = *depth_;
+    const OrderBook& book = feed.book;
+    MarketData& md = feed.market_data;
+    md.bid_price = book.best_bid();
+    md.bid_qty = book.best_bid_qty();
+    md.ask_price = book.best_ask();
+    md.ask_qty = book.best_ask_qty();
+    md.event_time = depth.event_time;
+    md.recv_time_ns = recv_time_ns;
+    md.parse_time_ns = parse_time_ns;
+    md.first_update_id = depth.first_update_id;
+    md.final_update_id = depth.final_update_id;
+    // Полоса поддерживается стаканом инкрементально: k считается здесь за O(1),
+    // и поток стратегии получает его в событии вместо самого стакана
+    md.k = book.depth_band_count() > 0
+        ? QuoteEngine::depth_intensity(book.bid_band_depth(0), book.ask_band_depth(0),
+                                       book.mid_price(), book.depth_band_pct(0))
+        : 0.0;
+    md.depth = &depth;
+    md.book = &book;
+    feed.stats.last_event_time = depth.event_time;
+
     try {
-        auto data = beast::buffers_to_string(buffer_.data());
-        buffer_.consume(buffer_.size());
-        
-        json market_data = json::parse(data);
-        
-        // Обработка данных стакана
-        if(market_data.contains("bids") && market_data.contains("asks")) {
-            MarketData md;
-            md.bid_price = std::stod(market_data["bids"][0][0].get<std::string>());
-            md.bid_qty = std::stod(market_data["bids"][0][1].get<std::string>());
-            md.ask_price = std::stod(market_data["asks"][0][0].get<std::string>());
-            md.ask_qty = std::stod(market_data["asks"][0][1].get<std::string>());
-            md.event_time = market_data["E"].get<uint64_t>();
-            
-            callback_(market_data);
-        }
+        callback_(md);
     } catch(const std::exception& e) {
         std::cerr << "Data processing error: " << e.what() << std::endl;
     }
-    
-    // Читаем следующее сообщение
-    ws_.async_read(
-        buffer_,
-        beast::bind_front_handler(
-            &BinanceClient::on_read,
-            this));
-}
\ No newline at end of file
+}
+
+bool BinanceClient::apply_snapshot(uint32_t symbol_id, const char* data, size_t size) {
+    if(symbol_id >= feeds_.size() || !parse_depth_update(data, size, *depth_)) return false;
+    SymbolFeed& feed = *feeds_[symbol_id];
+
+    // Все update id между последним примененным и снапшотом до нас не дошли
+    uint64_t snapshot_id = depth_->final_update_id;
+    if(feed.last_applied_id && snapshot_id > feed.last_applied_id) {
+        uint64_t lost = snapshot_id - feed.last_applied_id;
+        feed.stats.updates_lost += lost;
+        updates_lost_ += lost;
+    }
+    feed.last_applied_id = snapshot_id;
+
+    feed.book.apply_snapshot(*depth_);
+    ++feed.stats.snapshots;
+    replay_buffered(symbol_id);
+    return true;
+}
+
+void BinanceClient::buffer_update(SymbolFeed& feed, const char* data, size_t size, uint64_t recv_time_ns) {
+    if(feed.buffered.size() >= MAX_BUFFERED_UPDATES) {
+        feed.buffered.pop_front();
+        ++feed.stats.unsynced_dropped;
+    }
+    feed.buffered.push_back({std::string(data, size), recv_time_ns});
+}
+
+void BinanceClient::replay_buffered(uint32_t symbol_id) {
+    SymbolFeed& feed = *feeds_[symbol_id];
+    // Stale отбрасывает u <= lastUpdateId, первое примененное проверяется на U <= lastUpdateId + 1.
+    // После разрыва (новый запрос снапшота) остаток по порядку возвращается в буфер.
+    std::deque<BufferedUpdate> pending;
+    pending.swap(feed.buffered);
+    for(BufferedUpdate& update : pending) {
+        if(!feed.book.is_synced()) {
+            feed.buffered.push_back(std::move(update));
+            continue;
+        }
+        process_depth(symbol_id, update.payload.data(), update.payload.size(), update.recv_time_ns);
+    }
+}
+
+void BinanceClient::request_snapshot(uint32_t symbol_id) {
+    SymbolFeed& feed = *feeds_[symbol_id];
+    feed.book.reset();
+    // При воспроизведении снапшоты берутся из самого захвата
+    if(!live_ || feed.snapshot_queued) return;
+
+    feed.snapshot_queued = true;
+    snapshot_queue_.push_back(symbol_id);
+    if(!snapshot_in_flight_) start_next_snapshot();
+}
+
+void BinanceClient::start_next_snapshot() {
+    if(snapshot_queue_.empty()) return;
+    uint32_t symbol_id = snapshot_queue_.front();
+    snapshot_queue_.pop_front();
+    snapshot_in_flight_ = true;
+
+    snapshot_request_ = {};
+    snapshot_request_.method(http::verb::get);
+    snapshot_request_.target("/api/v3/depth?symbol=" + feeds_[symbol_id]->rest_symbol + "&limit=1000");
+    snapshot_request_.version(11);
+    snapshot_request_.set(http::field::host, transport_.rest_host);
+    snapshot_response_ = {};
+    rest_buffer_.consume(rest_buffer_.size());
+
+    auto on_fail = [this, symbol_id](beast::error_code ec, const std::string& msg) {
+        std::cerr << "Snapshot request error for " << feeds_[symbol_id]->symbol
+                  << " (" << msg << "): " << ec.message() << std::endl;
+        on_snapshot_done(symbol_id, false);
+    };
+
+    rest_stream_ = std::make_unique<TlsStream>(strand_, ssl_ctx_);
+    prepare_tls(*rest_stream_, transport_.rest_host, rest_session_);
+    beast::tcp_stream& tcp_stream = beast::get_lowest_layer(*rest_stream_);
+    tcp_stream.expires_after(std::chrono::seconds(10));
+
+    rest_resolver_.async_resolve(transport_.rest_host, transport_.rest_port,
+        [this, on_fail, symbol_id, &tcp_stream](beast::error_code ec, tcp::resolver::results_type results) {
+            if(ec) return on_fail(ec, "resolve");
+
+            async_connect_endpoints(tcp_stream, results, results.begin(),
+                [this, on_fail, symbol_id](beast::error_code ec) {
+                    if(ec) return on_fail(ec, "connect");
+
+                    rest_stream_->async_handshake(ssl::stream_base::client,
+                        [this, on_fail, symbol_id](beast::error_code ec) {
+                            if(ec) return on_fail(ec, "tls handshake");
+
+                            http::async_write(*rest_stream_, snapshot_request_,
+                                [this, on_fail, symbol_id](beast::error_code ec, std::size_t) {
+                                    if(ec) return on_fail(ec, "write");
+
+                                    http::async_read(*rest_stream_, rest_buffer_, snapshot_response_,
+                                        [this, on_fail, symbol_id](beast::error_code ec, std::size_t) {
+                                            if(ec) return on_fail(ec, "read");
+
+                                            SymbolFeed& feed = *feeds_[symbol_id];
+                                            const std::string& body = snapshot_response_.body();
+                                            if(capture_) {
+                                                capture_->record(feed.symbol.c_str(), body.data(), body.size(),
+                                                                 utils::wall_clock_ns(), CAPTURE_FLAG_SNAPSHOT);
+                                            }
+                                            bool ok = snapshot_response_.result() == http::status::ok &&
+                                                      apply_snapshot(symbol_id, body.data(), body.size());
+                                            if(!ok) {
+                                                std::cerr << "Invalid depth snapshot for " << feed.symbol << std::endl;
+                                            }
+                                            on_snapshot_done(symbol_id, ok);
+                                        });
+                                });
+                        });
+                });
+        });
+}
+
+void BinanceClient::on_snapshot_done(uint32_t symbol_id, bool ok) {
+    // Без TLS close_notify: соединение одноразовое, ждать ответ сервера незачем
+    TlsSessionCache::mark_closed(rest_stream_->native_handle());
+    beast::error_code close_ec;
+    beast::get_lowest_layer(*rest_stream_).socket().shutdown(tcp::socket::shutdown_both, close_ec);
+    beast::get_lowest_layer(*rest_stream_).close();
+
+    if(ok) {
+        SymbolFeed& feed = *feeds_[symbol_id];
+        feed.snapshot_queued = false;
+        snapshot_retry_attempt_ = 0;
+        snapshot_in_flight_ = false;
+        // Разрыв при воспроизведении буфера (снапшот старше первого сохраненного diff)
+        // запросил снапшот, пока флаг еще стоял, и в очередь ничего не попало
+        if(!feed.book.is_synced()) {
+            request_snapshot(symbol_id);
+        } else {
+            start_next_snapshot();
+        }
+        return;
+    }
+
+    // Повтор с той же экспоненциальной задержкой, символ остается первым в очереди.
+    // На время ожидания очередь считается занятой, чтобы новые запросы не обходили задержку.
+    snapshot_queue_.push_front(symbol_id);
+    snapshot_retry_timer_.expires_after(next_backoff(snapshot_retry_attempt_++));
+    snapshot_retry_timer_.async_wait([this](beast::error_code ec) {
+        if(ec) return;
+        snapshot_in_flight_ = false;
+        start_next_snapshot();
+    });
+}
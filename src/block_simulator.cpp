@@ -0,0 +1,242 @@
+#include "block_simulator.hpp"
+#include "column_file.hpp"
+#include "quote_batch.hpp"
+#include "quote_engine.hpp"
+#include "rng.hpp"
+#include "rolling_volatility.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr size_t SCHEDULE_BATCH = 4096;      // Слотов на порцию случайных чисел расписания
+constexpr double BASE_FEE_MAX_CHANGE = 0.125;  // EIP-1559: за блок не больше чем на 1/8
+constexpr uint64_t TAPE_STREAM = 1;
+
+// Сторона, закрытая пределом инвентаря, не котируется
+struct OnchainQuote {
+    double ask;
+    double bid;
+    double reference;  // Цена блока подписи
+    bool has_ask;
+    bool has_bid;
+};
+
+} // namespace
+
+BlockSchedule::BlockSchedule(uint64_t start_ns, uint64_t end_ns, Config config) : config_(config) {
+    const uint64_t slot_ns = static_cast<uint64_t>(std::llround(config_.slot_sec * 1e9));
+    if (slot_ns == 0 || end_ns <= start_ns) return;
+    const uint64_t slots = (end_ns - start_ns + slot_ns - 1) / slot_ns;
+    time_ns_.reserve(slots);
+    base_fee_gwei_.reserve(slots);
+
+    Rng rng(config_.seed, 0);
+    std::vector<double> missed(SCHEDULE_BATCH);
+    std::vector<double> fullness(SCHEDULE_BATCH);
+    double base_fee = config_.base_fee_gwei;
+    for (uint64_t first = 0; first < slots; first += SCHEDULE_BATCH) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(SCHEDULE_BATCH, slots - first));
+        rng.fill_uniform(missed.data(), n);
+        rng.fill_uniform(fullness.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            if (missed[i] < config_.missed_slot_prob) continue;
+            time_ns_.push_back(start_ns + (first + i) * slot_ns);
+            base_fee_gwei_.push_back(base_fee);
+
+            // Base fee следующего блока: 1/8 отклонения заполнения от целевого. Без возврата
+            // спроса мультипликативное блуждание за месяцы уходит к минимуму.
+            double demand = config_.demand_reversion * std::log(config_.base_fee_gwei / base_fee);
+            double used = std::clamp(1.0 + config_.fullness_spread * (2.0 * fullness[i] - 1.0) + demand, 0.0, 2.0);
+            base_fee = std::max(config_.min_base_fee_gwei, base_fee * (1.0 + BASE_FEE_MAX_CHANGE * (used - 1.0)));
+        }
+    }
+}
+
+BlockTape::BlockTape(const BlockSchedule& schedule, const uint64_t* tick_ns, const double* tick_price,
+                     size_t ticks, Config config)
+    : schedule_(schedule),
+      price_(schedule.blocks()),
+      sigma_(schedule.blocks()),
+      inclusion_(schedule.blocks()),
+      ask_flow_(schedule.blocks()),
+      bid_flow_(schedule.blocks()) {
+    const size_t blocks = schedule.blocks();
+    if (blocks == 0) return;
+
+    // Слияние тиков с моментами блоков за один проход
+    const uint64_t* block_ns = schedule.time_ns();
+    double last = ticks > 0 ? tick_price[0] : 0.0;
+    size_t tick = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        while (tick < ticks && tick_ns[tick] <= block_ns[b]) last = tick_price[tick++];
+        price_[b] = last;
+    }
+
+    RollingVolatility volatility({RollingVolatility::Horizon::rolling(std::max<size_t>(config.vol_window, 2))});
+    for (size_t b = 0; b < blocks; ++b) {
+        volatility.update(price_[b]);
+        sigma_[b] = std::max(volatility.volatility(), config.min_sigma);
+    }
+
+    Rng rng(config.seed, TAPE_STREAM);
+    rng.fill_uniform(inclusion_.data(), blocks);
+    rng.fill_uniform(ask_flow_.data(), blocks);
+    rng.fill_uniform(bid_flow_.data(), blocks);
+    // -ln U; U = 0 дало бы бесконечность — сделка потока гарантирована, что и нужно
+    batch_log(ask_flow_.data(), ask_flow_.data(), blocks);
+    batch_log(bid_flow_.data(), bid_flow_.data(), blocks);
+    for (size_t b = 0; b < blocks; ++b) {
+        ask_flow_[b] = -ask_flow_[b];
+        bid_flow_[b] = -bid_flow_[b];
+    }
+}
+
+OnchainResult simulate_onchain_run(const OnchainParams& params, const BlockTape& tape) {
+    QuoteEngine engine(params.gamma, params.T, params.min_spread);
+    const double* price = tape.price();
+    const double* sigma = tape.sigma();
+    const double* base_fee = tape.schedule().base_fee_gwei();
+    const double* inclusion = tape.inclusion_draw();
+    const double* ask_flow = tape.ask_flow_draw();
+    const double* bid_flow = tape.bid_flow_draw();
+
+    // Сделка потока: flow_decay·δ/S < ln(flow_rate) + E
+    const double log_flow_rate = params.flow_rate > 0 ? std::log(params.flow_rate) : -INFINITY;
+    const double full_tip_probability = params.tip_gwei / (params.tip_gwei + params.inclusion_tip_gwei);
+
+    OnchainResult result{};
+    OnchainQuote live{};
+    OnchainQuote pending{};
+    bool has_pending = false;
+    size_t signed_block = 0;
+    double max_fee = 0.0;
+
+    double cash = 0.0;
+    double inventory = 0.0;
+    double equity = 0.0;
+    double peak = 0.0;
+    double inclusion_blocks = 0.0;
+    double drift = 0.0;
+
+    for (size_t b = 0; b < tape.blocks(); ++b) {
+        const double S = price[b];
+
+        // Включение ожидающей транзакции в этот блок: котировка заменяет живую
+        if (has_pending) {
+            if (b - signed_block > params.ttl_blocks) {
+                has_pending = false;
+                ++result.txs_expired;
+            } else {
+                double tip = std::min(params.tip_gwei, max_fee - base_fee[b]);
+                double probability = tip >= params.tip_gwei ? full_tip_probability
+                                   : tip > 0 ? tip / (tip + params.inclusion_tip_gwei)
+                                   : 0.0;
+                if (inclusion[b] < probability) {
+                    live = pending;
+                    has_pending = false;
+                    ++result.txs_included;
+                    inclusion_blocks += static_cast<double>(b - signed_block);
+                    drift += std::fabs(S / pending.reference - 1.0);
+                    double gas = QuoteEngine::gas_cost((base_fee[b] + tip) * 1e9, 1.0) * S;
+                    cash -= gas;
+                    result.gas_paid += gas;
+                }
+            }
+        }
+
+        // Исполнение на границе блока: арбитраж, если цена пересекла котировку, иначе поток
+        if (live.has_ask) {
+            bool arbitrage = S >= live.ask;
+            if (arbitrage || params.flow_decay * (live.ask - S) / S < log_flow_rate + ask_flow[b]) {
+                inventory -= params.trade_size;
+                cash += live.ask * params.trade_size;
+                live.has_ask = false;
+                ++result.fills;
+                if (arbitrage) ++result.arbitrage_fills;
+            }
+        }
+        if (live.has_bid) {
+            bool arbitrage = S <= live.bid;
+            if (arbitrage || params.flow_decay * (S - live.bid) / S < log_flow_rate + bid_flow[b]) {
+                inventory += params.trade_size;
+                cash -= live.bid * params.trade_size;
+                live.has_bid = false;
+                ++result.fills;
+                if (arbitrage) ++result.arbitrage_fills;
+            }
+        }
+
+        equity = cash + inventory * S;
+        peak = std::max(peak, equity);
+        result.max_drawdown = std::max(result.max_drawdown, peak - equity);
+
+        // Решение по цене блока: новая транзакция, если стороны не те, что нужны при текущем
+        // инвентаре, или цена ушла от опорной. Ожидающая транзакция заменяется (тот же nonce).
+        if (S <= 0) continue;
+        const OnchainQuote& latest = has_pending ? pending : live;
+        bool want_ask = inventory - params.trade_size >= -params.max_inventory;
+        bool want_bid = inventory + params.trade_size <= params.max_inventory;
+        bool requote = want_ask != latest.has_ask || want_bid != latest.has_bid ||
+                       std::fabs(S / latest.reference - 1.0) > params.requote;
+        if (!requote || !(want_ask || want_bid)) continue;
+
+        engine.spreads(S, sigma[b] * S, params.flow_decay / S, inventory, pending.ask, pending.bid);
+        pending.reference = S;
+        pending.has_ask = want_ask;
+        pending.has_bid = want_bid;
+        has_pending = true;
+        signed_block = b;
+        max_fee = base_fee[b] * params.max_fee_multiplier;
+        ++result.txs_signed;
+    }
+
+    result.pnl = equity;
+    result.final_inventory = inventory;
+    if (result.txs_included > 0) {
+        result.mean_inclusion_blocks = inclusion_blocks / static_cast<double>(result.txs_included);
+        result.mean_drift = drift / static_cast<double>(result.txs_included);
+    }
+    return result;
+}
+
+std::vector<OnchainResult> run_onchain_sweep(const std::vector<OnchainParams>& params, const BlockTape& tape,
+                                             WorkStealingPool* pool) {
+    std::vector<OnchainResult> results(params.size());
+    if (pool) {
+        pool->parallel_for(params.size(), [&](size_t i, size_t) { results[i] = simulate_onchain_run(params[i], tape); });
+    } else {
+        for (size_t i = 0; i < params.size(); ++i) results[i] = simulate_onchain_run(params[i], tape);
+    }
+    return results;
+}
+
+bool write_onchain_results(const std::string& path, const std::vector<OnchainParams>& params,
+                           const std::vector<OnchainResult>& results) {
+    ColumnWriter writer(path, {{"combo", ColumnType::U64},
+                               {"gamma", ColumnType::F64},
+                               {"min_spread", ColumnType::F64},
+                               {"requote", ColumnType::F64},
+                               {"tip_gwei", ColumnType::F64},
+                               {"ttl_blocks", ColumnType::U64},
+                               {"pnl", ColumnType::F64},
+                               {"gas_paid", ColumnType::F64},
+                               {"max_drawdown", ColumnType::F64},
+                               {"final_inventory", ColumnType::F64},
+                               {"fills", ColumnType::U64},
+                               {"arbitrage_fills", ColumnType::U64},
+                               {"txs_signed", ColumnType::U64},
+                               {"txs_included", ColumnType::U64},
+                               {"txs_expired", ColumnType::U64},
+                               {"mean_inclusion_blocks", ColumnType::F64},
+                               {"mean_drift", ColumnType::F64}});
+    if (!writer.is_open()) return false;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const OnchainParams& p = params[i];
+        const OnchainResult& r = results[i];
+        writer.append({uint64_t(i), p.gamma, p.min_spread, p.requote, p.tip_gwei, uint64_t(p.ttl_blocks), r.pnl,
+                       r.gas_paid, r.max_drawdown, r.final_inventory, r.fills, r.arbitrage_fills, r.txs_signed,
+                       r.txs_included, r.txs_expired, r.mean_inclusion_blocks, r.mean_drift});
+    }
+    return writer.close();
+}
@@ -0,0 +1,224 @@
+#include "block_simulator.hpp"
+#include "history_store.hpp"
+#include "path_generator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Onchain-котирование по блокам на тиках из кэша истории (history_import) или на
+// синтетическом пути с шагом в секунду. Расписание блоков и лента цен строятся один раз,
+// сетка параметров прогоняется параллельно; результаты — в колоночный файл.
+//   block_simulator [--history=DIR --symbol=ETHUSDT [--trades] [--from=DATE] [--to=DATE]]
+//                   [--days=90] [--vol=0.0001] [--slot=12] [--missed=0.01] [--base-fee=20]
+//                   [--gamma=LIST] [--min-spread=LIST] [--requote=LIST] [--tip=LIST] [--ttl=LIST]
+//                   [--seed=42] [--threads=0] [--pin] [--out=onchain.mmcol]
+
+namespace {
+
+constexpr uint64_t NS_PER_SEC = 1000000000ull;
+
+bool parse_list(const std::string& text, std::vector<double>& out) {
+    out.clear();
+    std::stringstream list(text);
+    std::string value;
+    while (std::getline(list, value, ',')) {
+        if (!value.empty()) out.push_back(std::atof(value.c_str()));
+    }
+    return !out.empty();
+}
+
+void print_usage() {
+    std::cerr << "Usage: block_simulator [options]\n"
+              << "  --history=DIR --symbol=SYMBOL   ticks from the history cache (default: synthetic path)\n"
+              << "  --trades                        history trades instead of klines\n"
+              << "  --from=YYYY-MM-DD --to=YYYY-MM-DD   history days (inclusive)\n"
+              << "  --days=N --vol=X                synthetic path: N days of 1 s ticks, X = return stddev per tick\n"
+              << "  --slot=SEC --missed=P --base-fee=GWEI   block schedule\n"
+              << "  --gamma=LIST --min-spread=LIST --requote=LIST --tip=LIST --ttl=LIST\n"
+              << "                                  comma-separated parameter grid\n"
+              << "  --seed=N                        schedule, synthetic path and block draws\n"
+              << "  --threads=N --pin               worker threads (0 = all cores), pin worker i to core i\n"
+              << "  --out=FILE                      columnar results (default onchain.mmcol)" << std::endl;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string history, symbol, from, to;
+    bool trades = false;
+    double days = 90.0;
+    double vol = 0.0001;
+    std::vector<double> gamma{0.1};
+    std::vector<double> min_spread{0.0005, 0.001, 0.002};
+    std::vector<double> requote{0.0005, 0.001};
+    std::vector<double> tip{0.5, 2.0};
+    std::vector<double> ttl{3.0, 10.0};
+    BlockSchedule::Config schedule_config;
+    BlockTape::Config tape_config;
+    size_t threads = 0;
+    bool pin = false;
+    std::string out = "onchain.mmcol";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg.rfind("--history=", 0) == 0) {
+            history = arg.substr(10);
+        } else if (arg.rfind("--symbol=", 0) == 0) {
+            symbol = arg.substr(9);
+        } else if (arg == "--trades") {
+            trades = true;
+        } else if (arg.rfind("--from=", 0) == 0) {
+            from = arg.substr(7);
+        } else if (arg.rfind("--to=", 0) == 0) {
+            to = arg.substr(5);
+        } else if (arg.rfind("--days=", 0) == 0) {
+            days = std::atof(arg.c_str() + 7);
+        } else if (arg.rfind("--vol=", 0) == 0) {
+            vol = std::atof(arg.c_str() + 6);
+        } else if (arg.rfind("--slot=", 0) == 0) {
+            schedule_config.slot_sec = std::atof(arg.c_str() + 7);
+        } else if (arg.rfind("--missed=", 0) == 0) {
+            schedule_config.missed_slot_prob = std::atof(arg.c_str() + 9);
+        } else if (arg.rfind("--base-fee=", 0) == 0) {
+            schedule_config.base_fee_gwei = std::atof(arg.c_str() + 11);
+        } else if (arg.rfind("--gamma=", 0) == 0) {
+            ok = parse_list(arg.substr(8), gamma);
+        } else if (arg.rfind("--min-spread=", 0) == 0) {
+            ok = parse_list(arg.substr(13), min_spread);
+        } else if (arg.rfind("--requote=", 0) == 0) {
+            ok = parse_list(arg.substr(10), requote);
+        } else if (arg.rfind("--tip=", 0) == 0) {
+            ok = parse_list(arg.substr(6), tip);
+        } else if (arg.rfind("--ttl=", 0) == 0) {
+            ok = parse_list(arg.substr(6), ttl);
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            schedule_config.seed = std::strtoull(arg.c_str() + 7, nullptr, 10);
+            tape_config.seed = schedule_config.seed;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = std::strtoull(arg.c_str() + 10, nullptr, 10);
+        } else if (arg == "--pin") {
+            pin = true;
+        } else if (arg.rfind("--out=", 0) == 0) {
+            out = arg.substr(6);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            print_usage();
+            return 1;
+        }
+    }
+    if (!history.empty() && symbol.empty()) {
+        std::cerr << "--history needs --symbol" << std::endl;
+        return 1;
+    }
+    if (schedule_config.slot_sec <= 0 || (history.empty() && days <= 0)) {
+        print_usage();
+        return 1;
+    }
+
+    // Тики: время и цена отдельными массивами
+    std::vector<uint64_t> tick_ns;
+    std::vector<double> tick_price;
+    auto start = std::chrono::steady_clock::now();
+    if (!history.empty()) {
+        HistoryStore store(history);
+        bool loaded;
+        if (trades) {
+            std::vector<Trade> loaded_trades;
+            loaded = store.load_trades(symbol, from, to, loaded_trades);
+            for (const Trade& t : loaded_trades) {
+                tick_ns.push_back(t.time_ns);
+                tick_price.push_back(t.price);
+            }
+        } else {
+            // Свеча — open в момент открытия и close в конце интервала
+            std::vector<Kline> klines;
+            loaded = store.load_klines(symbol, from, to, klines);
+            uint64_t interval = klines.size() > 1 ? klines[1].open_time_ns - klines[0].open_time_ns : 60 * NS_PER_SEC;
+            for (const Kline& k : klines) {
+                tick_ns.push_back(k.open_time_ns);
+                tick_price.push_back(k.open);
+                tick_ns.push_back(k.open_time_ns + interval - 1);
+                tick_price.push_back(k.close);
+            }
+        }
+        if (!loaded) {
+            std::cerr << "No cached " << (trades ? "trades" : "klines") << " for " << symbol << " in " << history
+                      << std::endl;
+            return 1;
+        }
+    } else {
+        PathConfig path_config;
+        path_config.steps = static_cast<size_t>(days * 86400.0);
+        path_config.step_vol = vol;
+        path_config.seed = schedule_config.seed;
+        tick_price.resize(path_config.steps);
+        PathGenerator(path_config).generate(0, 1, tick_price.data());
+        tick_ns.resize(tick_price.size());
+        for (size_t i = 0; i < tick_ns.size(); ++i) tick_ns[i] = i * NS_PER_SEC;
+    }
+    if (tick_ns.empty()) {
+        std::cerr << "No ticks" << std::endl;
+        return 1;
+    }
+    double load_sec = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    BlockSchedule schedule(tick_ns.front(), tick_ns.back() + 1, schedule_config);
+    BlockTape tape(schedule, tick_ns.data(), tick_price.data(), tick_ns.size(), tape_config);
+    double build_sec = seconds_since(start);
+
+    std::vector<OnchainParams> params;
+    for (double g : gamma)
+        for (double s : min_spread)
+            for (double r : requote)
+                for (double t : tip)
+                    for (double l : ttl) {
+                        OnchainParams p;
+                        p.gamma = g;
+                        p.min_spread = s;
+                        p.requote = r;
+                        p.tip_gwei = t;
+                        p.ttl_blocks = static_cast<uint32_t>(l);
+                        params.push_back(p);
+                    }
+
+    WorkStealingPool pool(threads, pin);
+    start = std::chrono::steady_clock::now();
+    std::vector<OnchainResult> results = run_onchain_sweep(params, tape, &pool);
+    double run_sec = seconds_since(start);
+    if (!write_onchain_results(out, params, results)) return 1;
+
+    double span_days = static_cast<double>(tick_ns.back() - tick_ns.front()) / NS_PER_SEC / 86400.0;
+    std::cout << "Ticks: " << tick_ns.size() << " over " << span_days << " days, loaded in " << load_sec << " s"
+              << std::endl;
+    std::cout << "Blocks: " << tape.blocks() << ", schedule and tape built in " << build_sec << " s" << std::endl;
+    std::cout << "Runs: " << params.size() << " parameter sets on " << pool.size() << " threads in " << run_sec
+              << " s (" << params.size() * tape.blocks() / run_sec / 1e6 << " M blocks/s)" << std::endl;
+
+    // Лучшие наборы по PnL
+    std::vector<std::pair<double, size_t>> ranking;
+    for (size_t i = 0; i < results.size(); ++i) ranking.emplace_back(results[i].pnl, i);
+    std::sort(ranking.rbegin(), ranking.rend());
+    for (size_t i = 0; i < std::min<size_t>(5, ranking.size()); ++i) {
+        const OnchainParams& p = params[ranking[i].second];
+        const OnchainResult& r = results[ranking[i].second];
+        std::cout << "  min spread " << p.min_spread << ", requote " << p.requote << ", tip " << p.tip_gwei
+                  << " gwei, ttl " << p.ttl_blocks << ": PnL " << r.pnl << ", gas " << r.gas_paid << ", fills "
+                  << r.fills << " (" << r.arbitrage_fills << " arbitrage), included " << r.txs_included << "/"
+                  << r.txs_signed << " after " << r.mean_inclusion_blocks << " blocks, drift "
+                  << r.mean_drift * 1e4 << " bps" << std::endl;
+    }
+    std::cout << "Results: " << out << " (" << results.size() << " rows)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,218 @@
+#include "capture_log.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+} // namespace
+
+CaptureWriter::CaptureWriter(const std::string& base_path, size_t ring_bytes, size_t file_bytes)
+    : base_path_(base_path),
+      file_bytes_(file_bytes),
+      ring_mask_(round_up_pow2(ring_bytes) - 1),
+      ring_(new char[ring_mask_ + 1]) {
+    // Прогреваем страницы буфера, чтобы первые записи не ловили page fault
+    std::memset(ring_.get(), 0, ring_mask_ + 1);
+}
+
+CaptureWriter::~CaptureWriter() {
+    stop();
+}
+
+bool CaptureWriter::start() {
+    if (running_) return true;
+    if (!open_segment(current_) || !open_segment(next_)) {
+        close_segment(current_);
+        close_segment(next_);
+        return false;
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread(&CaptureWriter::writer_loop, this);
+    return true;
+}
+
+void CaptureWriter::stop() {
+    if (!running_.exchange(false)) return;
+    if (writer_thread_.joinable()) writer_thread_.join();
+
+    drain();
+    close_segment(current_);
+
+    // Заранее подготовленный файл не понадобился
+    std::string unused_path = next_.path;
+    close_segment(next_);
+    std::remove(unused_path.c_str());
+}
+
+bool CaptureWriter::record(const char* symbol, const char* data, size_t size, uint64_t recv_time_ns,
+                           uint32_t flags) {
+    size_t total = capture_record_size(size);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+
+    if (total > file_bytes_ - sizeof(CaptureFileHeader) || head + total - tail > ring_mask_ + 1) {
+        records_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    CaptureRecordHeader header{};
+    header.recv_time_ns = recv_time_ns;
+    header.payload_size = static_cast<uint32_t>(size);
+    header.flags = flags;
+    std::strncpy(header.symbol, symbol, sizeof(header.symbol) - 1);
+
+    copy_to_ring(head, &header, sizeof(header));
+    copy_to_ring(head + sizeof(header), data, size);
+    head_.store(head + total, std::memory_order_release);
+    return true;
+}
+
+CaptureWriter::Stats CaptureWriter::stats() const {
+    return {
+        records_written_.load(std::memory_order_relaxed),
+        bytes_written_.load(std::memory_order_relaxed),
+        records_dropped_.load(std::memory_order_relaxed),
+        files_rotated_.load(std::memory_order_relaxed)
+    };
+}
+
+void CaptureWriter::copy_to_ring(uint64_t pos, const void* src, size_t size) {
+    size_t offset = pos & ring_mask_;
+    size_t first = std::min(size, ring_mask_ + 1 - offset);
+    std::memcpy(ring_.get() + offset, src, first);
+    std::memcpy(ring_.get(), static_cast<const char*>(src) + first, size - first);
+}
+
+void CaptureWriter::copy_from_ring(uint64_t pos, void* dst, size_t size) const {
+    size_t offset = pos & ring_mask_;
+    size_t first = std::min(size, ring_mask_ + 1 - offset);
+    std::memcpy(dst, ring_.get() + offset, first);
+    std::memcpy(static_cast<char*>(dst) + first, ring_.get(), size - first);
+}
+
+void CaptureWriter::writer_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+size_t CaptureWriter::drain() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    uint64_t head = head_.load(std::memory_order_acquire);
+    size_t drained = 0;
+
+    while (tail < head) {
+        CaptureRecordHeader header;
+        copy_from_ring(tail, &header, sizeof(header));
+        size_t total = capture_record_size(header.payload_size);
+
+        bool fits = current_.data && current_.used + total <= file_bytes_;
+        if (!fits) fits = rotate();
+
+        if (!fits) {
+            // Не удалось открыть новый файл: записи теряются, но производитель не блокируется
+            records_dropped_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            copy_from_ring(tail, current_.data + current_.used, total);
+            current_.used += total;
+            records_written_.fetch_add(1, std::memory_order_relaxed);
+            bytes_written_.fetch_add(total, std::memory_order_relaxed);
+        }
+
+        tail += total;
+        tail_.store(tail, std::memory_order_release);
+        ++drained;
+    }
+    return drained;
+}
+
+bool CaptureWriter::open_segment(Segment& segment) {
+    // Существующие файлы (прошлый запуск с тем же префиксом) не перезаписываются:
+    // индекс пропускается, новая сессия продолжает нумерацию после них
+    for (;;) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%06llu.mdcap",
+                      static_cast<unsigned long long>(file_index_));
+        segment.path = base_path_ + suffix;
+
+        segment.fd = ::open(segment.path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (segment.fd >= 0 || errno != EEXIST) break;
+        ++file_index_;
+    }
+    if (segment.fd < 0) {
+        std::cerr << "Capture: cannot open " << segment.path << std::endl;
+        return false;
+    }
+    if (::ftruncate(segment.fd, static_cast<off_t>(file_bytes_)) != 0) {
+        std::cerr << "Capture: cannot allocate " << segment.path << std::endl;
+        ::close(segment.fd);
+        segment.fd = -1;
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, file_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, segment.fd, 0);
+    if (data == MAP_FAILED) {
+        std::cerr << "Capture: cannot map " << segment.path << std::endl;
+        ::close(segment.fd);
+        segment.fd = -1;
+        return false;
+    }
+    segment.data = static_cast<char*>(data);
+
+    CaptureFileHeader header{};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.header_size = sizeof(CaptureFileHeader);
+    header.created_ns = utils::wall_clock_ns();
+    std::memcpy(segment.data, &header, sizeof(header));
+    segment.used = sizeof(header);
+
+    ++file_index_;
+    return true;
+}
+
+void CaptureWriter::close_segment(Segment& segment) {
+    if (segment.data) {
+        ::munmap(segment.data, file_bytes_);
+    }
+    if (segment.fd >= 0) {
+        // Отрезаем незаполненный хвост, чтобы файл можно было читать целиком
+        if (::ftruncate(segment.fd, static_cast<off_t>(segment.used)) != 0) {
+            std::cerr << "Capture: cannot truncate " << segment.path << std::endl;
+        }
+        ::close(segment.fd);
+    }
+    segment = Segment{};
+}
+
+bool CaptureWriter::rotate() {
+    if (current_.data) {
+        close_segment(current_);
+        files_rotated_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (next_.fd < 0 && !open_segment(next_)) return false;
+    current_ = next_;
+    next_ = Segment{};
+
+    // Готовим следующий файл сразу, пока запас места в текущем большой
+    open_segment(next_);
+    return true;
+}
@@ -0,0 +1,143 @@
+#include "capture_replay.hpp"
+#include "binance_client.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+CaptureReader::CaptureReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Replay: cannot open " << path << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CaptureFileHeader)) {
+        std::cerr << "Replay: empty or unreadable capture " << path << std::endl;
+        ::close(fd);
+        return;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Replay: cannot map " << path << std::endl;
+        return;
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    ::madvise(data, size, MADV_WILLNEED);
+
+    CaptureFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CAPTURE_VERSION || header.header_size > size) {
+        std::cerr << "Replay: not a capture file " << path << std::endl;
+        ::munmap(data, size);
+        return;
+    }
+
+    data_ = static_cast<const char*>(data);
+    size_ = size;
+    header_size_ = header.header_size;
+    offset_ = header_size_;
+}
+
+CaptureReader::~CaptureReader() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+}
+
+bool CaptureReader::next(const CaptureRecordHeader*& header, const char*& payload) {
+    if (!data_ || offset_ + sizeof(CaptureRecordHeader) > size_) return false;
+
+    header = reinterpret_cast<const CaptureRecordHeader*>(data_ + offset_);
+    size_t total = capture_record_size(header->payload_size);
+    if (offset_ + total > size_) return false;
+
+    payload = data_ + offset_ + sizeof(CaptureRecordHeader);
+    offset_ += total;
+    return true;
+}
+
+std::vector<std::string> CaptureReplay::symbols() const {
+    std::vector<std::string> result;
+    for (const auto& path : paths_) {
+        CaptureReader reader(path);
+        const CaptureRecordHeader* header;
+        const char* payload;
+        while (reader.next(header, payload)) {
+            std::string symbol(header->symbol, strnlen(header->symbol, sizeof(header->symbol)));
+            if (!symbol.empty() && std::find(result.begin(), result.end(), symbol) == result.end()) {
+                result.push_back(symbol);
+            }
+        }
+    }
+    return result;
+}
+
+CaptureReplay::CaptureReplay(std::vector<std::string> paths, Mode mode, double speed)
+    : paths_(std::move(paths)), mode_(mode), speed_(speed > 0 ? speed : 1.0) {}
+
+CaptureReplay::Stats CaptureReplay::run(const FrameHandler& handler) {
+    using clock = std::chrono::steady_clock;
+
+    Stats stats{0, 0, 0.0};
+    stopped_ = false;
+    auto start = clock::now();
+
+    for (const auto& path : paths_) {
+        CaptureReader reader(path);
+        const CaptureRecordHeader* header;
+        const char* payload;
+        // Темп отсчитывается от первой записи каждого файла: следующий файл может
+        // начинаться раньше конца предыдущего
+        auto file_start = clock::now();
+        uint64_t first_recv_ns = 0;
+        bool first_record = true;
+
+        while (!stopped_.load(std::memory_order_relaxed) && reader.next(header, payload)) {
+            if (mode_ == Mode::Paced) {
+                if (first_record) {
+                    first_recv_ns = header->recv_time_ns;
+                    first_record = false;
+                }
+
+                // recv_time_ns — системные часы: после шага NTP назад разность отрицательна,
+                // такие записи идут без ожидания
+                int64_t delta_ns = static_cast<int64_t>(header->recv_time_ns - first_recv_ns);
+                if (delta_ns < 0) delta_ns = 0;
+                auto target = file_start + std::chrono::nanoseconds(static_cast<int64_t>(delta_ns / speed_));
+                // Длинные паузы спим, последнюю миллисекунду досчитываем в цикле ради точности
+                auto now = clock::now();
+                if (target - now > std::chrono::milliseconds(2)) {
+                    std::this_thread::sleep_for(target - now - std::chrono::milliseconds(1));
+                }
+                while (clock::now() < target) {}
+            }
+
+            handler(*header, payload);
+            ++stats.messages;
+            stats.bytes += header->payload_size;
+        }
+    }
+
+    stats.elapsed_sec = std::chrono::duration<double>(clock::now() - start).count();
+    return stats;
+}
+
+CaptureReplay::Stats CaptureReplay::run(BinanceClient& client) {
+    return run([&client](const CaptureRecordHeader& header, const char* payload) {
+        if (header.flags & CAPTURE_FLAG_SNAPSHOT) {
+            int32_t symbol_id = client.find_symbol(header.symbol);
+            if (symbol_id >= 0) client.apply_snapshot(symbol_id, payload, header.payload_size);
+        } else {
+            client.process_message(payload, header.payload_size, header.recv_time_ns);
+        }
+    });
+}
@@ -0,0 +1,310 @@
+#include "column_file.hpp"
+#include "utils.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t WRITE_BUFFER_BYTES = 1 << 20;
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Значащих байт в x (0 для нуля)
+unsigned significant_bytes(uint64_t x) {
+    return x == 0 ? 0 : 8 - static_cast<unsigned>(__builtin_clzll(x)) / 8;
+}
+
+void encode_delta_of_delta(const uint64_t* values, size_t n, std::vector<uint8_t>& out) {
+    out.resize(n * 10);
+    uint8_t* p = out.data();
+    uint64_t previous = 0;
+    uint64_t delta = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t next = values[i] - previous;
+        uint64_t v = zigzag(static_cast<int64_t>(next - delta));
+        previous = values[i];
+        delta = next;
+        while (v >= 0x80) {
+            *p++ = static_cast<uint8_t>(v) | 0x80;
+            v >>= 7;
+        }
+        *p++ = static_cast<uint8_t>(v);
+    }
+    out.resize(p - out.data());
+}
+
+bool decode_delta_of_delta(const uint8_t* p, size_t bytes, size_t n, uint64_t* out) {
+    const uint8_t* end = p + bytes;
+    uint64_t previous = 0;
+    uint64_t delta = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t v = 0;
+        unsigned shift = 0;
+        while (true) {
+            if (p == end || shift > 63) return false;
+            uint8_t byte = *p++;
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+        delta += static_cast<uint64_t>(unzigzag(v));
+        previous += delta;
+        out[i] = previous;
+    }
+    return p == end;
+}
+
+// Полубайты длин ((n + 1) / 2 байт), затем младшие байты XOR подряд
+void encode_xor_bytes(const uint64_t* values, size_t n, std::vector<uint8_t>& out) {
+    size_t lengths = (n + 1) / 2;
+    out.assign(lengths + n * 8, 0);
+    uint8_t* nibbles = out.data();
+    uint8_t* p = out.data() + lengths;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t x = values[i] ^ previous;
+        previous = values[i];
+        unsigned count = significant_bytes(x);
+        nibbles[i / 2] |= static_cast<uint8_t>(count << ((i & 1) * 4));
+        std::memcpy(p, &x, 8);  // Little-endian: младшие count байт — значащие
+        p += count;
+    }
+    out.resize(p - out.data());
+}
+
+bool decode_xor_bytes(const uint8_t* data, size_t bytes, size_t n, uint64_t* out) {
+    size_t lengths = (n + 1) / 2;
+    if (bytes < lengths) return false;
+    const uint8_t* p = data + lengths;
+    const uint8_t* end = data + bytes;
+    uint64_t previous = 0;
+    for (size_t i = 0; i < n; ++i) {
+        unsigned count = (data[i / 2] >> ((i & 1) * 4)) & 0x0F;
+        if (count > 8 || static_cast<size_t>(end - p) < count) return false;
+        uint64_t x = 0;
+        std::memcpy(&x, p, count);
+        p += count;
+        previous ^= x;
+        out[i] = previous;
+    }
+    return p == end;
+}
+
+} // namespace
+
+ColumnWriter::ColumnWriter(const std::string& path, const std::vector<ColumnSpec>& columns, Config config)
+    : path_(path), config_(config) {
+    if (config_.chunk_rows == 0) config_.chunk_rows = 1;
+    for (const ColumnSpec& spec : columns) {
+        ColumnInfo info{};
+        std::strncpy(info.name, spec.name.c_str(), sizeof(info.name) - 1);
+        info.type = spec.type;
+        info.codec = !config_.compress ? ColumnCodec::Raw
+                   : spec.type == ColumnType::F64 ? ColumnCodec::XorBytes
+                   : ColumnCodec::DeltaOfDelta;
+        columns_.push_back(info);
+        buffers_.emplace_back(config_.chunk_rows);
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Cannot create column file " << path << std::endl;
+        return;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, WRITE_BUFFER_BYTES);
+
+    ColumnFileHeader header{};
+    std::memcpy(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic));
+    header.version = COLUMN_FILE_VERSION;
+    header.columns = static_cast<uint32_t>(columns_.size());
+    header.created_ns = utils::wall_clock_ns();
+    write(&header, sizeof(header));
+    write(columns_.data(), columns_.size() * sizeof(ColumnInfo));
+}
+
+ColumnWriter::~ColumnWriter() {
+    if (file_) close();
+}
+
+void ColumnWriter::write(const void* data, size_t bytes) {
+    if (bytes == 0) return;
+    if (std::fwrite(data, 1, bytes, file_) != bytes) failed_ = true;
+    offset_ += bytes;
+}
+
+void ColumnWriter::pad_to_alignment() {
+    static const char padding[COLUMN_ALIGNMENT] = {};
+    size_t pad = (COLUMN_ALIGNMENT - offset_ % COLUMN_ALIGNMENT) % COLUMN_ALIGNMENT;
+    write(padding, pad);
+}
+
+void ColumnWriter::flush_chunk() {
+    const size_t rows = filled_;
+    filled_ = 0;
+    if (rows == 0 || !file_) return;
+
+    for (size_t c = 0; c < columns_.size(); ++c) {
+        const uint64_t* values = buffers_[c].data();
+        const size_t raw_bytes = rows * sizeof(uint64_t);
+        ColumnCodec codec = columns_[c].codec;
+        if (codec == ColumnCodec::DeltaOfDelta) {
+            encode_delta_of_delta(values, rows, encoded_);
+        } else if (codec == ColumnCodec::XorBytes) {
+            encode_xor_bytes(values, rows, encoded_);
+        }
+        if (codec != ColumnCodec::Raw && encoded_.size() >= raw_bytes) codec = ColumnCodec::Raw;
+
+        pad_to_alignment();
+        ColumnChunk chunk{};
+        chunk.offset = offset_;
+        chunk.rows = static_cast<uint32_t>(rows);
+        chunk.codec = codec;
+        if (codec == ColumnCodec::Raw) {
+            chunk.bytes = raw_bytes;
+            write(values, raw_bytes);
+        } else {
+            chunk.bytes = encoded_.size();
+            write(encoded_.data(), encoded_.size());
+        }
+        index_.push_back(chunk);
+        stats_.raw_bytes += raw_bytes;
+    }
+    stats_.rows += rows;
+    ++stats_.chunks;
+}
+
+bool ColumnWriter::close() {
+    if (!file_) return false;
+    flush_chunk();
+
+    pad_to_alignment();
+    ColumnFileFooter footer{};
+    footer.index_offset = offset_;
+    footer.chunks = stats_.chunks;
+    footer.rows = stats_.rows;
+    std::memcpy(footer.magic, COLUMN_FILE_MAGIC, sizeof(footer.magic));
+    write(index_.data(), index_.size() * sizeof(ColumnChunk));
+    write(&footer, sizeof(footer));
+    stats_.file_bytes = offset_;
+
+    bool ok = std::fclose(file_) == 0 && !failed_;
+    file_ = nullptr;
+    if (!ok) std::cerr << "Failed to write column file " << path_ << std::endl;
+    return ok;
+}
+
+ColumnReader::ColumnReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Cannot open column file " << path << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        static_cast<size_t>(st.st_size) < sizeof(ColumnFileHeader) + sizeof(ColumnFileFooter)) {
+        std::cerr << "Empty or unreadable column file " << path << std::endl;
+        ::close(fd);
+        return;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Cannot map column file " << path << std::endl;
+        return;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    ColumnFileHeader header;
+    ColumnFileFooter footer;
+    std::memcpy(&header, bytes, sizeof(header));
+    std::memcpy(&footer, bytes + size - sizeof(footer), sizeof(footer));
+    size_t info_end = sizeof(header) + static_cast<size_t>(header.columns) * sizeof(ColumnInfo);
+    bool valid = std::memcmp(header.magic, COLUMN_FILE_MAGIC, sizeof(header.magic)) == 0 &&
+                 header.version == COLUMN_FILE_VERSION && info_end <= size;
+    if (!valid) {
+        std::cerr << "Not a column file: " << path << std::endl;
+        ::munmap(data, size);
+        return;
+    }
+    // Индекс должен точно заканчиваться перед футером
+    valid = std::memcmp(footer.magic, COLUMN_FILE_MAGIC, sizeof(footer.magic)) == 0 &&
+            footer.index_offset >= info_end && footer.index_offset % alignof(ColumnChunk) == 0 &&
+            footer.index_offset + footer.chunks * header.columns * sizeof(ColumnChunk) ==
+                size - sizeof(footer);
+    if (!valid) {
+        std::cerr << "Incomplete column file (no index): " << path << std::endl;
+        ::munmap(data, size);
+        return;
+    }
+
+    data_ = bytes;
+    size_ = size;
+    info_ = reinterpret_cast<const ColumnInfo*>(bytes + sizeof(header));
+    index_ = reinterpret_cast<const ColumnChunk*>(bytes + footer.index_offset);
+    columns_ = header.columns;
+    chunks_ = footer.chunks;
+    rows_ = footer.rows;
+}
+
+ColumnReader::~ColumnReader() {
+    if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+int ColumnReader::find(const std::string& name) const {
+    for (size_t c = 0; c < columns_; ++c) {
+        if (std::strncmp(info_[c].name, name.c_str(), sizeof(info_[c].name)) == 0) return static_cast<int>(c);
+    }
+    return -1;
+}
+
+const void* ColumnReader::raw_chunk(size_t chunk, size_t column) const {
+    const ColumnChunk& entry = this->chunk(chunk, column);
+    if (entry.codec != ColumnCodec::Raw || entry.offset + entry.bytes > size_ ||
+        entry.bytes != entry.rows * sizeof(uint64_t)) {
+        return nullptr;
+    }
+    return data_ + entry.offset;
+}
+
+bool ColumnReader::read_chunk(size_t chunk, size_t column, void* out) const {
+    const ColumnChunk& entry = this->chunk(chunk, column);
+    if (entry.offset + entry.bytes > size_) return false;
+    const uint8_t* block = data_ + entry.offset;
+    uint64_t* values = static_cast<uint64_t*>(out);
+    switch (entry.codec) {
+        case ColumnCodec::Raw:
+            if (entry.bytes != entry.rows * sizeof(uint64_t)) return false;
+            std::memcpy(values, block, entry.bytes);
+            return true;
+        case ColumnCodec::DeltaOfDelta:
+            return decode_delta_of_delta(block, entry.bytes, entry.rows, values);
+        case ColumnCodec::XorBytes:
+            return decode_xor_bytes(block, entry.bytes, entry.rows, values);
+    }
+    return false;
+}
+
+bool ColumnReader::read_column(size_t column, void* out) const {
+    if (column >= columns_) return false;
+    uint64_t* values = static_cast<uint64_t*>(out);
+    uint64_t filled = 0;
+    for (size_t c = 0; c < chunks_; ++c) {
+        const ColumnChunk& entry = chunk(c, column);
+        if (filled + entry.rows > rows_ || !read_chunk(c, column, values + filled)) return false;
+        filled += entry.rows;
+    }
+    return filled == rows_;
+}
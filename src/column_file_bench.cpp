@@ -0,0 +1,129 @@
+#include "column_file.hpp"
+#include "rng.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+// Запись выборок бэктеста: прежний CSV через ofstream << против ColumnWriter
+// (со сжатием и без) на одних и тех же строках, затем чтение одной колонки.
+// Проверяется, что прочитанные колонки совпадают с записанными побитно.
+//   column_file_bench [rows] [dir]
+
+namespace {
+
+struct Row {
+    uint64_t time_ns;
+    double mid, bid, ask, inventory, cash, equity;
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint64_t file_size(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+// Выборки как у market_simulator: шаг 1 с, цена на сетке 0.01, редкие сделки
+std::vector<Row> make_rows(size_t n) {
+    Rng rng(42);
+    std::vector<Row> rows(n);
+    double mid = 2000.0, inventory = 0.0, cash = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        mid = std::max(1.0, mid + 0.01 * static_cast<double>(static_cast<int>(rng.next_u64() % 5) - 2));
+        if (rng.next_u64() % 20 == 0) {
+            double side = (rng.next_u64() & 1) ? 1.0 : -1.0;
+            inventory += side * 0.1;
+            cash -= side * 0.1 * mid;
+        }
+        rows[i] = Row{1700000000000000000ull + i * 1000000000ull, mid, mid - 0.05, mid + 0.05,
+                      inventory, cash, cash + inventory * mid};
+    }
+    return rows;
+}
+
+double write_column_file(const std::string& path, const std::vector<Row>& rows, bool compress) {
+    auto start = std::chrono::steady_clock::now();
+    ColumnWriter::Config config;
+    config.compress = compress;
+    ColumnWriter writer(path, {{"time_ns", ColumnType::U64},
+                               {"mid", ColumnType::F64},
+                               {"bid", ColumnType::F64},
+                               {"ask", ColumnType::F64},
+                               {"inventory", ColumnType::F64},
+                               {"cash", ColumnType::F64},
+                               {"equity", ColumnType::F64}},
+                        config);
+    for (const Row& s : rows) {
+        writer.append({s.time_ns, s.mid, s.bid, s.ask, s.inventory, s.cash, s.equity});
+    }
+    writer.close();
+    return seconds_since(start);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+    std::vector<Row> rows = make_rows(n);
+
+    const std::string csv_path = dir + "/column_file_bench.csv";
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream csv(csv_path);
+        csv << "time_ns,mid,bid,ask,inventory,cash,equity\n";
+        for (const Row& s : rows) {
+            csv << s.time_ns << "," << s.mid << "," << s.bid << "," << s.ask << "," << s.inventory << ","
+                << s.cash << "," << s.equity << "\n";
+        }
+    }
+    double csv_sec = seconds_since(start);
+
+    const std::string raw_path = dir + "/column_file_bench_raw.mmcol";
+    const std::string packed_path = dir + "/column_file_bench.mmcol";
+    double raw_sec = write_column_file(raw_path, rows, false);
+    double packed_sec = write_column_file(packed_path, rows, true);
+
+    std::cout << "Rows: " << n << std::endl;
+    std::cout << "  ofstream CSV:        " << csv_sec * 1e9 / n << " ns/row, " << file_size(csv_path) << " bytes"
+              << std::endl;
+    std::cout << "  columns raw:         " << raw_sec * 1e9 / n << " ns/row, " << file_size(raw_path) << " bytes ("
+              << csv_sec / raw_sec << "x faster)" << std::endl;
+    std::cout << "  columns compressed:  " << packed_sec * 1e9 / n << " ns/row, " << file_size(packed_path)
+              << " bytes (" << csv_sec / packed_sec << "x faster)" << std::endl;
+
+    // Одна колонка из сжатого файла, затем проверка всех колонок
+    bool ok = true;
+    for (const std::string& path : {raw_path, packed_path}) {
+        ColumnReader reader(path);
+        std::vector<double> equity;
+        start = std::chrono::steady_clock::now();
+        ok = reader.read_column("equity", equity) && ok;
+        double read_sec = seconds_since(start);
+
+        std::vector<uint64_t> time_ns;
+        std::vector<double> mid, bid, ask, inventory, cash;
+        ok = reader.read_column("time_ns", time_ns) && reader.read_column("mid", mid) &&
+             reader.read_column("bid", bid) && reader.read_column("ask", ask) &&
+             reader.read_column("inventory", inventory) && reader.read_column("cash", cash) && ok;
+        for (size_t i = 0; ok && i < n; ++i) {
+            const Row& s = rows[i];
+            ok = time_ns[i] == s.time_ns && mid[i] == s.mid && bid[i] == s.bid && ask[i] == s.ask &&
+                 inventory[i] == s.inventory && cash[i] == s.cash && equity[i] == s.equity;
+        }
+        std::cout << "  read equity (" << path << "): " << read_sec * 1e9 / n << " ns/value" << std::endl;
+    }
+    std::cout << "  round trip: " << (ok ? "identical" : "MISMATCH") << std::endl;
+
+    std::remove(csv_path.c_str());
+    std::remove(raw_path.c_str());
+    std::remove(packed_path.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "column_file.hpp"
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Вывод колоночного файла (market_simulator, parameter_sweep) в CSV для разовой работы.
+// Читаются только выбранные колонки, чанк за чанком.
+//   column_file_csv file.mmcol [--columns=time_ns,equity] [--limit=N] [--schema]
+
+namespace {
+
+void print_usage() {
+    std::cerr << "Usage: column_file_csv file.mmcol [options]\n"
+              << "  --columns=LIST   comma-separated columns (default: all)\n"
+              << "  --limit=N        first N rows only\n"
+              << "  --schema         columns, types and compressed sizes instead of data" << std::endl;
+}
+
+const char* type_name(ColumnType type) {
+    switch (type) {
+        case ColumnType::U64: return "u64";
+        case ColumnType::I64: return "i64";
+        case ColumnType::F64: return "f64";
+    }
+    return "?";
+}
+
+void print_schema(const ColumnReader& reader) {
+    std::cout << reader.rows() << " rows, " << reader.chunks() << " chunks" << std::endl;
+    for (size_t c = 0; c < reader.columns(); ++c) {
+        uint64_t bytes = 0;
+        for (size_t k = 0; k < reader.chunks(); ++k) bytes += reader.chunk(k, c).bytes;
+        double ratio = bytes > 0 ? static_cast<double>(reader.rows() * sizeof(uint64_t)) / bytes : 0.0;
+        std::cout << "  " << reader.column(c).name << " " << type_name(reader.column(c).type) << ": " << bytes
+                  << " bytes (" << ratio << "x)" << std::endl;
+    }
+}
+
+// Кратчайшая запись, из которой значение восстанавливается точно
+void append_value(std::string& line, ColumnType type, uint64_t bits) {
+    char text[32];
+    std::to_chars_result result;
+    if (type == ColumnType::F64) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        result = std::to_chars(text, text + sizeof(text), value);
+    } else if (type == ColumnType::I64) {
+        result = std::to_chars(text, text + sizeof(text), static_cast<int64_t>(bits));
+    } else {
+        result = std::to_chars(text, text + sizeof(text), bits);
+    }
+    line.append(text, result.ptr);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path;
+    std::string selected;
+    uint64_t limit = UINT64_MAX;
+    bool schema = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--columns=", 0) == 0) {
+            selected = arg.substr(10);
+        } else if (arg.rfind("--limit=", 0) == 0) {
+            limit = std::strtoull(arg.c_str() + 8, nullptr, 10);
+        } else if (arg == "--schema") {
+            schema = true;
+        } else if (arg.rfind("--", 0) != 0 && path.empty()) {
+            path = arg;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (path.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    ColumnReader reader(path);
+    if (!reader.is_open()) return 1;
+    if (schema) {
+        print_schema(reader);
+        return 0;
+    }
+
+    std::vector<size_t> columns;
+    if (selected.empty()) {
+        for (size_t c = 0; c < reader.columns(); ++c) columns.push_back(c);
+    } else {
+        std::stringstream list(selected);
+        std::string name;
+        while (std::getline(list, name, ',')) {
+            int column = reader.find(name);
+            if (column < 0) {
+                std::cerr << "No column " << name << " in " << path << std::endl;
+                return 1;
+            }
+            columns.push_back(static_cast<size_t>(column));
+        }
+    }
+
+    if (columns.empty()) return 0;
+
+    std::string line;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) line += ',';
+        line += reader.column(columns[i]).name;
+    }
+    line += '\n';
+    std::fwrite(line.data(), 1, line.size(), stdout);
+
+    // Чанк выбранных колонок в буферы, затем строки
+    std::vector<std::vector<uint64_t>> values(columns.size());
+    uint64_t written = 0;
+    for (size_t k = 0; k < reader.chunks() && written < limit; ++k) {
+        size_t rows = reader.chunk(k, columns[0]).rows;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            values[i].resize(rows);
+            if (!reader.read_chunk(k, columns[i], values[i].data())) {
+                std::cerr << "Corrupted chunk " << k << " of column " << reader.column(columns[i]).name << std::endl;
+                return 1;
+            }
+        }
+        for (size_t r = 0; r < rows && written < limit; ++r, ++written) {
+            line.clear();
+            for (size_t i = 0; i < columns.size(); ++i) {
+                if (i > 0) line += ',';
+                append_value(line, reader.column(columns[i]).type, values[i][r]);
+            }
+            line += '\n';
+            std::fwrite(line.data(), 1, line.size(), stdout);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,293 @@
+#include "depth_parser.hpp"
+#include <cstring>
+
+namespace {
+
+// 10^10 · 10^8 < 2^63
+constexpr int MAX_INTEGER_DIGITS = 10;
+
+inline void skip_ws(const char*& p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+}
+
+inline bool expect(const char*& p, const char* end, char c) {
+    skip_ws(p, end);
+    if (p >= end || *p != c) return false;
+    ++p;
+    return true;
+}
+
+// Читает строку в кавычках и возвращает указатели на ее содержимое (без копирования)
+bool read_string(const char*& p, const char* end, const char*& begin, size_t& len) {
+    if (!expect(p, end, '"')) return false;
+    begin = p;
+    while (p < end && *p != '"') {
+        if (*p == '\\') ++p;  // Экранированный символ пропускаем целиком
+        ++p;
+    }
+    if (p >= end) return false;
+    len = static_cast<size_t>(p - begin);
+    ++p;
+    return true;
+}
+
+bool read_uint(const char*& p, const char* end, uint64_t& out) {
+    skip_ws(p, end);
+    if (p >= end || *p < '0' || *p > '9') return false;
+    uint64_t value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        ++p;
+    }
+    out = value;
+    return true;
+}
+
+// Пропуск произвольного значения JSON (для неизвестных ключей)
+bool skip_value(const char*& p, const char* end) {
+    skip_ws(p, end);
+    if (p >= end) return false;
+
+    if (*p == '"') {
+        const char* begin;
+        size_t len;
+        return read_string(p, end, begin, len);
+    }
+
+    if (*p == '{' || *p == '[') {
+        int nesting = 0;
+        while (p < end) {
+            char c = *p;
+            if (c == '"') {
+                const char* begin;
+                size_t len;
+                if (!read_string(p, end, begin, len)) return false;
+                continue;
+            }
+            if (c == '{' || c == '[') ++nesting;
+            if (c == '}' || c == ']') --nesting;
+            ++p;
+            if (nesting == 0) return true;
+        }
+        return false;
+    }
+
+    // Число, true/false/null
+    const char* start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+           *p != ' ' && *p != '\n' && *p != '\r' && *p != '\t') ++p;
+    return p != start;
+}
+
+// Число уровня может прийти строкой ("2000.1") или числом (2000.1)
+bool read_level_value(const char*& p, const char* end, int64_t& out) {
+    skip_ws(p, end);
+    if (p < end && *p == '"') {
+        ++p;
+        if (!parse_fixed_point(p, end, out)) return false;
+        return p < end && *p++ == '"';
+    }
+    return parse_fixed_point(p, end, out);
+}
+
+// Массив уровней вида [["price","qty"], ...]
+bool read_levels(const char*& p, const char* end, PriceLevel* levels, size_t& count) {
+    count = 0;
+    if (!expect(p, end, '[')) return false;
+    skip_ws(p, end);
+    if (p < end && *p == ']') {
+        ++p;
+        return true;
+    }
+
+    while (true) {
+        if (count >= MAX_DEPTH_LEVELS) return false;
+        PriceLevel& level = levels[count];
+        if (!expect(p, end, '[')) return false;
+        if (!read_level_value(p, end, level.price)) return false;
+        if (!expect(p, end, ',')) return false;
+        if (!read_level_value(p, end, level.qty)) return false;
+        // Поля сверх цены и объема (если появятся) игнорируем
+        skip_ws(p, end);
+        while (p < end && *p == ',') {
+            ++p;
+            if (!skip_value(p, end)) return false;
+            skip_ws(p, end);
+        }
+        if (!expect(p, end, ']')) return false;
+        ++count;
+
+        skip_ws(p, end);
+        if (p >= end) return false;
+        if (*p == ',') {
+            ++p;
+            continue;
+        }
+        return *p++ == ']';
+    }
+}
+
+inline bool key_is(const char* key, size_t len, const char* name) {
+    size_t name_len = std::strlen(name);
+    return len == name_len && std::memcmp(key, name, len) == 0;
+}
+
+} // namespace
+
+bool parse_fixed_point(const char*& p, const char* end, int64_t& out) {
+    skip_ws(p, end);
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+
+    // Целая часть: значащих цифр не больше MAX_INTEGER_DIGITS, чтобы value * 10^8 влезло в int64
+    const char* start = p;
+    int64_t value = 0;
+    int integer_digits = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (value != 0 || *p != '0') {
+            if (++integer_digits > MAX_INTEGER_DIGITS) return false;
+        }
+        value = value * 10 + (*p - '0');
+        ++p;
+    }
+    bool has_digits = p != start;
+
+    int digits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < FIXED_POINT_DIGITS) {
+                value = value * 10 + (*p - '0');
+                ++digits;
+            }
+            has_digits = true;
+            ++p;
+        }
+    }
+    // "." и "-" без цифр — не число
+    if (!has_digits) return false;
+
+    static constexpr int64_t pow10[FIXED_POINT_DIGITS + 1] = {
+        100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10, 1};
+    value *= pow10[digits];
+
+    out = negative ? -value : value;
+    return true;
+}
+
+bool parse_depth_update(const char* data, size_t size, DepthUpdate& out) {
+    const char* p = data;
+    const char* end = data + size;
+
+    out.event_time = 0;
+    out.first_update_id = 0;
+    out.final_update_id = 0;
+    out.symbol[0] = '\0';
+    out.bid_count = 0;
+    out.ask_count = 0;
+
+    bool has_bids = false;
+    bool has_asks = false;
+    bool has_first_id = false;
+
+    if (!expect(p, end, '{')) return false;
+    skip_ws(p, end);
+    if (p < end && *p == '}') return false;
+
+    while (true) {
+        const char* key;
+        size_t key_len;
+        if (!read_string(p, end, key, key_len)) return false;
+        if (!expect(p, end, ':')) return false;
+
+        bool ok;
+        if (key_is(key, key_len, "b") || key_is(key, key_len, "bids")) {
+            ok = read_levels(p, end, out.bids, out.bid_count);
+            has_bids = true;
+        } else if (key_is(key, key_len, "a") || key_is(key, key_len, "asks")) {
+            ok = read_levels(p, end, out.asks, out.ask_count);
+            has_asks = true;
+        } else if (key_is(key, key_len, "E")) {
+            ok = read_uint(p, end, out.event_time);
+        } else if (key_is(key, key_len, "U")) {
+            ok = read_uint(p, end, out.first_update_id);
+            has_first_id = true;
+        } else if (key_is(key, key_len, "u") || key_is(key, key_len, "lastUpdateId")) {
+            ok = read_uint(p, end, out.final_update_id);
+        } else if (key_is(key, key_len, "s")) {
+            const char* value;
+            size_t len;
+            ok = read_string(p, end, value, len);
+            if (ok) {
+                if (len >= sizeof(out.symbol)) len = sizeof(out.symbol) - 1;
+                std::memcpy(out.symbol, value, len);
+                out.symbol[len] = '\0';
+            }
+        } else {
+            ok = skip_value(p, end);
+        }
+        if (!ok) return false;
+
+        skip_ws(p, end);
+        if (p >= end) return false;
+        if (*p == ',') {
+            ++p;
+            continue;
+        }
+        if (*p != '}') return false;
+        break;
+    }
+
+    // У снапшота нет "U": весь он соответствует одному lastUpdateId
+    if (!has_first_id) out.first_update_id = out.final_update_id;
+
+    return has_bids && has_asks;
+}
+
+bool parse_stream_envelope(const char* data, size_t size,
+                           const char*& stream, size_t& stream_size,
+                           const char*& payload, size_t& payload_size) {
+    const char* p = data;
+    const char* end = data + size;
+    stream = nullptr;
+    payload = nullptr;
+
+    if (!expect(p, end, '{')) return false;
+
+    while (true) {
+        const char* key;
+        size_t key_len;
+        if (!read_string(p, end, key, key_len)) return false;
+        if (!expect(p, end, ':')) return false;
+
+        if (key_is(key, key_len, "stream")) {
+            if (!read_string(p, end, stream, stream_size)) return false;
+        } else if (key_is(key, key_len, "data")) {
+            skip_ws(p, end);
+            payload = p;
+            if (stream) {
+                payload_size = static_cast<size_t>(end - p);
+                return true;
+            }
+            if (!skip_value(p, end)) return false;
+            payload_size = static_cast<size_t>(p - payload);
+        } else if (!stream && !payload) {
+            // Обертка всегда начинается со "stream"/"data": обычное сообщение
+            // не сканируем целиком
+            return false;
+        } else if (!skip_value(p, end)) {
+            return false;
+        }
+
+        skip_ws(p, end);
+        if (p >= end) return false;
+        if (*p == ',') {
+            ++p;
+            continue;
+        }
+        return *p == '}' && stream && payload;
+    }
+}
@@ -0,0 +1,125 @@
+#include "depth_parser.hpp"
+#include <boost/beast/core.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace beast = boost::beast;
+using json = nlohmann::json;
+
+// Счетчик аллокаций, чтобы показать разницу между путями разбора
+static size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+// Полный набор замен, иначе new[] и выровненные new не попадают в счетчик
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++allocation_count;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) { return ::operator new(size, alignment); }
+
+// Все формы delete освобождают через free и не встраиваются: иначе GCC видит free
+// для указателя от operator new в вызывающем коде (-Wmismatched-new-delete).
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Сообщение @depth@100ms с заданным числом уровней на сторону
+std::string make_depth_message(int levels) {
+    std::string msg = R"({"e":"depthUpdate","E":1700000000123,"s":"ETHUSDT","U":157,"u":160,"b":[)";
+    for (int i = 0; i < levels; ++i) {
+        if (i) msg += ",";
+        msg += "[\"" + std::to_string(2000 - i) + ".12000000\",\"" + std::to_string(i + 1) + ".50000000\"]";
+    }
+    msg += R"(],"a":[)";
+    for (int i = 0; i < levels; ++i) {
+        if (i) msg += ",";
+        msg += "[\"" + std::to_string(2001 + i) + ".34000000\",\"" + std::to_string(i + 2) + ".25000000\"]";
+    }
+    msg += "]}";
+    return msg;
+}
+
+// Прежний путь из BinanceClient::on_read, расширенный на все уровни
+double parse_with_json(beast::flat_buffer& buffer) {
+    auto data = beast::buffers_to_string(buffer.data());
+    json market_data = json::parse(data);
+
+    double checksum = static_cast<double>(market_data["E"].get<uint64_t>());
+    for (const auto& level : market_data["b"]) {
+        checksum += std::stod(level[0].get<std::string>()) + std::stod(level[1].get<std::string>());
+    }
+    for (const auto& level : market_data["a"]) {
+        checksum += std::stod(level[0].get<std::string>()) + std::stod(level[1].get<std::string>());
+    }
+    return checksum;
+}
+
+double parse_with_streaming(beast::flat_buffer& buffer, DepthUpdate& depth) {
+    auto frame = buffer.data();
+    if (!parse_depth_update(static_cast<const char*>(frame.data()), frame.size(), depth)) return 0.0;
+
+    double checksum = static_cast<double>(depth.event_time);
+    for (size_t i = 0; i < depth.bid_count; ++i) {
+        checksum += fixed_to_double(depth.bids[i].price) + fixed_to_double(depth.bids[i].qty);
+    }
+    for (size_t i = 0; i < depth.ask_count; ++i) {
+        checksum += fixed_to_double(depth.asks[i].price) + fixed_to_double(depth.asks[i].qty);
+    }
+    return checksum;
+}
+
+template <typename Fn>
+void run_case(const char* name, int iterations, Fn&& fn) {
+    double checksum = 0.0;
+    size_t allocations_before = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        checksum += fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    double allocs = static_cast<double>(allocation_count - allocations_before) / iterations;
+
+    std::cout << name << ": " << ns << " ns/msg, "
+              << allocs << " allocs/msg (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+
+    auto depth = std::make_unique<DepthUpdate>();
+    for (int levels : {1, 10, 100}) {
+        std::string msg = make_depth_message(levels);
+
+        beast::flat_buffer buffer;
+        auto out = buffer.prepare(msg.size());
+        std::memcpy(out.data(), msg.data(), msg.size());
+        buffer.commit(msg.size());
+
+        std::cout << "Levels per side: " << levels << " (" << msg.size() << " bytes)" << std::endl;
+        run_case("  json + stod", iterations, [&] { return parse_with_json(buffer); });
+        run_case("  streaming  ", iterations, [&] { return parse_with_streaming(buffer, *depth); });
+    }
+
+    return 0;
+}
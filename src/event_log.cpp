@@ -0,0 +1,235 @@
+#include "event_log.hpp"
+#include "utils.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+std::atomic<uint64_t> next_log_id{1};
+
+// Кольцо текущего потока для последнего использованного журнала
+struct ProducerCache {
+    uint64_t log_id = 0;
+    void* producer = nullptr;
+};
+thread_local ProducerCache producer_cache;
+
+void append(std::string& out, const char* format, double value) {
+    char buf[64];
+    int n = std::snprintf(buf, sizeof(buf), format, value);
+    if (n > 0) out.append(buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1));
+}
+
+// Имена значений по типу записи; лишние значения выводятся без имени
+void append_values(std::string& out, const LogRecord& record, const char* const* names, size_t name_count) {
+    for (size_t i = 0; i < record.count && i < LogRecord::MAX_VALUES; ++i) {
+        out += ' ';
+        if (i < name_count) {
+            out += names[i];
+            out += '=';
+        }
+        append(out, "%.10g", record.values[i]);
+    }
+}
+
+} // namespace
+
+void format_log_record(const LogRecord& record, std::string& out) {
+    static const char* const QUOTE_NAMES[] = {"S_t", "sigma", "base_ask", "base_bid", "ask", "bid", "inventory"};
+    static const char* const FILL_NAMES[] = {"price", "market_price", "gas_cost", "inventory"};
+    static const char* const BOTH_SIDES_NAMES[] = {"market_price", "ask", "bid"};
+
+    char prefix[64];
+    int n = std::snprintf(prefix, sizeof(prefix), "%llu.%09llu T%u #%llu ",
+                          static_cast<unsigned long long>(record.time_ns / 1000000000ull),
+                          static_cast<unsigned long long>(record.time_ns % 1000000000ull),
+                          static_cast<unsigned>(record.thread),
+                          static_cast<unsigned long long>(record.seq));
+    if (n > 0) out.append(prefix, std::min(static_cast<size_t>(n), sizeof(prefix) - 1));
+
+    switch (static_cast<LogEventType>(record.type)) {
+    case LogEventType::Quote:
+        out += "QUOTE";
+        append_values(out, record, QUOTE_NAMES, 7);
+        break;
+    case LogEventType::Fill:
+        switch (static_cast<LogFillSide>(record.code)) {
+        case LogFillSide::Buy: out += "FILL BUY"; break;
+        case LogFillSide::Sell: out += "FILL SELL"; break;
+        default: out += "FILL NONE"; break;
+        }
+        append_values(out, record, FILL_NAMES, 4);
+        break;
+    case LogEventType::Warning:
+        if (static_cast<LogWarning>(record.code) == LogWarning::BothSidesTriggered) {
+            out += "WARN both_sides_triggered";
+            append_values(out, record, BOTH_SIDES_NAMES, 3);
+        } else {
+            out += "WARN code=" + std::to_string(record.code);
+            append_values(out, record, nullptr, 0);
+        }
+        break;
+    default:
+        out += "UNKNOWN type=" + std::to_string(record.type) + " code=" + std::to_string(record.code);
+        append_values(out, record, nullptr, 0);
+        break;
+    }
+}
+
+EventLog::EventLog(Config config)
+    : config_(std::move(config)),
+      id_(next_log_id.fetch_add(1, std::memory_order_relaxed)) {}
+
+EventLog::~EventLog() {
+    stop();
+}
+
+bool EventLog::start() {
+    if (running_) return true;
+
+    bool binary = config_.format == Format::Binary;
+    if (config_.path.empty()) {
+        if (binary) {
+            std::cerr << "Event log: binary format needs a file path" << std::endl;
+            return false;
+        }
+        file_ = stdout;
+    } else {
+        file_ = std::fopen(config_.path.c_str(), binary ? "wb" : "w");
+        if (!file_) {
+            std::cerr << "Event log: cannot open " << config_.path << std::endl;
+            return false;
+        }
+    }
+
+    if (binary) {
+        EventLogFileHeader header{};
+        std::memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+        header.version = EVENT_LOG_VERSION;
+        header.record_size = sizeof(LogRecord);
+        header.created_ns = utils::wall_clock_ns();
+        std::fwrite(&header, sizeof(header), 1, file_);
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread(&EventLog::writer_loop, this);
+    return true;
+}
+
+void EventLog::stop() {
+    if (!running_.exchange(false)) return;
+    if (writer_thread_.joinable()) writer_thread_.join();
+
+    while (drain() > 0) {
+    }
+    if (file_ == stdout) {
+        std::fflush(file_);
+    } else if (file_) {
+        std::fclose(file_);
+    }
+    file_ = nullptr;
+}
+
+bool EventLog::log(LogEventType type, uint16_t code, std::initializer_list<double> values) {
+    Producer* p = producer();
+    if (!p) {
+        unregistered_drops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    LogRecord record;
+    record.time_ns = utils::wall_clock_ns();
+    record.seq = p->seq++;
+    record.type = static_cast<uint16_t>(type);
+    record.code = code;
+    record.thread = p->index;
+    record.count = static_cast<uint16_t>(std::min(values.size(), LogRecord::MAX_VALUES));
+    std::copy_n(values.begin(), record.count, record.values);
+    std::fill(record.values + record.count, record.values + LogRecord::MAX_VALUES, 0.0);
+
+    if (!p->ring.try_push(record)) {
+        p->dropped.store(p->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+EventLog::Stats EventLog::stats() const {
+    Stats result{written_.load(std::memory_order_relaxed),
+                 unregistered_drops_.load(std::memory_order_relaxed),
+                 producer_count_.load(std::memory_order_acquire)};
+    for (size_t i = 0; i < result.threads; ++i) {
+        result.dropped += producers_[i]->dropped.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+EventLog::Producer* EventLog::producer() {
+    if (producer_cache.log_id == id_) return static_cast<Producer*>(producer_cache.producer);
+    Producer* p = register_producer();
+    if (p) {
+        producer_cache.log_id = id_;
+        producer_cache.producer = p;
+    }
+    return p;
+}
+
+EventLog::Producer* EventLog::register_producer() {
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    std::thread::id self = std::this_thread::get_id();
+    size_t count = producer_count_.load(std::memory_order_relaxed);
+
+    // Поток уже писал в этот журнал, но кэш потока был занят другим журналом
+    for (size_t i = 0; i < count; ++i) {
+        if (producers_[i]->owner == self) return producers_[i].get();
+    }
+    if (count == MAX_THREADS) return nullptr;
+
+    producers_[count] = std::make_unique<Producer>(config_.ring_capacity);
+    producers_[count]->owner = self;
+    producers_[count]->index = static_cast<uint16_t>(count);
+    producer_count_.store(count + 1, std::memory_order_release);
+    return producers_[count].get();
+}
+
+void EventLog::writer_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(config_.idle_sleep);
+        }
+    }
+}
+
+size_t EventLog::drain() {
+    const size_t BATCH = 256;  // Записей за проход по одному кольцу, чтобы не задерживать остальные
+    size_t count = producer_count_.load(std::memory_order_acquire);
+    size_t drained = 0;
+    LogRecord records[BATCH];
+
+    for (size_t i = 0; i < count; ++i) {
+        SpscQueue<LogRecord>& ring = producers_[i]->ring;
+        size_t n = 0;
+        while (n < BATCH && ring.try_pop(records[n])) ++n;
+        if (n == 0) continue;
+
+        if (config_.format == Format::Binary) {
+            std::fwrite(records, sizeof(LogRecord), n, file_);
+        } else {
+            text_.clear();
+            for (size_t j = 0; j < n; ++j) {
+                format_log_record(records[j], text_);
+                text_ += '\n';
+            }
+            std::fwrite(text_.data(), 1, text_.size(), file_);
+        }
+        drained += n;
+    }
+
+    if (drained > 0) {
+        written_.fetch_add(drained, std::memory_order_relaxed);
+        // В stdout — построчная выдача без задержки, в файл — буферизованная запись
+        if (file_ == stdout) std::fflush(file_);
+    }
+    return drained;
+}
@@ -0,0 +1,59 @@
+#include "event_log.hpp"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Вывод бинарного журнала событий (EventLog::Format::Binary) в текст.
+// Пропуски в номерах записей потока означают записи, отброшенные при переполнении кольца.
+//   event_log_decode file.evlog
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: event_log_decode file.evlog" << std::endl;
+        return 1;
+    }
+
+    std::FILE* file = std::fopen(argv[1], "rb");
+    if (!file) {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    EventLogFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "Not an event log: " << argv[1] << std::endl;
+        std::fclose(file);
+        return 1;
+    }
+    if (header.version != EVENT_LOG_VERSION || header.record_size != sizeof(LogRecord)) {
+        std::cerr << "Unsupported event log version " << header.version
+                  << " (record size " << header.record_size << ")" << std::endl;
+        std::fclose(file);
+        return 1;
+    }
+
+    // Пропуски seq по потокам: сколько записей потеряно при записи
+    const size_t MAX_THREADS = EventLog::MAX_THREADS;
+    uint64_t next_seq[MAX_THREADS] = {};
+    uint64_t records = 0;
+    uint64_t gaps = 0;
+
+    LogRecord record;
+    std::string line;
+    while (std::fread(&record, sizeof(record), 1, file) == 1) {
+        if (record.thread < MAX_THREADS) {
+            if (record.seq > next_seq[record.thread]) gaps += record.seq - next_seq[record.thread];
+            next_seq[record.thread] = record.seq + 1;
+        }
+        line.clear();
+        format_log_record(record, line);
+        line += '\n';
+        std::fwrite(line.data(), 1, line.size(), stdout);
+        ++records;
+    }
+    std::fclose(file);
+
+    std::cerr << records << " records, " << gaps << " dropped before writing" << std::endl;
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "feed_runtime.hpp"
+#include "thread_util.hpp"
+#include <iostream>
+#include <utility>
+
+FeedRuntime::FeedRuntime(boost::asio::io_context& ioc, const Config& config, MarketDataPipeline::EventHandler handler)
+    : ioc_(ioc),
+      config_(config),
+      pipeline_(pipeline_config(config), std::move(handler)),
+      work_(boost::asio::make_work_guard(ioc)) {}
+
+FeedRuntime::~FeedRuntime() {
+    stop();
+}
+
+MarketDataPipeline::Config FeedRuntime::pipeline_config(const Config& config) {
+    MarketDataPipeline::Config pipeline = config.pipeline;
+    pipeline.consumer_core = config.strategy_core;
+    pipeline.idle = config.mode == Mode::BusyPoll
+        ? MarketDataPipeline::IdleStrategy::BusySpin
+        : MarketDataPipeline::IdleStrategy::Park;
+    return pipeline;
+}
+
+void FeedRuntime::start() {
+    if (running_.exchange(true)) return;
+    started_ = std::chrono::steady_clock::now();
+    pipeline_.start();
+    network_ = std::thread(&FeedRuntime::network_loop, this);
+}
+
+void FeedRuntime::stop() {
+    if (!running_.exchange(false)) return;
+
+    // Время CPU снимаем до join: после завершения потока его часы недоступны
+    network_cpu_sec_ = thread_cpu_seconds(network_.native_handle());
+    strategy_cpu_sec_ = pipeline_.consumer_cpu_seconds();
+    stopped_ = std::chrono::steady_clock::now();
+
+    work_.reset();
+    ioc_.stop();
+    network_.join();
+    pipeline_.stop();
+}
+
+void FeedRuntime::network_loop() {
+    if (!pin_current_thread(config_.network_core)) {
+        std::cerr << "Failed to pin network thread to core " << config_.network_core << std::endl;
+    }
+
+    if (config_.mode == Mode::Blocking) {
+        ioc_.run();
+        return;
+    }
+
+    // poll() выполняет готовые обработчики и сразу возвращается: epoll опрашивается
+    // без сна, поэтому готовый сокет обрабатывается без пробуждения потока
+    uint64_t polls = 0;
+    uint64_t empty = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (ioc_.poll() == 0) ++empty;
+        // Счетчики публикуются пачками, чтобы не писать в общую память на каждой итерации
+        if ((++polls & 1023) == 0) {
+            polls_.store(polls, std::memory_order_relaxed);
+            empty_polls_.store(empty, std::memory_order_relaxed);
+        }
+    }
+    polls_.store(polls, std::memory_order_relaxed);
+    empty_polls_.store(empty, std::memory_order_relaxed);
+}
+
+FeedRuntime::Stats FeedRuntime::stats() {
+    bool running = running_.load(std::memory_order_relaxed);
+    auto end = running ? std::chrono::steady_clock::now() : stopped_;
+    double wall = std::chrono::duration<double>(end - started_).count();
+
+    Stats result{};
+    result.network = {running ? thread_cpu_seconds(network_.native_handle()) : network_cpu_sec_, wall};
+    result.strategy = {running ? pipeline_.consumer_cpu_seconds() : strategy_cpu_sec_, wall};
+    result.polls = polls_.load(std::memory_order_relaxed);
+    result.empty_polls = empty_polls_.load(std::memory_order_relaxed);
+    result.pipeline = pipeline_.stats();
+    return result;
+}
+
+bool FeedRuntime::parse_mode(const std::string& name, Mode& mode) {
+    if (name == "blocking") {
+        mode = Mode::Blocking;
+    } else if (name == "busy-poll") {
+        mode = Mode::BusyPoll;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* FeedRuntime::mode_name(Mode mode) {
+    return mode == Mode::BusyPoll ? "busy-poll" : "blocking";
+}
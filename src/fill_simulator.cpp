@@ -0,0 +1,39 @@
+#include "fill_simulator.hpp"
+#include <cmath>
+
+double FillSimulator::latency_shift(double sigma, double latency) {
+    return rng_.normal(0.0, sigma * std::sqrt(latency));
+}
+
+Fill FillSimulator::simulate(const Quote& quote, double mid_price, double sigma, double inventory) {
+    Fill fill{FillSide::None, 0.0, 0.0, false};
+
+    // Генерация независимой рыночной цены (не зависит от reservation_price)
+    fill.market_price = mid_price + rng_.normal(0.0, sigma);
+
+    bool is_buy = (fill.market_price <= quote.bid);
+    bool is_sell = (fill.market_price >= quote.ask);
+
+    // При корректном спреде не происходит, но на всякий случай
+    if (is_buy && is_sell) {
+        fill.conflict = true;
+        if (inventory > 0) {
+            is_buy = false;  // Приоритет продажи для уменьшения положительного инвентаря
+        } else if (inventory < 0) {
+            is_sell = false; // Приоритет покупки для уменьшения отрицательного инвентаря
+        } else {
+            // Если инвентарь равен 0, случайно выбираем
+            is_buy = (rng_.normal() > 0);
+            is_sell = !is_buy;
+        }
+    }
+
+    if (is_buy) {
+        fill.side = FillSide::Buy;
+        fill.price = quote.bid;
+    } else if (is_sell) {
+        fill.side = FillSide::Sell;
+        fill.price = quote.ask;
+    }
+    return fill;
+}
@@ -0,0 +1,374 @@
+#include "history_store.hpp"
+#include "column_file.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t CSV_CHUNK_BYTES = 4 << 20;  // Кусок разбора: десятки тысяч строк
+constexpr size_t MAX_CSV_FIELDS = 12;
+constexpr uint64_t NS_PER_DAY = 86400ull * 1000000000ull;
+
+// Файл CSV, отображенный только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "History: cannot open " << path << std::endl;
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            std::cerr << "History: cannot stat " << path << std::endl;
+            ::close(fd);
+            return;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        opened_ = true;
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                std::cerr << "History: cannot map " << path << std::endl;
+                opened_ = false;
+                size_ = 0;
+            } else {
+                data_ = static_cast<const char*>(data);
+                ::madvise(data, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return opened_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool opened_ = false;
+};
+
+struct Field {
+    const char* begin;
+    const char* end;
+};
+
+// Поля строки без '\r'; возвращает их число (не больше MAX_CSV_FIELDS)
+size_t split_fields(const char* begin, const char* end, Field* fields) {
+    if (end > begin && end[-1] == '\r') --end;
+    size_t count = 0;
+    const char* start = begin;
+    for (const char* p = begin; count < MAX_CSV_FIELDS; ++p) {
+        if (p == end || *p == ',') {
+            fields[count++] = Field{start, p};
+            if (p == end) break;
+            start = p + 1;
+        }
+    }
+    return count;
+}
+
+bool parse_number(const Field& field, double& value) {
+    auto result = std::from_chars(field.begin, field.end, value);
+    return result.ec == std::errc() && result.ptr == field.end;
+}
+
+// Метка времени в секундах, мс, мкс или нс — по величине
+bool parse_time_ns(const Field& field, uint64_t& time_ns) {
+    uint64_t value;
+    auto result = std::from_chars(field.begin, field.end, value);
+    if (result.ec != std::errc() || result.ptr != field.end) return false;
+    if (value < 100000000000ull) {
+        time_ns = value * 1000000000ull;
+    } else if (value < 100000000000000ull) {
+        time_ns = value * 1000000ull;
+    } else if (value < 100000000000000000ull) {
+        time_ns = value * 1000ull;
+    } else {
+        time_ns = value;
+    }
+    return true;
+}
+
+bool parse_flag(const Field& field, bool& value) {
+    size_t length = static_cast<size_t>(field.end - field.begin);
+    if (length == 0) return false;
+    char first = static_cast<char>(std::tolower(static_cast<unsigned char>(*field.begin)));
+    if ((first == 't' && length == 4) || (first == '1' && length == 1)) {
+        value = true;
+        return true;
+    }
+    if ((first == 'f' && length == 5) || (first == '0' && length == 1)) {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool parse_kline_line(const char* begin, const char* end, Kline& kline) {
+    Field fields[MAX_CSV_FIELDS];
+    size_t count = split_fields(begin, end, fields);
+    return count >= 6 && parse_time_ns(fields[0], kline.open_time_ns) && parse_number(fields[1], kline.open) &&
+           parse_number(fields[2], kline.high) && parse_number(fields[3], kline.low) &&
+           parse_number(fields[4], kline.close) && parse_number(fields[5], kline.volume);
+}
+
+bool parse_trade_line(const char* begin, const char* end, Trade& trade) {
+    Field fields[MAX_CSV_FIELDS];
+    size_t count = split_fields(begin, end, fields);
+    if (count < 6) return false;
+    // aggTrades: два лишних поля id перед временем
+    size_t time_field = count >= 8 ? 5 : 4;
+    return parse_number(fields[1], trade.price) && parse_number(fields[2], trade.qty) &&
+           parse_time_ns(fields[time_field], trade.time_ns) && parse_flag(fields[time_field + 1], trade.buyer_maker);
+}
+
+// Начало первой полной строки не раньше offset
+size_t line_start(const char* data, size_t size, size_t offset) {
+    if (offset == 0) return 0;
+    if (offset >= size) return size;
+    const void* newline = std::memchr(data + offset - 1, '\n', size - offset + 1);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+}
+
+template <class Record, class ParseLine>
+bool parse_csv(const std::string& path, std::vector<Record>& out, WorkStealingPool* pool, CsvParseStats* stats,
+               ParseLine parse_line) {
+    out.clear();
+    MappedFile file(path);
+    if (!file.is_open()) return false;
+
+    const char* data = file.data();
+    const size_t size = file.size();
+    const size_t chunks = std::max<size_t>(1, (size + CSV_CHUNK_BYTES - 1) / CSV_CHUNK_BYTES);
+    std::vector<std::vector<Record>> parsed(chunks);
+    std::vector<uint64_t> skipped(chunks, 0);
+
+    // Кусок i — строки, начинающиеся в [i * CHUNK, (i + 1) * CHUNK)
+    auto parse_chunk = [&](size_t chunk, size_t) {
+        size_t begin = line_start(data, size, chunk * CSV_CHUNK_BYTES);
+        size_t end = line_start(data, size, std::min(size, (chunk + 1) * CSV_CHUNK_BYTES));
+        std::vector<Record>& records = parsed[chunk];
+        records.reserve((end - begin) / 48);
+        Record record;
+        while (begin < end) {
+            const void* newline = std::memchr(data + begin, '\n', end - begin);
+            size_t line_end = newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : end;
+            if (line_end > begin) {
+                if (parse_line(data + begin, data + line_end, record)) {
+                    records.push_back(record);
+                } else {
+                    ++skipped[chunk];
+                }
+            }
+            begin = line_end + 1;
+        }
+    };
+    if (pool) {
+        pool->parallel_for(chunks, parse_chunk);
+    } else {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) parse_chunk(chunk, 0);
+    }
+
+    size_t total = 0;
+    for (const std::vector<Record>& records : parsed) total += records.size();
+    out.reserve(total);
+    uint64_t skipped_total = 0;
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        out.insert(out.end(), parsed[chunk].begin(), parsed[chunk].end());
+        skipped_total += skipped[chunk];
+    }
+    if (stats) *stats = CsvParseStats{size, total, skipped_total, chunks};
+    return true;
+}
+
+std::string normalize_symbol(const std::string& symbol) {
+    std::string upper = symbol;
+    for (char& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return upper;
+}
+
+const char* kind_directory(HistoryStore::Kind kind) {
+    return kind == HistoryStore::Kind::Klines ? "klines" : "trades";
+}
+
+// Записи одного UTC-дня подряд: [begin, end) для каждого дня отсортированного массива
+template <class Record, class TimeOf, class WriteDay>
+bool write_days(const std::vector<Record>& records, TimeOf time_of, WriteDay write_day, size_t* days) {
+    size_t written = 0;
+    size_t begin = 0;
+    while (begin < records.size()) {
+        uint64_t day = time_of(records[begin]) / NS_PER_DAY;
+        size_t end = begin + 1;
+        while (end < records.size() && time_of(records[end]) / NS_PER_DAY == day) ++end;
+        if (!write_day(utc_date(time_of(records[begin])), begin, end)) return false;
+        ++written;
+        begin = end;
+    }
+    if (days) *days = written;
+    return true;
+}
+
+} // namespace
+
+bool parse_kline_csv(const std::string& path, std::vector<Kline>& out, WorkStealingPool* pool,
+                     CsvParseStats* stats) {
+    return parse_csv(path, out, pool, stats, parse_kline_line);
+}
+
+bool parse_trade_csv(const std::string& path, std::vector<Trade>& out, WorkStealingPool* pool,
+                     CsvParseStats* stats) {
+    return parse_csv(path, out, pool, stats, parse_trade_line);
+}
+
+std::string utc_date(uint64_t time_ns) {
+    // Дни от 1970-01-01 в гражданскую дату (алгоритм H. Hinnant, civil_from_days)
+    int64_t z = static_cast<int64_t>(time_ns / NS_PER_DAY) + 719468;
+    int64_t era = z / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yoe + era * 400 + (month <= 2);
+
+    char text[32];
+    std::snprintf(text, sizeof(text), "%04d-%02d-%02d", static_cast<int>(year), static_cast<int>(month),
+                  static_cast<int>(day));
+    return text;
+}
+
+HistoryStore::HistoryStore(std::string root) : root_(std::move(root)) {}
+
+std::string HistoryStore::path(const std::string& symbol, Kind kind, const std::string& date) const {
+    return root_ + "/" + normalize_symbol(symbol) + "/" + kind_directory(kind) + "/" + date + ".mmcol";
+}
+
+bool HistoryStore::import_klines(const std::string& symbol, std::vector<Kline> klines, size_t* days) {
+    std::stable_sort(klines.begin(), klines.end(),
+                     [](const Kline& a, const Kline& b) { return a.open_time_ns < b.open_time_ns; });
+    std::error_code error;
+    std::filesystem::create_directories(root_ + "/" + normalize_symbol(symbol) + "/klines", error);
+
+    return write_days(
+        klines, [](const Kline& k) { return k.open_time_ns; },
+        [&](const std::string& date, size_t begin, size_t end) {
+            ColumnWriter writer(path(symbol, Kind::Klines, date), {{"open_time_ns", ColumnType::U64},
+                                                                   {"open", ColumnType::F64},
+                                                                   {"high", ColumnType::F64},
+                                                                   {"low", ColumnType::F64},
+                                                                   {"close", ColumnType::F64},
+                                                                   {"volume", ColumnType::F64}});
+            if (!writer.is_open()) return false;
+            for (size_t i = begin; i < end; ++i) {
+                const Kline& k = klines[i];
+                writer.append({k.open_time_ns, k.open, k.high, k.low, k.close, k.volume});
+            }
+            return writer.close();
+        },
+        days);
+}
+
+bool HistoryStore::import_trades(const std::string& symbol, std::vector<Trade> trades, size_t* days) {
+    std::stable_sort(trades.begin(), trades.end(),
+                     [](const Trade& a, const Trade& b) { return a.time_ns < b.time_ns; });
+    std::error_code error;
+    std::filesystem::create_directories(root_ + "/" + normalize_symbol(symbol) + "/trades", error);
+
+    return write_days(
+        trades, [](const Trade& t) { return t.time_ns; },
+        [&](const std::string& date, size_t begin, size_t end) {
+            ColumnWriter writer(path(symbol, Kind::Trades, date), {{"time_ns", ColumnType::U64},
+                                                                   {"price", ColumnType::F64},
+                                                                   {"qty", ColumnType::F64},
+                                                                   {"buyer_maker", ColumnType::U64}});
+            if (!writer.is_open()) return false;
+            for (size_t i = begin; i < end; ++i) {
+                const Trade& t = trades[i];
+                writer.append({t.time_ns, t.price, t.qty, uint64_t(t.buyer_maker ? 1 : 0)});
+            }
+            return writer.close();
+        },
+        days);
+}
+
+std::vector<std::string> HistoryStore::dates(const std::string& symbol, Kind kind) const {
+    std::vector<std::string> result;
+    std::error_code error;
+    std::filesystem::directory_iterator it(root_ + "/" + normalize_symbol(symbol) + "/" + kind_directory(kind),
+                                           error);
+    if (error) return result;
+    for (const std::filesystem::directory_entry& entry : it) {
+        if (entry.path().extension() == ".mmcol") result.push_back(entry.path().stem().string());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool HistoryStore::load_klines(const std::string& symbol, const std::string& first, const std::string& last,
+                               std::vector<Kline>& out) const {
+    out.clear();
+    size_t loaded = 0;
+    std::vector<uint64_t> time;
+    std::vector<double> open, high, low, close, volume;
+    for (const std::string& date : dates(symbol, Kind::Klines)) {
+        if ((!first.empty() && date < first) || (!last.empty() && date > last)) continue;
+        ColumnReader reader(path(symbol, Kind::Klines, date));
+        if (!reader.is_open() || !reader.read_column("open_time_ns", time) || !reader.read_column("open", open) ||
+            !reader.read_column("high", high) || !reader.read_column("low", low) ||
+            !reader.read_column("close", close) || !reader.read_column("volume", volume)) {
+            std::cerr << "History: corrupted klines " << path(symbol, Kind::Klines, date) << std::endl;
+            return false;
+        }
+        size_t base = out.size();
+        out.resize(base + reader.rows());
+        for (size_t i = 0; i < reader.rows(); ++i) {
+            out[base + i] = Kline{time[i], open[i], high[i], low[i], close[i], volume[i]};
+        }
+        ++loaded;
+    }
+    return loaded > 0;
+}
+
+bool HistoryStore::load_trades(const std::string& symbol, const std::string& first, const std::string& last,
+                               std::vector<Trade>& out) const {
+    out.clear();
+    size_t loaded = 0;
+    std::vector<uint64_t> time, buyer_maker;
+    std::vector<double> price, qty;
+    for (const std::string& date : dates(symbol, Kind::Trades)) {
+        if ((!first.empty() && date < first) || (!last.empty() && date > last)) continue;
+        ColumnReader reader(path(symbol, Kind::Trades, date));
+        if (!reader.is_open() || !reader.read_column("time_ns", time) || !reader.read_column("price", price) ||
+            !reader.read_column("qty", qty) || !reader.read_column("buyer_maker", buyer_maker)) {
+            std::cerr << "History: corrupted trades " << path(symbol, Kind::Trades, date) << std::endl;
+            return false;
+        }
+        size_t base = out.size();
+        out.resize(base + reader.rows());
+        for (size_t i = 0; i < reader.rows(); ++i) {
+            out[base + i] = Trade{time[i], price[i], qty[i], buyer_maker[i] != 0};
+        }
+        ++loaded;
+    }
+    return loaded > 0;
+}
@@ -0,0 +1,119 @@
+#include "intensity_calibrator.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Корзины с затухшим числом сделок меньше этого при нормировке считаются пустыми
+constexpr double MIN_BUCKET_WEIGHT = 1e-6;
+
+} // namespace
+
+IntensityCalibrator::IntensityCalibrator(Config config) : config_(config) {
+    config_.bucket_count = std::min(std::max<size_t>(config_.bucket_count, 1), MAX_BUCKETS);
+    config_.min_buckets = std::max<size_t>(config_.min_buckets, 2);
+    if (!(config_.bucket_width > 0.0)) config_.bucket_width = Config().bucket_width;
+    if (config_.halflife_ns == 0) config_.halflife_ns = Config().halflife_ns;
+    tau_ns_ = static_cast<double>(config_.halflife_ns) / std::log(2.0);
+    inv_width_ = 1.0 / config_.bucket_width;
+    reset();
+}
+
+void IntensityCalibrator::reset() {
+    std::fill(counts_, counts_ + MAX_BUCKETS, 0.0);
+    std::fill(log_counts_, log_counts_ + MAX_BUCKETS, 0.0);
+    sum_w_ = sum_wx_ = sum_wxx_ = sum_wy_ = sum_wxy_ = 0.0;
+    nonempty_ = 0;
+    ref_time_ = first_time_ = last_time_ = 0;
+    log_scale_ = 0.0;
+    trades_ = 0;
+    published_.store(Estimate{});
+}
+
+void IntensityCalibrator::observe(double price, double mid, uint64_t time_ns) {
+    if (!(mid > 0.0) || !std::isfinite(price)) return;
+
+    if (trades_ == 0) {
+        ref_time_ = first_time_ = last_time_ = time_ns;
+    } else if (time_ns > last_time_) {
+        last_time_ = time_ns;
+        log_scale_ = static_cast<double>(last_time_ - ref_time_) / tau_ns_;
+        if (log_scale_ > RESCALE_LOG) rescale();
+    }
+    ++trades_;
+
+    double delta = std::fabs(price - mid) * inv_width_;
+    if (delta >= static_cast<double>(config_.bucket_count)) return;
+    size_t bucket = static_cast<size_t>(delta);
+
+    // Старый вклад корзины убираем из сумм, новый добавляем
+    if (counts_[bucket] > 0.0) {
+        add_to_sums(bucket, -1.0);
+    } else {
+        ++nonempty_;
+    }
+    counts_[bucket] += std::exp(log_scale_);
+    log_counts_[bucket] = std::log(counts_[bucket]);
+    add_to_sums(bucket, 1.0);
+
+    Estimate estimate = fit();
+    if (estimate.valid) published_.store(estimate);
+}
+
+IntensityCalibrator::Estimate IntensityCalibrator::fit() const {
+    Estimate result{};
+    result.time_ns = last_time_;
+    result.trades = trades_;
+    result.buckets = nonempty_;
+    if (nonempty_ < config_.min_buckets || last_time_ <= first_time_) return result;
+
+    double det = sum_w_ * sum_wxx_ - sum_wx_ * sum_wx_;
+    if (!(det > 1e-12 * sum_w_ * sum_wxx_)) return result;
+
+    double slope = (sum_w_ * sum_wxy_ - sum_wx_ * sum_wy_) / det;
+    double intercept = (sum_wy_ - slope * sum_wx_) / sum_w_;
+    double k = -slope;
+    if (!(k > 0.0) || !std::isfinite(k)) return result;
+
+    // Затухающее время наблюдения: ∫ e^(−(t_last − s)/τ) ds от первой сделки, в секундах
+    double elapsed = static_cast<double>(last_time_ - first_time_);
+    double exposure_sec = tau_ns_ * -std::expm1(-elapsed / tau_ns_) * 1e-9;
+
+    // ln плотности = ln(A·k): счетчики приводятся к текущему времени и делятся на время и ширину
+    double log_density = intercept - log_scale_ - std::log(exposure_sec * config_.bucket_width);
+    result.A = std::exp(log_density) / k;
+    result.k = k;
+    result.valid = std::isfinite(result.A) ? 1 : 0;
+    return result;
+}
+
+void IntensityCalibrator::add_to_sums(size_t bucket, double sign) {
+    double w = sign * counts_[bucket];
+    double x = (static_cast<double>(bucket) + 0.5) * config_.bucket_width;
+    double y = log_counts_[bucket];
+    sum_w_ += w;
+    sum_wx_ += w * x;
+    sum_wxx_ += w * x * x;
+    sum_wy_ += w * y;
+    sum_wxy_ += w * x * y;
+}
+
+void IntensityCalibrator::rescale() {
+    // Приводим счетчики к весу 1 в last_time_ и пересчитываем суммы без накопленной ошибки
+    double scale = std::exp(-log_scale_);
+    sum_w_ = sum_wx_ = sum_wxx_ = sum_wy_ = sum_wxy_ = 0.0;
+    nonempty_ = 0;
+    for (size_t b = 0; b < config_.bucket_count; ++b) {
+        counts_[b] *= scale;
+        if (counts_[b] < MIN_BUCKET_WEIGHT) {
+            counts_[b] = 0.0;
+            log_counts_[b] = 0.0;
+            continue;
+        }
+        log_counts_[b] = std::log(counts_[b]);
+        add_to_sums(b, 1.0);
+        ++nonempty_;
+    }
+    ref_time_ = last_time_;
+    log_scale_ = 0.0;
+}
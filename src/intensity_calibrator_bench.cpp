@@ -0,0 +1,94 @@
+#include "intensity_calibrator.hpp"
+#include "rng.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Калибровка λ(δ) = A·e^(−kδ) на синтетическом потоке сделок с известными A и k:
+// пуассоновский поток интенсивности A, расстояние от середины ~ Exp(k).
+// Проверяется точность оценки, переход на новый режим за счет затухания,
+// стоимость observe и чтение оценки другим потоком во время записи.
+//   intensity_calibrator_bench [trades] [A] [k]
+
+namespace {
+
+struct Regime {
+    double A;
+    double k;
+};
+
+// Сделки режима regime начиная с времени time_ns; возвращает время последней
+uint64_t feed(IntensityCalibrator& calibrator, Rng& rng, const Regime& regime, size_t trades, uint64_t time_ns) {
+    const double mid = 2000.0;
+    for (size_t i = 0; i < trades; ++i) {
+        time_ns += static_cast<uint64_t>(-std::log1p(-rng.uniform()) / regime.A * 1e9);
+        double delta = -std::log1p(-rng.uniform()) / regime.k;
+        double price = rng.uniform() < 0.5 ? mid - delta : mid + delta;
+        calibrator.observe(price, mid, time_ns);
+    }
+    return time_ns;
+}
+
+void print_estimate(const char* name, const Regime& truth, const IntensityCalibrator::Estimate& e) {
+    std::cout << name << ": A " << e.A << " (true " << truth.A << ", error "
+              << 100.0 * (e.A / truth.A - 1.0) << "%), k " << e.k << " (true " << truth.k
+              << ", error " << 100.0 * (e.k / truth.k - 1.0) << "%), buckets " << e.buckets << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t trades = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    Regime first{argc > 2 ? std::atof(argv[2]) : 20.0, argc > 3 ? std::atof(argv[3]) : 4.0};
+    Regime second{first.A * 2.0, first.k * 1.5};
+
+    // Корзины покрывают δ до 4/k, полураспад — около 2000 сделок первого режима
+    IntensityCalibrator::Config config;
+    config.bucket_count = 32;
+    config.bucket_width = 4.0 / first.k / config.bucket_count;
+    config.halflife_ns = static_cast<uint64_t>(2000.0 / first.A * 1e9);
+    IntensityCalibrator calibrator(config);
+    Rng rng(42);
+
+    uint64_t time_ns = feed(calibrator, rng, first, trades, 0);
+    print_estimate("Regime 1", first, calibrator.estimate());
+
+    // Новый режим: старые сделки забываются через несколько полупериодов
+    time_ns = feed(calibrator, rng, second, trades, time_ns);
+    print_estimate("Regime 2", second, calibrator.estimate());
+
+    // Стоимость observe + публикации на заранее сгенерированных сделках
+    std::vector<double> prices(trades);
+    std::vector<uint64_t> times(trades);
+    for (size_t i = 0; i < trades; ++i) {
+        time_ns += static_cast<uint64_t>(-std::log1p(-rng.uniform()) / second.A * 1e9);
+        double delta = -std::log1p(-rng.uniform()) / second.k;
+        prices[i] = rng.uniform() < 0.5 ? 2000.0 - delta : 2000.0 + delta;
+        times[i] = time_ns;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < trades; ++i) calibrator.observe(prices[i], 2000.0, times[i]);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "observe + publish: " << ns / trades << " ns/trade" << std::endl;
+
+    // Читатель котировок в отдельном потоке: пара A, k без блокировок, писатель не ждет
+    std::atomic<bool> running{true};
+    uint64_t reads = 0;
+    uint64_t invalid = 0;
+    std::thread reader([&]() {
+        while (running.load(std::memory_order_relaxed)) {
+            IntensityCalibrator::Estimate e = calibrator.estimate();
+            if (!e.valid || !(e.k > 0.0) || !(e.A > 0.0)) ++invalid;
+            ++reads;
+        }
+    });
+    feed(calibrator, rng, second, trades, times.back());
+    running = false;
+    reader.join();
+    std::cout << "Concurrent reads: " << reads << ", invalid " << invalid << std::endl;
+    return invalid == 0 ? 0 : 1;
+}
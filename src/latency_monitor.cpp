@@ -0,0 +1,73 @@
+#include "latency_monitor.hpp"
+#include <iomanip>
+
+const char* latency_stage_name(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::ExchangeToReceive: return "exchange->recv";
+        case LatencyStage::ReceiveToParse: return "recv->parse";
+        case LatencyStage::ParseToStrategy: return "parse->strategy";
+        case LatencyStage::StrategyToSpreads: return "strategy->spreads";
+        case LatencyStage::SpreadsToQuote: return "spreads->quote";
+        case LatencyStage::ReceiveToQuote: return "recv->quote";
+        case LatencyStage::Count: break;
+    }
+    return "unknown";
+}
+
+LatencyMonitor::~LatencyMonitor() {
+    stop_reporting();
+}
+
+void LatencyMonitor::report(std::ostream& out, bool interval) {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+
+    out << std::left << std::setw(20) << "stage"
+        << std::right << std::setw(12) << "count"
+        << std::setw(12) << "p50 us"
+        << std::setw(12) << "p99 us"
+        << std::setw(12) << "p99.9 us"
+        << std::setw(12) << "max us" << "\n";
+
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        LatencyHistogram::Snapshot current = histograms_[i].snapshot();
+        LatencyHistogram::Snapshot shown = interval ? current.since(last_report_[i]) : current;
+        if (interval) last_report_[i] = std::move(current);
+        if (shown.total == 0) continue;
+
+        out << std::left << std::setw(20) << latency_stage_name(static_cast<LatencyStage>(i))
+            << std::right << std::setw(12) << shown.total
+            << std::fixed << std::setprecision(2)
+            << ' ' << std::setw(11) << shown.percentile(50.0) / 1e3
+            << ' ' << std::setw(11) << shown.percentile(99.0) / 1e3
+            << ' ' << std::setw(11) << shown.percentile(99.9) / 1e3
+            << ' ' << std::setw(11) << shown.max() / 1e3 << "\n";
+    }
+    out << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void LatencyMonitor::start_reporting(std::chrono::milliseconds period, std::ostream& out) {
+    stop_reporting();
+    {
+        std::lock_guard<std::mutex> lock(reporter_mutex_);
+        reporting_ = true;
+    }
+    reporter_ = std::thread([this, period, &out]() {
+        std::unique_lock<std::mutex> lock(reporter_mutex_);
+        while (!reporter_cv_.wait_for(lock, period, [this]() { return !reporting_; })) {
+            report(out, true);
+        }
+    });
+}
+
+void LatencyMonitor::stop_reporting() {
+    {
+        std::lock_guard<std::mutex> lock(reporter_mutex_);
+        if (!reporting_) return;
+        reporting_ = false;
+    }
+    reporter_cv_.notify_all();
+    reporter_.join();
+}
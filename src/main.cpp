@@ -1,46 +1,312 @@
+#include "binance_client.hpp"
+#include "capture_replay.hpp"
+#include "event_log.hpp"
+#include "feed_runtime.hpp"
+#include "intensity_calibrator.hpp"
+#include "latency_monitor.hpp"
 #include "market_maker.hpp"
+#include "path_generator.hpp"
+#include "quote_pipeline.hpp"
+#include "rng.hpp"
+#include "rolling_volatility.hpp"
 #include "utils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
-int main() {
+namespace {
+
+std::atomic<bool> interrupted{false};
+
+void on_signal(int) {
+    interrupted = true;
+}
+
+// Прежний режим: пошаговая симуляция на заглушках данных.
+// Котировки и сделки пишутся в асинхронный журнал событий, а не в std::cout.
+int run_simulation(const EventLog::Config& log_config, PathModel model) {
+    EventLog log(log_config);
+    if (!log.start()) return 1;
+
     // Используем T = 300 секунд, как указано в задаче
     MarketMaker mm(0.1, 300.0);
+    mm.set_event_log(&log);
 
-    // Симуляция исторических данных для волатильности
-    std::vector<double> prices = {2000.0};
-    double S_t = 2000.0;
+    // k по рыночным сделкам симуляции: отклонения от середины порядка sigma,
+    // поэтому корзины по 0.05 до 1.6 от середины
+    IntensityCalibrator::Config calibration;
+    calibration.bucket_width = 0.05;
+    calibration.bucket_count = 32;
+    IntensityCalibrator calibrator(calibration);
+    mm.set_intensity_calibrator(&calibrator);
+
+    // Волатильность по скользящему окну из 5 доходностей: память фиксирована,
+    // история цен не хранится
+    RollingVolatility volatility({RollingVolatility::Horizon::rolling(5)}, 0, std::sqrt(60.0));
     double trade_size = 1.0;
 
     // Увеличиваем начальную волатильность для более активной торговли
     double initial_sigma = 0.05;  // 5% волатильность
 
-    for (int i = 0; i < 300; ++i) {
-        std::cout << "Step " << i + 1 << ": ";
+    // Путь цены целиком заранее: 1% за шаг от цены заглушки стакана, скачки и
+    // режимы — заметные на 300 шагах
+    PathConfig path_config;
+    path_config.model = model;
+    path_config.steps = 300;
+    path_config.s0 = std::get<0>(mm.get_binance_data("USD+/wETH"));
+    path_config.step_vol = 0.01;
+    path_config.jump_rate = 0.02;
+    path_config.jump_vol = 0.03;
+    path_config.high_vol = 0.03;
+    path_config.p_enter_high = 0.02;
+    path_config.p_exit_high = 0.1;
+    path_config.seed = global_seed();
+    std::vector<double> path(path_config.steps);
+    PathGenerator(path_config).generate(0, 1, path.data());
 
-        // Получение данных (заглушки)
-        auto [mid_price, bid_ask] = mm.get_binance_data("USD+/wETH");
+    for (size_t i = 0; i < path.size(); ++i) {
         auto [gas_cost, latency] = mm.get_onchain_metrics();
-        
-        // Добавляем случайное движение цены для симуляции реального рынка
-        S_t = mid_price + utils::normal_dist(0.0, mid_price * 0.01);  // 1% случайное движение
+        double S_t = path[i];
 
         // Вычисление волатильности
-        double sigma = mm.calculate_volatility(prices, 5);
+        double sigma = volatility.volatility();
         if (sigma < 0.01) sigma = initial_sigma;  // Минимальная волатильность для активной торговли
 
-        // Выводим текущее значение sigma
-        std::cout << "Sigma: " << sigma << ", ";
+        // Интенсивность ордеров step берет из калибратора, а до первой оценки — по стакану или заглушке
+        mm.step(S_t, sigma, latency, gas_cost, trade_size);
+        volatility.update(S_t);
+    }
+
+    log.stop();
+    IntensityCalibrator::Estimate intensity = calibrator.estimate();
+    if (intensity.valid) {
+        std::cerr << "Calibrated intensity: A = " << intensity.A << "/s, k = " << intensity.k
+                  << " over " << intensity.trades << " trades" << std::endl;
+    }
+    EventLog::Stats stats = log.stats();
+    std::cerr << "Event log: " << stats.written << " records written, "
+              << stats.dropped << " dropped" << std::endl;
+    return 0;
+}
 
-        // Интенсивность ордеров (заглушка, позже из книги ордеров)
-        double k = 5.0;  // Уменьшаем k для более широких спредов
+struct FeedOptions {
+    FeedRuntime::Config runtime;
+    std::vector<std::string> symbols{"ethusdt"};
+    std::vector<double> depth_bands{0.001};  // k по глубине ±0.1% от mid; пусто — по top-of-book
+    std::string replay;      // Файл захвата вместо сети (для замеров без подключения)
+    double replay_speed = 1.0;
+    int duration_sec = 0;    // 0 — до Ctrl+C (или до конца захвата)
+};
 
-        mm.step(S_t, sigma, k, latency, gas_cost, trade_size);
+// Живой фид: сетевой поток с BinanceClient и поток стратегии
+int run_feed(const FeedOptions& options) {
+    net::io_context ioc;
+    BinanceClient client(ioc);
+    client.set_depth_bands(options.depth_bands);
+    CexQuotePipeline pipeline(0.1, 300.0);
+    MarketState state{};  // Заполняется потоком стратегии, без аллокаций на тике
+    LatencyMonitor latency;
 
-        // Обновление цены для следующего шага с более выраженным случайным движением
-        S_t += utils::normal_dist(0.0, S_t * 0.02);  // 2% случайное движение
-        prices.push_back(S_t);
+    const double min_sigma = 0.05;
+    const double inventory = 0.0;
+    uint64_t quotes = 0;  // Пишет только поток стратегии
+
+    // Волатильность по каждому символу: окно 60 секунд и EWMA с полураспадом 10 секунд.
+    // Обновляется только потоком стратегии.
+    std::vector<RollingVolatility> volatility;
+    size_t symbol_limit = options.runtime.pipeline.max_symbols;
+    volatility.reserve(symbol_limit);
+    for (size_t i = 0; i < symbol_limit; ++i) {
+        volatility.emplace_back(std::vector<RollingVolatility::Horizon>{
+                                    RollingVolatility::Horizon::timed(60000000000ull),
+                                    RollingVolatility::Horizon::ewma_halflife(10000000000ull)},
+                                4096, std::sqrt(60.0));
     }
 
+    FeedRuntime runtime(ioc, options.runtime, [&](const MarketDataEvent& event) {
+        TickTimestamps ts;
+        ts.event_ns = event.event_time * 1000000;
+        ts.recv_ns = event.recv_time_ns;
+        ts.parse_ns = event.parse_time_ns();
+        ts.strategy_ns = utils::wall_clock_ns();
+
+        double mid = (event.bid_price + event.ask_price) / 2.0;
+        RollingVolatility& vol = volatility[event.symbol_id];
+        vol.update(mid, event.event_time * 1000000);
+        state.price = mid;
+        state.bid = event.bid_price;
+        state.ask = event.ask_price;
+        state.bid_qty = event.bid_qty;
+        state.ask_qty = event.ask_qty;
+        state.k = event.k;
+        state.sigma = std::max(vol.volatility(0), min_sigma);
+        Quote quote = pipeline.quote(state, inventory);
+        ts.spreads_ns = utils::wall_clock_ns();
+
+        // Отправки ордеров пока нет: котировка считается выставленной здесь
+        if (quote.ask > quote.bid) ++quotes;
+        ts.quote_ns = utils::wall_clock_ns();
+        latency.record(ts);
+    });
+
+    auto on_market_data = [&runtime](const BinanceClient::MarketData& md) {
+        runtime.publish(md.to_event());
+    };
+
+    std::unique_ptr<CaptureReplay> replay;
+    std::thread replay_thread;
+    std::atomic<bool> replay_done{false};
+    if (options.replay.empty()) {
+        client.connect_and_subscribe(options.symbols, on_market_data);
+    } else {
+        // Кадры захвата в исходном темпе передаются в io_context, как будто пришли из сокета
+        replay = std::make_unique<CaptureReplay>(std::vector<std::string>{options.replay},
+                                                 CaptureReplay::Mode::Paced, options.replay_speed);
+        client.set_symbols(replay->symbols());
+        client.set_callback(on_market_data);
+        replay_thread = std::thread([&]() {
+            replay->run([&](const CaptureRecordHeader& header, const char* payload) {
+                std::string frame(payload, header.payload_size);
+                std::string symbol(header.symbol);
+                bool snapshot = header.flags & CAPTURE_FLAG_SNAPSHOT;
+                uint64_t recv_time_ns = utils::wall_clock_ns();
+                net::post(ioc, [&client, frame = std::move(frame), symbol = std::move(symbol),
+                                snapshot, recv_time_ns]() {
+                    if (snapshot) {
+                        int32_t id = client.find_symbol(symbol.c_str());
+                        if (id >= 0) client.apply_snapshot(id, frame.data(), frame.size());
+                    } else {
+                        client.process_message(frame.data(), frame.size(), recv_time_ns);
+                    }
+                });
+            });
+            replay_done = true;
+        });
+    }
+
+    runtime.start();
+    auto started = std::chrono::steady_clock::now();
+    while (!interrupted && !replay_done) {
+        if (options.duration_sec > 0 &&
+            std::chrono::steady_clock::now() - started >= std::chrono::seconds(options.duration_sec)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (replay) replay->stop();
+    if (replay_thread.joinable()) replay_thread.join();
+    runtime.stop();
+
+    FeedRuntime::Stats stats = runtime.stats();
+    std::cout << "Runtime: " << FeedRuntime::mode_name(options.runtime.mode)
+              << ", network core " << options.runtime.network_core
+              << ", strategy core " << options.runtime.strategy_core << std::endl;
+    std::cout << "CPU: network " << stats.network.cpu_percent() << "%"
+              << ", strategy " << stats.strategy.cpu_percent() << "%"
+              << " over " << stats.network.wall_sec << " s" << std::endl;
+    if (options.runtime.mode == FeedRuntime::Mode::BusyPoll) {
+        std::cout << "Polls: " << stats.polls << " (" << stats.empty_polls << " empty)" << std::endl;
+    }
+    std::cout << "Events: published " << stats.pipeline.published
+              << ", consumed " << stats.pipeline.consumed
+              << ", conflated " << stats.pipeline.conflated
+              << ", dropped " << stats.pipeline.dropped
+              << ", quotes " << quotes << std::endl;
+    latency.report(std::cout);
     return 0;
-}
\ No newline at end of file
+}
+
+void print_usage() {
+    std::cerr << "Usage: market_maker [simulation options] step simulation\n"
+              << "       market_maker --feed [options]     Binance feed\n"
+              << "  --runtime=blocking|busy-poll\n"
+              << "  --net-core=N --strategy-core=M\n"
+              << "  --symbols=ethusdt,btcusdt\n"
+              << "  --bands=PCT,...                  k from depth within ±PCT of mid (default 0.001; empty: top of book)\n"
+              << "  --duration=SEC\n"
+              << "  --replay=file.mdcap [--speed=X]   captured frames instead of the network\n"
+              << "Simulation options:\n"
+              << "  --seed=N                         reproducible run (random seed by default)\n"
+              << "  --model=gbm|merton|regime        price path model (default gbm)\n"
+              << "  --log=FILE                       event log file (default: text to stdout)\n"
+              << "  --log-format=text|binary         binary logs are read with event_log_decode" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool feed = false;
+    FeedOptions options;
+    EventLog::Config log_config;
+    PathModel model = PathModel::Gbm;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--feed") {
+            feed = true;
+        } else if (arg.rfind("--runtime=", 0) == 0) {
+            if (!FeedRuntime::parse_mode(arg.substr(10), options.runtime.mode)) {
+                print_usage();
+                return 1;
+            }
+        } else if (arg.rfind("--net-core=", 0) == 0) {
+            options.runtime.network_core = std::atoi(arg.c_str() + 11);
+        } else if (arg.rfind("--strategy-core=", 0) == 0) {
+            options.runtime.strategy_core = std::atoi(arg.c_str() + 16);
+        } else if (arg.rfind("--symbols=", 0) == 0) {
+            options.symbols.clear();
+            std::stringstream list(arg.substr(10));
+            std::string symbol;
+            while (std::getline(list, symbol, ',')) {
+                if (!symbol.empty()) options.symbols.push_back(symbol);
+            }
+        } else if (arg.rfind("--bands=", 0) == 0) {
+            options.depth_bands.clear();
+            std::stringstream list(arg.substr(8));
+            std::string pct;
+            while (std::getline(list, pct, ',')) {
+                if (!pct.empty()) options.depth_bands.push_back(std::atof(pct.c_str()));
+            }
+        } else if (arg.rfind("--duration=", 0) == 0) {
+            options.duration_sec = std::atoi(arg.c_str() + 11);
+        } else if (arg.rfind("--replay=", 0) == 0) {
+            feed = true;
+            options.replay = arg.substr(9);
+        } else if (arg.rfind("--speed=", 0) == 0) {
+            options.replay_speed = std::atof(arg.c_str() + 8);
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            set_global_seed(std::strtoull(arg.c_str() + 7, nullptr, 10));
+        } else if (arg == "--model=gbm") {
+            model = PathModel::Gbm;
+        } else if (arg == "--model=merton") {
+            model = PathModel::MertonJump;
+        } else if (arg == "--model=regime") {
+            model = PathModel::RegimeSwitching;
+        } else if (arg.rfind("--log=", 0) == 0) {
+            log_config.path = arg.substr(6);
+        } else if (arg == "--log-format=text") {
+            log_config.format = EventLog::Format::Text;
+        } else if (arg == "--log-format=binary") {
+            log_config.format = EventLog::Format::Binary;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    if (!feed) {
+        return run_simulation(log_config, model);
+    }
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    return run_feed(options);
+}
@@ -0,0 +1,176 @@
+#include "market_data_pipeline.hpp"
+#include "thread_util.hpp"
+#include <iostream>
+#include <utility>
+
+MarketDataPipeline::MarketDataPipeline(const Config& config, EventHandler handler)
+    : config_(config),
+      handler_(std::move(handler)),
+      events_(config.policy == Backpressure::Conflate ? 1 : config.capacity),
+      // В очереди символов каждый символ встречается не более одного раза,
+      // поэтому при Conflate она никогда не переполняется
+      pending_symbols_(config.policy == Backpressure::Conflate ? config.max_symbols : 1),
+      slots_(config.policy == Backpressure::Conflate ? new ConflationSlot[config.max_symbols] : nullptr) {}
+
+MarketDataPipeline::~MarketDataPipeline() {
+    stop();
+}
+
+void MarketDataPipeline::start() {
+    if (running_.exchange(true)) return;
+    consumer_ = std::thread([this]() {
+        if (!pin_current_thread(config_.consumer_core)) {
+            std::cerr << "Failed to pin strategy thread to core " << config_.consumer_core << std::endl;
+        }
+        consume_loop();
+    });
+}
+
+void MarketDataPipeline::stop() {
+    if (!running_.exchange(false)) return;
+    wake_consumer();
+    if (consumer_.joinable()) consumer_.join();
+}
+
+bool MarketDataPipeline::publish(const MarketDataEvent& event) {
+    published_.fetch_add(1, std::memory_order_relaxed);
+
+    switch (config_.policy) {
+        case Backpressure::DropNewest:
+            if (!events_.try_push(event)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            note_queue_depth(events_.size());
+            wake_consumer();
+            return true;
+
+        case Backpressure::Block: {
+            // Короткое ожидание крутимся, затем уступаем CPU потоку стратегии
+            int spins = 0;
+            while (!events_.try_push(event)) {
+                if (++spins < 1000) {
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            note_queue_depth(events_.size());
+            wake_consumer();
+            return true;
+        }
+
+        case Backpressure::Conflate: {
+            if (event.symbol_id >= config_.max_symbols) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            ConflationSlot& slot = slots_[event.symbol_id];
+            slot.latest.store(event);
+
+            // Символ уже ждет в очереди: стратегия прочитает свежий слот
+            if (slot.pending.exchange(true, std::memory_order_acq_rel)) {
+                conflated_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            pending_symbols_.try_push(event.symbol_id);
+            note_queue_depth(pending_symbols_.size());
+            wake_consumer();
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MarketDataPipeline::poll() {
+    size_t processed = 0;
+
+    if (config_.policy == Backpressure::Conflate) {
+        uint32_t symbol_id;
+        while (pending_symbols_.try_pop(symbol_id)) {
+            ConflationSlot& slot = slots_[symbol_id];
+            // Сбрасываем флаг до чтения: более новое событие снова поставит символ в очередь.
+            // Именно RMW, а не store: exchange производителя и этот упорядочены в порядке
+            // модификации pending. Либо производитель увидит false и поставит символ снова,
+            // либо мы прочитаем его true (acquire) и вместе с ним его запись в latest.
+            // Обычный release-store допускал оба промаха сразу (store buffering).
+            slot.pending.exchange(false, std::memory_order_acq_rel);
+            handler_(slot.latest.load());
+            ++processed;
+        }
+    } else {
+        MarketDataEvent event;
+        while (events_.try_pop(event)) {
+            handler_(event);
+            ++processed;
+        }
+    }
+
+    if (processed) consumed_.fetch_add(processed, std::memory_order_relaxed);
+    return processed;
+}
+
+MarketDataPipeline::Stats MarketDataPipeline::stats() const {
+    size_t depth = config_.policy == Backpressure::Conflate ? pending_symbols_.size() : events_.size();
+    return {
+        published_.load(std::memory_order_relaxed),
+        consumed_.load(std::memory_order_relaxed),
+        dropped_.load(std::memory_order_relaxed),
+        conflated_.load(std::memory_order_relaxed),
+        depth,
+        max_queue_depth_.load(std::memory_order_relaxed)
+    };
+}
+
+double MarketDataPipeline::consumer_cpu_seconds() {
+    return consumer_.joinable() ? thread_cpu_seconds(consumer_.native_handle()) : 0.0;
+}
+
+void MarketDataPipeline::consume_loop() {
+    int idle_spins = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (poll()) {
+            idle_spins = 0;
+            continue;
+        }
+        if (config_.idle == IdleStrategy::BusySpin || ++idle_spins < 1000) {
+            cpu_relax();
+        } else if (config_.idle == IdleStrategy::Yield) {
+            std::this_thread::yield();
+        } else {
+            park();
+            idle_spins = 0;
+        }
+    }
+    poll();  // Дочитываем то, что успели опубликовать до остановки
+}
+
+void MarketDataPipeline::park() {
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    parked_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // Повторная проверка под мьютексом: событие, опубликованное до parked_ = true,
+    // иначе пролежало бы в очереди до следующего пробуждения
+    bool empty = config_.policy == Backpressure::Conflate ? pending_symbols_.size() == 0 : events_.size() == 0;
+    if (empty && running_.load(std::memory_order_relaxed)) {
+        park_cv_.wait(lock);
+    }
+    parked_.store(false, std::memory_order_relaxed);
+}
+
+void MarketDataPipeline::wake_consumer() {
+    if (config_.idle != IdleStrategy::Park) return;
+    // Мьютекс берется, только когда потребитель спит, то есть очередь была пуста
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_relaxed)) {
+        { std::lock_guard<std::mutex> lock(park_mutex_); }
+        park_cv_.notify_one();
+    }
+}
+
+void MarketDataPipeline::note_queue_depth(size_t depth) {
+    // Пишет только сетевой поток, поэтому сравнение без CAS корректно
+    if (depth > max_queue_depth_.load(std::memory_order_relaxed)) {
+        max_queue_depth_.store(depth, std::memory_order_relaxed);
+    }
+}
@@ -1,42 +1,23 @@
 #include "market_maker.hpp"
-#include "utils.hpp"
+#include "quote_batch.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
 MarketMaker::MarketMaker(double gamma, double T)
-    : gamma_(gamma), T_(T), inventory_(0.0) {}
+    : gamma_(gamma), T_(T), engine_(gamma, T), inventory_(0.0) {}
 
 std::pair<double, double> MarketMaker::calculate_spreads(double S_t, double sigma, double k, double q_t) {
-    // Точная формула Avellaneda-Stoikov
-    double spread_term = (1.0 / gamma_) * utils::log(1.0 + gamma_ / k);
-    double inventory_term = q_t * sigma * sigma * T_;
-    
-    double delta_a = S_t + spread_term + inventory_term;  // Ask price
-    double delta_b = S_t - spread_term - inventory_term;  // Bid price
-    
-    // Обеспечиваем минимальный спред 0.1% от цены
-    double min_spread = S_t * 0.001;
-    if (delta_a - delta_b < min_spread) {
-        double mid = (delta_a + delta_b) / 2;
-        delta_a = mid + min_spread/2;
-        delta_b = mid - min_spread/2;
-    }
-
-    // Проверка на корректность спредов (delta_a должен быть больше delta_b)
-    if (delta_a <= delta_b) {
-        std::cout << "Warning: Invalid spread calculation detected. "
-                  << "Original delta_a=" << delta_a << ", delta_b=" << delta_b << std::endl;
-        
-        // Обеспечиваем минимальный спред
-        double mid = (delta_a + delta_b) / 2;
-        double min_spread = 0.1;  // Минимальный спред для корректности
-        delta_a = mid + min_spread/2;
-        delta_b = mid - min_spread/2;
-    }
-
+    double delta_a, delta_b;
+    engine_.spreads(S_t, sigma, k, q_t, delta_a, delta_b);
     return {delta_a, delta_b};
 }
 
+void MarketMaker::calculate_spreads_batch(const double* S_t, const double* sigma, const double* k, const double* q,
+                                          double* ask, double* bid, size_t n) const {
+    ::calculate_spreads_batch(gamma_, T_, engine_.min_spread(), S_t, sigma, k, q, ask, bid, n);
+}
+
 std::pair<double, double> MarketMaker::adjust_spreads_for_onchain(double S_t, double delta_a, double delta_b,
                                                                  double latency, double sigma, double gas_cost,
                                                                  double trade_size) {
@@ -47,107 +28,112 @@ std::pair<double, double> MarketMaker::adjust_spreads_for_onchain(double S_t, do
     double gas_penalty = calculate_gas_cost(gas_cost, trade_size);
 
     // Применяем latency_adjustment к обоим спредам
+    double latency_adjustment = adjusted_S_t - S_t;
     double adjusted_delta_a = delta_a + latency_adjustment;
     double adjusted_delta_b = delta_b + latency_adjustment;
 
     return {adjusted_delta_a, adjusted_delta_b};
 }
 
+// Корректировка спредов под PMM-пулы
+std::pair<double, double> MarketMaker::adjust_spreads_for_pmm(double S_t, double delta_a, double delta_b, double pool_depth) {
+    // Упрощенная модель PMM: корректируем спреды в зависимости от глубины пула
+    const double MIN_POOL_DEPTH = 10.0;  // Минимальная значимая глубина пула
+    double depth_factor = std::max(pool_depth, MIN_POOL_DEPTH) / MIN_POOL_DEPTH;
+
+    // Уменьшаем спреды при большей глубине пула
+    double spread_reduction = 1.0 / std::sqrt(depth_factor);
+    double mid_price = (delta_a + delta_b) / 2;
+    double new_delta_a = mid_price + (delta_a - mid_price) * spread_reduction;
+    double new_delta_b = mid_price - (mid_price - delta_b) * spread_reduction;
+
+    return {new_delta_a, new_delta_b};
+}
+
+// Корректировка цены с учетом задержки
+double MarketMaker::adjust_price_with_latency(double S_t, double sigma, double latency) {
+    // Моделируем случайное изменение цены из-за задержки
+    return S_t + fills_.latency_shift(sigma, latency);
+}
+
+// Расчет стоимости газа для сделки
+double MarketMaker::calculate_gas_cost(double gas_price, double trade_size) {
+    return QuoteEngine::gas_cost(gas_price, trade_size);
+}
+
 void MarketMaker::step(double S_t, double sigma, double latency, double gas_cost, double trade_size) {
-    // Получаем данные с биржи
-    auto [mid_price, bid, ask, bid_volume, ask_volume] = get_binance_data("USD+/wETH");
-    
-    // Оцениваем интенсивность ордеров
-    double k = estimate_order_intensity(bid, ask, bid_volume, ask_volume);
-    
-    // Получаем текущий инвентарь
-    double current_inventory = inventory_.get_inventory();
-    
-    // Рассчитываем спреды на основе текущих рыночных условий и инвентаря
-    auto [delta_a, delta_b] = calculate_spreads(S_t, sigma, k, current_inventory);
-    auto [adjusted_delta_a, adjusted_delta_b] = adjust_spreads_for_onchain(S_t, delta_a, delta_b, latency, sigma, gas_cost, trade_size);
-
-    // Корректировка спредов под PMM-пулы
-    std::pair<double, double> MarketMaker::adjust_spreads_for_pmm(double S_t, double delta_a, double delta_b, double pool_depth) {
-        // Упрощенная модель PMM: корректируем спреды в зависимости от глубины пула
-        const double MIN_POOL_DEPTH = 10.0;  // Минимальная значимая глубина пула
-        double depth_factor = std::max(pool_depth, MIN_POOL_DEPTH) / MIN_POOL_DEPTH;
-        
-        // Уменьшаем спреды при большей глубине пула
-        double spread_reduction = 1.0 / std::sqrt(depth_factor);
-        double mid_price = (delta_a + delta_b) / 2;
-        double new_delta_a = mid_price + (delta_a - mid_price) * spread_reduction;
-        double new_delta_b = mid_price - (mid_price - delta_b) * spread_reduction;
-        
-        return {new_delta_a, new_delta_b};
+    // Получаем данные с биржи (из стакана, если он подключен)
+    auto [book_mid, bid, ask, bid_volume, ask_volume] = get_binance_data("USD+/wETH");
+    // Без стакана рынок — симулируемая цена S_t, а не постоянная цена заглушки
+    const bool live_book = book_ && book_->is_synced() && book_->has_top();
+    double mid_price = live_book ? book_mid : S_t;
+
+    MarketState state;
+    state.price = S_t;
+    state.bid = bid;
+    state.ask = ask;
+    state.bid_qty = bid_volume;
+    state.ask_qty = ask_volume;
+    state.sigma = sigma;
+    state.gas_price = gas_cost;
+    state.trade_size = trade_size;
+    state.latency_shift = fills_.latency_shift(sigma, latency);
+    state.pool_depth = 0.0;
+    state.k = live_book ? estimate_order_intensity(*book_) : 0.0;
+    if (calibrator_) {
+        IntensityCalibrator::Estimate calibrated = calibrator_->estimate();
+        if (calibrated.valid) state.k = calibrated.k;
     }
 
-    // Корректировка цены с учетом задержки
-    double MarketMaker::adjust_price_with_latency(double S_t, double sigma, double latency) {
-        // Моделируем случайное изменение цены из-за задержки
-        double latency_adjustment = utils::normal_dist(0.0, sigma * std::sqrt(latency));
-        return S_t + latency_adjustment;
+    double current_inventory = inventory_.get_inventory();
+    StepReport report;
+    report.S_t = S_t;
+    report.quote = engine_.quote(state, current_inventory);
+    report.fill = fills_.simulate(report.quote, mid_price, sigma, current_inventory);
+
+    // Сгенерированная рыночная цена — сделка рынка для калибровки λ(δ)
+    if (calibrator_) {
+        calibrator_->observe(report.fill.market_price, mid_price, sim_time_ns_);
+        sim_time_ns_ += 1000000000ull;
     }
 
-    // Расчет стоимости газа для сделки
-    double MarketMaker::calculate_gas_cost(double gas_price, double trade_size) {
-        // Gas cost = gas_price * gas_limit * trade_size
-        const double GAS_LIMIT_PER_ORDER = 100000;  // Примерное значение gas limit для ордера
-        return (gas_price * GAS_LIMIT_PER_ORDER * trade_size) / 1e18;  // Конвертируем wei в ETH
+    // Выполняем сделки и обновляем инвентарь
+    if (report.fill.side != FillSide::None) {
+        inventory_.update_inventory(trade_size, report.fill.side == FillSide::Buy);
     }
+    report.inventory = inventory_.get_inventory();
 
-    // Генерация независимой рыночной цены (не зависит от reservation_price)
-    double market_price = mid_price + utils::normal_dist(0.0, sigma);
-    
-    // Учет gas_cost при исполнении сделки
-    double gas_penalty = (gas_cost * 100000 * trade_size) / 1e18;
-
-    // Определяем, должны ли произойти сделки на основе рыночной цены и спредов
-    bool is_buy = (market_price <= adjusted_delta_b);
-    bool is_sell = (market_price >= adjusted_delta_a);
-    
-    // Это не должно происходить с нашим улучшенным расчетом спреда, но на всякий случай
-    if (is_buy && is_sell) {
-        std::cout << "Warning: Both buy and sell conditions triggered! "
-                  << "Market price: " << market_price
-                  << ", Ask: " << adjusted_delta_a
-                  << ", Bid: " << adjusted_delta_b << std::endl;
-        
-        // Разрешаем конфликт на основе позиции инвентаря
-        if (current_inventory > 0) {
-            is_buy = false;  // Приоритет продажи для уменьшения положительного инвентаря
-        } else if (current_inventory < 0) {
-            is_sell = false; // Приоритет покупки для уменьшения отрицательного инвентаря
-        } else {
-            // Если инвентарь равен 0, случайно выбираем
-            is_buy = (utils::normal_dist(0, 1) > 0);
-            is_sell = !is_buy;
-        }
-    }
-    
-    // Выполняем сделки и обновляем инвентарь
-    if (is_buy) {
-        inventory_.update_inventory(trade_size, true);
-        std::cout << "Trade: BUY at " << adjusted_delta_b << " (Market price: " << market_price
-                  << ", Gas cost: " << gas_penalty << ") ";
-    } else if (is_sell) {
-        inventory_.update_inventory(trade_size, false);
-        std::cout << "Trade: SELL at " << adjusted_delta_a << " (Market price: " << market_price
-                  << ", Gas cost: " << gas_penalty << ") ";
+    if (log_) {
+        log_step(report, sigma, current_inventory);
     } else {
-        std::cout << "No trade ";
+        print_step_report(std::cout, report);
     }
+}
 
-    // Выводим текущее состояние
-    std::cout << "S_t: " << S_t
-              << ", Inventory: " << inventory_.get_inventory()
-              << ", Base Ask: " << delta_a << ", Base Bid: " << delta_b
-              << ", Adjusted Ask: " << adjusted_delta_a << ", Adjusted Bid: " << adjusted_delta_b
-              << ", Market Price: " << market_price
-              << std::endl;
+void MarketMaker::log_step(const StepReport& report, double sigma, double quoted_inventory) {
+    const Quote& quote = report.quote;
+    const Fill& fill = report.fill;
+
+    if (fill.conflict) {
+        log_->log(LogEventType::Warning, static_cast<uint16_t>(LogWarning::BothSidesTriggered),
+                  {fill.market_price, quote.ask, quote.bid});
+    }
+    log_->log(LogEventType::Quote, 0,
+              {report.S_t, sigma, quote.base_ask, quote.base_bid, quote.ask, quote.bid, quoted_inventory});
+
+    LogFillSide side = fill.side == FillSide::Buy ? LogFillSide::Buy
+                     : fill.side == FillSide::Sell ? LogFillSide::Sell
+                     : LogFillSide::None;
+    log_->log(LogEventType::Fill, static_cast<uint16_t>(side),
+              {fill.price, fill.market_price, quote.gas_cost, report.inventory});
 }
 
 std::tuple<double, double, double, double, double> MarketMaker::get_binance_data(const std::string& pair) {
+    if (book_ && book_->is_synced() && book_->has_top()) {
+        return {book_->mid_price(), book_->best_bid(), book_->best_ask(),
+                book_->best_bid_qty(), book_->best_ask_qty()};
+    }
+
     // Заглушка: mid_price, bid, ask, bid_volume, ask_volume
     // TODO: Подключить Binance API через libcurl или Boost
     double mid_price = 2000.0;
@@ -165,41 +151,35 @@ std::pair<double, double> MarketMaker::get_onchain_metrics() {
 }
 
 double MarketMaker::estimate_order_intensity(double bid, double ask, double bid_volume, double ask_volume) {
-    // Рассчитываем k = (объем ордеров) / (ширина спреда)
-    double spread_width = ask - bid;
-    if (spread_width < 0.0001) spread_width = 0.0001;  // Защита от деления на 0
-    
-    // Используем средний объем в диапазоне ±1% от mid-price
-    double mid_price = (bid + ask) / 2;
-    double range_min = mid_price * 0.99;
-    double range_max = mid_price * 1.01;
-    
-    // В реальной реализации нужно учитывать объемы из стакана
-    // Здесь используем упрощенную модель
-    double total_volume = (bid_volume + ask_volume) / 2;
-    
-    // Интенсивность ордеров (k)
-    double k = total_volume / spread_width;
-    
-    // Ограничиваем k разумными пределами
-    return std::clamp(k, 0.1, 100.0);
+    return QuoteEngine::order_intensity(bid, ask, bid_volume, ask_volume);
 }
 
-double MarketMaker::calculate_volatility(const std::vector<double>& prices, int window) {
-    if (prices.size() < window) return 0.0;
-
-    std::vector<double> returns;
-    for (size_t i = 1; i < prices.size(); ++i) {
-        returns.push_back(std::log(prices[i] / prices[i - 1]));
+double MarketMaker::estimate_order_intensity(const OrderBook& book, size_t band) {
+    if (band < book.depth_band_count()) {
+        return QuoteEngine::depth_intensity(book.bid_band_depth(band), book.ask_band_depth(band),
+                                            book.mid_price(), book.depth_band_pct(band));
     }
+    return estimate_order_intensity(book.best_bid(), book.best_ask(),
+                                    book.best_bid_qty(), book.best_ask_qty());
+}
 
-    double mean = 0.0;
-    for (double r : returns) mean += r;
-    mean /= returns.size();
+double MarketMaker::calculate_volatility(const std::vector<double>& prices, int window) {
+    // Доходности только последних window цен, один проход Welford без аллокаций.
+    // Для потока тиков — RollingVolatility (O(1) на тик).
+    if (window < 2 || prices.size() < static_cast<size_t>(window)) return 0.0;
 
-    double variance = 0.0;
-    for (double r : returns) variance += (r - mean) * (r - mean);
-    variance /= (returns.size() - 1);
+    size_t first = prices.size() - static_cast<size_t>(window);
+    double mean = 0.0;
+    double m2 = 0.0;
+    size_t n = 0;
+    for (size_t i = first + 1; i < prices.size(); ++i) {
+        double r = std::log(prices[i] / prices[i - 1]);
+        ++n;
+        double delta = r - mean;
+        mean += delta / n;
+        m2 += delta * (r - mean);
+    }
+    if (n < 2) return 0.0;
 
-    return std::sqrt(variance) * std::sqrt(60); // Масштабируем до минутной волатильности
+    return std::sqrt(m2 / (n - 1)) * std::sqrt(60); // Масштабируем до минутной волатильности
 }
\ No newline at end of file
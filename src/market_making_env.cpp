@@ -4,7 +4,8 @@
 
 MarketMakingEnv::MarketMakingEnv(MarketMaker& mm) 
     : mm_(mm), current_inventory_(0), current_profit_(0), 
-      current_step_(0), max_steps_(1000), rng_(std::random_device{}()) {}
+      current_step_(0), max_steps_(1000),
+      volatility_({RollingVolatility::Horizon::rolling(5)}, 0, std::sqrt(60.0)) {}
 
 std::vector<double> MarketMakingEnv::reset() {
     current_inventory_ = 0;
@@ -14,10 +15,16 @@ std::vector<double> MarketMakingEnv::reset() {
     // Get initial market data
     auto [mid_price, bid, ask, bid_vol, ask_vol] = mm_.get_binance_data("USD+/wETH");
     auto [gas_price, latency] = mm_.get_onchain_metrics();
+
+    // Episode from history, if attached
+    episode_ = episodes_ ? episodes_->sample(rng_, static_cast<size_t>(max_steps_) + 1) : nullptr;
+    if (episode_) mid_price = episode_[0].close;
     
     // Initialize state
     mid_price_ = mid_price;
-    sigma_ = mm_.calculate_volatility({mid_price}, 1); // Initial volatility
+    volatility_.reset();
+    volatility_.update(mid_price);
+    sigma_ = volatility_.volatility(); // Initial volatility
     latency_ = latency;
     pool_depth_ = 1000.0; // Placeholder for PMM pool depth
     
@@ -41,6 +48,13 @@ std::tuple<std::vector<double>, double, bool> MarketMakingEnv::step(const std::a
     // Track executed trades and update profit
     auto [mid_price, bid, ask, bid_vol, ask_vol] = mm_.get_binance_data("USD+/wETH");
     auto [gas_price, latency] = mm_.get_onchain_metrics();
+    // Эпизод задает цену следующего шага; без эпизода mid_price_ не меняется, как в заглушке
+    if (episode_ && current_step_ <= max_steps_) {
+        mid_price = episode_[current_step_].close;
+        mid_price_ = mid_price;
+    }
+    volatility_.update(mid_price);
+    sigma_ = volatility_.volatility();
     
     // Calculate profit from last step (simplified)
     double spread_profit = (ask - bid) * 0.1; // 10% of spread as profit estimate
@@ -57,6 +71,11 @@ std::tuple<std::vector<double>, double, bool> MarketMakingEnv::step(const std::a
     return {get_state(), reward, done};
 }
 
+void MarketMakingEnv::seed(uint64_t seed) {
+    rng_.seed(seed, 0);
+    mm_.seed(seed, 1);
+}
+
 std::vector<double> MarketMakingEnv::get_state() const {
     return {
         mid_price_,
@@ -1,37 +1,343 @@
-#include "market_maker.hpp"
+#include "backtester.hpp"
+#include "capture_replay.hpp"
+#include "column_file.hpp"
+#include "depth_parser.hpp"
+#include "history_store.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
-#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
+// Бэктест стратегии на L2-данных: файлы захвата (.mdcap), история свечей или
+// сделок из HistoryStore, синтетический стакан.
+// Котировки, задержки, исполнение по очереди и PnL — в Backtester; здесь источник
+// рыночных событий и выборки состояния в колоночный файл (CSV — column_file_csv).
 class MarketSimulator {
 public:
-    MarketSimulator(MarketMaker& mm) : mm_(mm) {}
+    MarketSimulator(Backtester::Config config, const std::string& log_path)
+        : backtester_(config),
+          depth_(std::make_unique<DepthUpdate>()),
+          log_(log_path, {{"time_ns", ColumnType::U64},
+                          {"mid", ColumnType::F64},
+                          {"bid", ColumnType::F64},
+                          {"ask", ColumnType::F64},
+                          {"inventory", ColumnType::F64},
+                          {"cash", ColumnType::F64},
+                          {"equity", ColumnType::F64}}) {
+        backtester_.set_sample_handler([this](const Backtester::Sample& s) {
+            log_.append({s.time_ns, s.mid, s.quote_bid, s.quote_ask, s.inventory, s.cash, s.equity});
+        });
+    }
+
+    bool is_open() const { return log_.is_open(); }
+    bool close_log() { return log_.close(); }
+    ColumnWriter::Stats log_stats() const { return log_.stats(); }
+
+    // Кадры символа symbol (пусто — первого встреченного) из файлов захвата по порядку
+    bool run_capture(const std::vector<std::string>& paths, std::string symbol) {
+        for (const std::string& path : paths) {
+            CaptureReader reader(path);
+            if (!reader.is_open()) {
+                std::cerr << "Cannot open capture " << path << std::endl;
+                return false;
+            }
 
-    void run_simulation(int steps) {
-        std::ofstream log_file("simulation_log.csv");
-        log_file << "step,price,spread\n";
+            const CaptureRecordHeader* header;
+            const char* payload;
+            while (reader.next(header, payload)) {
+                if (symbol.empty()) symbol = header->symbol;
+                if (std::strncmp(header->symbol, symbol.c_str(), sizeof(header->symbol)) != 0) continue;
+
+                const char* data = payload;
+                size_t size = header->payload_size;
+                if (header->flags & CAPTURE_FLAG_SNAPSHOT) {
+                    if (parse_depth_update(data, size, *depth_)) {
+                        backtester_.on_snapshot(*depth_, header->recv_time_ns);
+                    }
+                    continue;
+                }
+
+                const char* stream;
+                size_t stream_size;
+                const char* message;
+                size_t message_size;
+                if (parse_stream_envelope(data, size, stream, stream_size, message, message_size)) {
+                    data = message;
+                    size = message_size;
+                }
+                if (parse_depth_update(data, size, *depth_)) {
+                    backtester_.on_update(*depth_, header->recv_time_ns);
+                }
+            }
+        }
+        backtester_.finish();
+        return true;
+    }
+
+    // Свечи: стакан вокруг open, ближнего к open экстремума, дальнего и close —
+    // четыре точки на свечу, равномерно внутри ее интервала
+    void run_klines(const Kline* klines, size_t count) {
+        uint64_t interval_ns = 60000000000ull;
+        if (count > 1 && klines[1].open_time_ns > klines[0].open_time_ns) {
+            interval_ns = klines[1].open_time_ns - klines[0].open_time_ns;
+        }
+        const int64_t tick = backtester_.tick();
+        for (size_t i = 0; i < count; ++i) {
+            const Kline& k = klines[i];
+            bool high_first = k.high - k.open < k.open - k.low;
+            const double points[4] = {k.open, high_first ? k.high : k.low, high_first ? k.low : k.high, k.close};
+            for (size_t p = 0; p < 4; ++p) {
+                int64_t bid = double_to_fixed(points[p]) / tick * tick;
+                book_at(bid, bid + tick, k.open_time_ns + interval_ns * p / 4);
+            }
+        }
+        backtester_.finish();
+    }
 
-        for (int i = 0; i < steps; ++i) {
-            // Get market data using tuple (no structured binding)
-            auto data = mm_.get_binance_data("USD+/wETH");
-            double mid_price = std::get<0>(data);
-            double bid = std::get<1>(data);
-            double ask = std::get<2>(data);
-            double spread = ask - bid;
-            
-            // Log basic market data
-            log_file << i << ","
-                    << mid_price << ","
-                    << spread << "\n";
+    // Сделки: лучший уровень стакана — цена сделки на стороне, по которой она прошла
+    void run_trades(const std::vector<Trade>& trades) {
+        const int64_t tick = backtester_.tick();
+        for (const Trade& trade : trades) {
+            int64_t price = (double_to_fixed(trade.price) + tick / 2) / tick * tick;
+            if (trade.buyer_maker) {
+                book_at(price, price + tick, trade.time_ns);
+            } else {
+                book_at(price - tick, price, trade.time_ns);
+            }
         }
+        backtester_.finish();
     }
 
+    // Синтетический стакан: случайные изменения объема у вершины, снос лучшего
+    // уровня и новые уровни внутри спреда, шаг 10 мс
+    void run_synthetic(size_t events, uint64_t seed) {
+        const int64_t tick = backtester_.tick();
+        const int64_t lot = double_to_fixed(0.01);
+        Rng rng(seed);
+        auto random_qty = [&]() { return lot * static_cast<int64_t>(1 + rng.next_u64() % 500); };
+
+        // Снапшот: 50 уровней на сторону вокруг 2000
+        DepthUpdate& depth = *depth_;
+        int64_t mid = double_to_fixed(2000.0);
+        depth.first_update_id = depth.final_update_id = 1;
+        depth.bid_count = depth.ask_count = 50;
+        for (size_t i = 0; i < 50; ++i) {
+            depth.bids[i] = PriceLevel{mid - tick * static_cast<int64_t>(i + 1), random_qty()};
+            depth.asks[i] = PriceLevel{mid + tick * static_cast<int64_t>(i + 1), random_qty()};
+        }
+        uint64_t time_ns = 0;
+        backtester_.on_snapshot(depth, time_ns);
+
+        const OrderBook& book = backtester_.book();
+        uint64_t update_id = 1;
+        for (size_t n = 1; n < events; ++n) {
+            time_ns += 10000000;
+            depth.first_update_id = depth.final_update_id = ++update_id;
+            depth.bid_count = depth.ask_count = 0;
+
+            bool bid_side = rng.next_u64() & 1;
+            size_t levels = bid_side ? book.bid_levels() : book.ask_levels();
+            const PriceLevel& best = bid_side ? book.bid(0) : book.ask(0);
+            int64_t away = bid_side ? -tick : tick;
+            PriceLevel level;
+
+            uint64_t action = rng.next_u64() % 10;
+            if (levels < 20) {
+                // Пополнение глубины за худшим уровнем
+                const PriceLevel& worst = bid_side ? book.bid(levels - 1) : book.ask(levels - 1);
+                level = PriceLevel{worst.price + away, random_qty()};
+            } else if (action < 6) {
+                size_t index = rng.next_u64() % 10;
+                level = bid_side ? book.bid(index) : book.ask(index);
+                level.qty = random_qty();
+            } else if (action < 8) {
+                level = PriceLevel{best.price, 0};  // Лучший уровень снесен
+            } else {
+                // Новый лучший уровень, если спред шире тика, иначе уровень позади лучшего
+                bool room = book.ask(0).price - book.bid(0).price > tick;
+                level = PriceLevel{room ? best.price - away : best.price + away, random_qty()};
+            }
+
+            if (bid_side) {
+                depth.bids[depth.bid_count++] = level;
+            } else {
+                depth.asks[depth.ask_count++] = level;
+            }
+            backtester_.on_update(depth, time_ns);
+        }
+        backtester_.finish();
+    }
+
+    Backtester::Stats stats() const { return backtester_.stats(); }
+
 private:
-    MarketMaker& mm_;
+    static constexpr size_t HISTORY_LEVELS = 20;  // Уровней на сторону в стакане из истории
+
+    Backtester backtester_;
+    std::unique_ptr<DepthUpdate> depth_;  // Буфер разбора, переиспользуется между событиями
+    ColumnWriter log_;
+    uint64_t history_update_id_ = 0;
+
+    // Снапшот: HISTORY_LEVELS уровней по тику от bid и ask, объем 1 на уровень
+    void book_at(int64_t bid, int64_t ask, uint64_t time_ns) {
+        const int64_t tick = backtester_.tick();
+        const int64_t qty = double_to_fixed(1.0);
+        DepthUpdate& depth = *depth_;
+        depth.first_update_id = depth.final_update_id = ++history_update_id_;
+        depth.bid_count = depth.ask_count = HISTORY_LEVELS;
+        for (size_t i = 0; i < HISTORY_LEVELS; ++i) {
+            depth.bids[i] = PriceLevel{bid - tick * static_cast<int64_t>(i), qty};
+            depth.asks[i] = PriceLevel{ask + tick * static_cast<int64_t>(i), qty};
+        }
+        backtester_.on_snapshot(depth, time_ns);
+    }
 };
 
-int main() {
-    MarketMaker mm;
-    MarketSimulator simulator(mm);
-    simulator.run_simulation(1000);
+namespace {
+
+void print_usage() {
+    std::cerr << "Usage: market_simulator [options] [capture.mdcap ...]\n"
+              << "  --symbol=ethusdt            symbol tag in the capture (default: first seen) or history symbol\n"
+              << "  --history=DIR               replay cached history (history_import) instead of captures\n"
+              << "  --trades                    history trades instead of klines\n"
+              << "  --from=YYYY-MM-DD --to=YYYY-MM-DD   history days (inclusive)\n"
+              << "  --episode=N                 random window of N klines (--seed) instead of all days\n"
+              << "  --synthetic=N               N synthetic book events (default without captures: 1000000)\n"
+              << "  --seed=N                    synthetic book seed\n"
+              << "  --latency-us=N              decision-to-venue and fill report latency (default 1000)\n"
+              << "  --quote-interval-ms=N       minimum time between quote updates\n"
+              << "  --order-size=X --tick=X --max-inventory=X --fee-bps=X\n"
+              << "  --gamma=X --horizon=SEC\n"
+              << "  --sample-ms=N               sample period (default 1000)\n"
+              << "  --out=FILE                  columnar samples (default simulation_log.mmcol;\n"
+              << "                              column_file_csv converts to CSV)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Backtester::Config config;
+    std::vector<std::string> paths;
+    std::string symbol;
+    std::string out = "simulation_log.mmcol";
+    size_t synthetic = 0;
+    uint64_t seed = 42;
+    std::string history;
+    std::string from;
+    std::string to;
+    bool trades = false;
+    size_t episode = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--symbol=", 0) == 0) {
+            symbol = arg.substr(9);
+        } else if (arg.rfind("--history=", 0) == 0) {
+            history = arg.substr(10);
+        } else if (arg == "--trades") {
+            trades = true;
+        } else if (arg.rfind("--from=", 0) == 0) {
+            from = arg.substr(7);
+        } else if (arg.rfind("--to=", 0) == 0) {
+            to = arg.substr(5);
+        } else if (arg.rfind("--episode=", 0) == 0) {
+            episode = std::strtoull(arg.c_str() + 10, nullptr, 10);
+        } else if (arg.rfind("--synthetic=", 0) == 0) {
+            synthetic = std::strtoull(arg.c_str() + 12, nullptr, 10);
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            seed = std::strtoull(arg.c_str() + 7, nullptr, 10);
+        } else if (arg.rfind("--latency-us=", 0) == 0) {
+            config.order_latency_ns = config.report_latency_ns = std::strtoull(arg.c_str() + 13, nullptr, 10) * 1000;
+        } else if (arg.rfind("--quote-interval-ms=", 0) == 0) {
+            config.quote_interval_ns = std::strtoull(arg.c_str() + 20, nullptr, 10) * 1000000;
+        } else if (arg.rfind("--order-size=", 0) == 0) {
+            config.order_size = std::atof(arg.c_str() + 13);
+        } else if (arg.rfind("--tick=", 0) == 0) {
+            config.tick_size = std::atof(arg.c_str() + 7);
+        } else if (arg.rfind("--max-inventory=", 0) == 0) {
+            config.max_inventory = std::atof(arg.c_str() + 16);
+        } else if (arg.rfind("--fee-bps=", 0) == 0) {
+            config.maker_fee = std::atof(arg.c_str() + 10) * 1e-4;
+        } else if (arg.rfind("--gamma=", 0) == 0) {
+            config.gamma = std::atof(arg.c_str() + 8);
+        } else if (arg.rfind("--horizon=", 0) == 0) {
+            config.T = std::atof(arg.c_str() + 10);
+        } else if (arg.rfind("--sample-ms=", 0) == 0) {
+            config.sample_interval_ns = std::strtoull(arg.c_str() + 12, nullptr, 10) * 1000000;
+        } else if (arg.rfind("--out=", 0) == 0) {
+            out = arg.substr(6);
+        } else if (arg.rfind("--", 0) == 0) {
+            print_usage();
+            return 1;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty() && history.empty() && synthetic == 0) synthetic = 1000000;
+    if (!history.empty() && symbol.empty()) {
+        std::cerr << "--history needs --symbol" << std::endl;
+        return 1;
+    }
+    if (config.tick_size <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    // История загружается до замера: из кэша это миллисекунды
+    HistoryStore store(history);
+    std::vector<Kline> klines;
+    std::vector<Trade> ticks;
+    if (!history.empty()) {
+        bool loaded = trades ? store.load_trades(symbol, from, to, ticks) : store.load_klines(symbol, from, to, klines);
+        if (!loaded) {
+            std::cerr << "No cached " << (trades ? "trades" : "klines") << " for " << symbol << " in " << history
+                      << std::endl;
+            return 1;
+        }
+    }
+    KlineEpisodes episodes(std::move(klines));
+    const Kline* window = episodes.klines().data();
+    size_t window_size = episodes.size();
+    if (episode > 0 && episodes.size() > 0) {
+        Rng rng(seed);
+        window_size = std::min(episode, episodes.size());
+        window = episodes.sample(rng, window_size);
+    }
+
+    MarketSimulator simulator(config, out);
+    if (!simulator.is_open()) return 1;
+    auto start = std::chrono::steady_clock::now();
+    if (!history.empty()) {
+        if (trades) {
+            simulator.run_trades(ticks);
+        } else {
+            simulator.run_klines(window, window_size);
+        }
+    } else if (!paths.empty()) {
+        if (!simulator.run_capture(paths, symbol)) return 1;
+    } else {
+        simulator.run_synthetic(synthetic, seed);
+    }
+    if (!simulator.close_log()) return 1;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    Backtester::Stats stats = simulator.stats();
+    uint64_t events = stats.market_events + stats.internal_events;
+    std::cout << "Events: " << stats.market_events << " market, " << stats.internal_events << " internal in "
+              << elapsed << " s (" << events / elapsed / 1e6 << " M events/s)" << std::endl;
+    std::cout << "Orders: " << stats.order_updates << " sent, " << stats.rejected << " rejected, "
+              << stats.gaps << " book gaps" << std::endl;
+    std::cout << "Fills: " << stats.fills << " (bought " << stats.buy_qty << ", sold " << stats.sell_qty
+              << ", volume " << stats.volume << ", fees " << stats.fees << ")" << std::endl;
+    std::cout << "PnL: equity " << stats.equity << ", cash " << stats.cash << ", inventory " << stats.inventory
+              << ", max |inventory| " << stats.max_abs_inventory << ", max drawdown " << stats.max_drawdown
+              << std::endl;
+    ColumnWriter::Stats log = simulator.log_stats();
+    std::cout << "Samples: " << log.rows << " rows, " << log.file_bytes << " bytes (" << out << ")" << std::endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,211 @@
+#include "order_book.hpp"
+#include <algorithm>
+
+namespace {
+
+bool price_ascending(const PriceLevel& a, const PriceLevel& b) { return a.price < b.price; }
+bool price_descending(const PriceLevel& a, const PriceLevel& b) { return a.price > b.price; }
+
+// Заполнение стороны из снапшота: уровни приходят от лучшего к худшему,
+// берем не больше max_levels лучших и разворачиваем (лучший — в конец)
+void load_side(std::vector<PriceLevel>& side, const PriceLevel* levels, size_t count,
+               size_t max_levels, bool is_bid) {
+    side.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (levels[i].qty > 0) side.push_back(levels[i]);
+    }
+
+    auto worst_first = is_bid ? price_ascending : price_descending;
+    std::sort(side.begin(), side.end(), worst_first);
+    if (side.size() > max_levels) {
+        side.erase(side.begin(), side.end() - max_levels);
+    }
+}
+
+} // namespace
+
+OrderBook::OrderBook(size_t max_levels)
+    : max_levels_(max_levels), last_update_id_(0), synced_(false), awaiting_first_update_(false) {
+    bids_.reserve(max_levels_ + 1);
+    asks_.reserve(max_levels_ + 1);
+}
+
+void OrderBook::reset() {
+    bids_.clear();
+    asks_.clear();
+    last_update_id_ = 0;
+    synced_ = false;
+    awaiting_first_update_ = false;
+    recompute_bands();
+}
+
+void OrderBook::apply_snapshot(const DepthUpdate& snapshot) {
+    load_side(bids_, snapshot.bids, snapshot.bid_count, max_levels_, true);
+    load_side(asks_, snapshot.asks, snapshot.ask_count, max_levels_, false);
+    last_update_id_ = snapshot.final_update_id;
+    synced_ = true;
+    awaiting_first_update_ = true;
+    recompute_bands();
+}
+
+OrderBook::UpdateResult OrderBook::apply_update(const DepthUpdate& update) {
+    if (!synced_) return UpdateResult::NotSynced;
+
+    // Все изменения уже учтены в снапшоте
+    if (update.final_update_id <= last_update_id_) return UpdateResult::Stale;
+
+    // Первое обновление после снапшота должно содержать lastUpdateId + 1,
+    // каждое следующее начинаться ровно с предыдущего u + 1
+    bool in_sequence = awaiting_first_update_
+        ? update.first_update_id <= last_update_id_ + 1
+        : update.first_update_id == last_update_id_ + 1;
+    if (!in_sequence) {
+        reset();
+        return UpdateResult::Gap;
+    }
+
+    for (size_t i = 0; i < update.bid_count; ++i) set_level(bids_, update.bids[i], true);
+    for (size_t i = 0; i < update.ask_count; ++i) set_level(asks_, update.asks[i], false);
+    update_bands();
+
+    last_update_id_ = update.final_update_id;
+    awaiting_first_update_ = false;
+    return UpdateResult::Applied;
+}
+
+void OrderBook::set_level(std::vector<PriceLevel>& side, const PriceLevel& level, bool is_bid) {
+    auto worst_first = is_bid ? price_ascending : price_descending;
+    auto it = std::lower_bound(side.begin(), side.end(), level, worst_first);
+
+    if (it != side.end() && it->price == level.price) {
+        add_band_delta(is_bid, level.price, level.qty - it->qty);
+        if (level.qty == 0) {
+            side.erase(it);
+        } else {
+            it->qty = level.qty;
+        }
+        return;
+    }
+    if (level.qty == 0) return;
+
+    if (side.size() >= max_levels_) {
+        // Стакан заполнен: уровень хуже всех хранимых не нужен,
+        // иначе вытесняем самый дальний от вершины уровень
+        if (it == side.begin()) return;
+        auto pos = it - side.begin();
+        add_band_delta(is_bid, side.front().price, -side.front().qty);
+        side.erase(side.begin());
+        it = side.begin() + (pos - 1);
+    }
+    add_band_delta(is_bid, level.price, level.qty);
+    side.insert(it, level);
+}
+
+bool OrderBook::add_depth_band(double pct) {
+    if (band_count_ == MAX_DEPTH_BANDS) return false;
+    bands_[band_count_++] = DepthBand{pct, 0, 0, 0, 0};
+    recompute_bands();
+    return true;
+}
+
+// Изменение объема на уровне price при старых границах; сдвиг границ — в update_bands
+void OrderBook::add_band_delta(bool is_bid, int64_t price, int64_t delta) {
+    if (!bands_valid_) return;
+    for (size_t b = 0; b < band_count_; ++b) {
+        DepthBand& band = bands_[b];
+        if (is_bid ? price >= band.bid_limit : price <= band.ask_limit) {
+            (is_bid ? band.bid_depth : band.ask_depth) += delta;
+        }
+    }
+}
+
+// Полный пересчет: снапшот, сброс или появление обеих сторон стакана
+void OrderBook::recompute_bands() {
+    bands_valid_ = band_count_ > 0 && has_top();
+    for (size_t b = 0; b < band_count_; ++b) {
+        DepthBand& band = bands_[b];
+        band.bid_depth = 0;
+        band.ask_depth = 0;
+        if (!bands_valid_) continue;
+
+        band.bid_limit = double_to_fixed(mid_price() * (1.0 - band.pct));
+        band.ask_limit = double_to_fixed(mid_price() * (1.0 + band.pct));
+        for (auto it = bids_.rbegin(); it != bids_.rend() && it->price >= band.bid_limit; ++it) {
+            band.bid_depth += it->qty;
+        }
+        for (auto it = asks_.rbegin(); it != asks_.rend() && it->price <= band.ask_limit; ++it) {
+            band.ask_depth += it->qty;
+        }
+    }
+}
+
+// Сдвиг границ за mid-price: добавляются или вычитаются только уровни между
+// старой и новой границей (двоичный поиск + пересеченные уровни)
+void OrderBook::update_bands() {
+    if (band_count_ == 0) return;
+    if (!bands_valid_ || !has_top()) {
+        recompute_bands();
+        return;
+    }
+
+    double mid = mid_price();
+    for (size_t b = 0; b < band_count_; ++b) {
+        DepthBand& band = bands_[b];
+
+        // bids_ по возрастанию: уровни с ценой в [low, high)
+        int64_t bid_limit = double_to_fixed(mid * (1.0 - band.pct));
+        if (bid_limit != band.bid_limit) {
+            int64_t low = std::min(bid_limit, band.bid_limit);
+            int64_t high = std::max(bid_limit, band.bid_limit);
+            auto first = std::lower_bound(bids_.begin(), bids_.end(), PriceLevel{low, 0}, price_ascending);
+            int64_t crossed = 0;
+            for (auto it = first; it != bids_.end() && it->price < high; ++it) crossed += it->qty;
+            band.bid_depth += bid_limit < band.bid_limit ? crossed : -crossed;
+            band.bid_limit = bid_limit;
+        }
+
+        // asks_ по убыванию: уровни с ценой в (low, high]
+        int64_t ask_limit = double_to_fixed(mid * (1.0 + band.pct));
+        if (ask_limit != band.ask_limit) {
+            int64_t low = std::min(ask_limit, band.ask_limit);
+            int64_t high = std::max(ask_limit, band.ask_limit);
+            auto first = std::lower_bound(asks_.begin(), asks_.end(), PriceLevel{high, 0}, price_descending);
+            int64_t crossed = 0;
+            for (auto it = first; it != asks_.end() && it->price > low; ++it) crossed += it->qty;
+            band.ask_depth += ask_limit > band.ask_limit ? crossed : -crossed;
+            band.ask_limit = ask_limit;
+        }
+    }
+}
+
+int64_t OrderBook::bid_qty_at(int64_t price) const {
+    auto it = std::lower_bound(bids_.begin(), bids_.end(), PriceLevel{price, 0}, price_ascending);
+    return it != bids_.end() && it->price == price ? it->qty : 0;
+}
+
+int64_t OrderBook::ask_qty_at(int64_t price) const {
+    auto it = std::lower_bound(asks_.begin(), asks_.end(), PriceLevel{price, 0}, price_descending);
+    return it != asks_.end() && it->price == price ? it->qty : 0;
+}
+
+double OrderBook::bid_depth_within(double pct) const {
+    if (!has_top()) return 0.0;
+    int64_t min_price = double_to_fixed(mid_price() * (1.0 - pct));
+
+    int64_t depth = 0;
+    for (auto it = bids_.rbegin(); it != bids_.rend() && it->price >= min_price; ++it) {
+        depth += it->qty;
+    }
+    return fixed_to_double(depth);
+}
+
+double OrderBook::ask_depth_within(double pct) const {
+    if (!has_top()) return 0.0;
+    int64_t max_price = double_to_fixed(mid_price() * (1.0 + pct));
+
+    int64_t depth = 0;
+    for (auto it = asks_.rbegin(); it != asks_.rend() && it->price <= max_price; ++it) {
+        depth += it->qty;
+    }
+    return fixed_to_double(depth);
+}
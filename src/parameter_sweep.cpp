@@ -0,0 +1,129 @@
+#include "parameter_sweep.hpp"
+#include "column_file.hpp"
+#include "quote_engine.hpp"
+#include "rolling_volatility.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// k по заглушке стакана MarketMaker::get_binance_data (bid/ask ±1, объемы 10 и 8)
+const double SWEEP_ORDER_INTENSITY = QuoteEngine::order_intensity(1999.0, 2001.0, 10.0, 8.0);
+
+} // namespace
+
+PricePaths::PricePaths(Config config, WorkStealingPool* pool)
+    : config_(config),
+      generator_(config.model),
+      prices_(config.paths * config.model.steps),
+      sigma_(config.paths * config.model.steps) {
+    if (pool) {
+        pool->parallel_for(config_.paths, [this](size_t path, size_t) { build(path); });
+    } else {
+        for (size_t path = 0; path < config_.paths; ++path) build(path);
+    }
+}
+
+void PricePaths::build(size_t path) {
+    const size_t steps = config_.model.steps;
+    double* prices = prices_.data() + path * steps;
+    double* sigma = sigma_.data() + path * steps;
+    if (steps == 0) return;
+
+    // sigma до заполнения — рабочий массив генератора
+    generator_.generate_path(path, prices, sigma);
+
+    RollingVolatility volatility({RollingVolatility::Horizon::rolling(60)}, 0, std::sqrt(60.0));
+    for (size_t t = 0; t < steps; ++t) {
+        volatility.update(prices[t]);
+        double vol = volatility.volatility();
+        sigma[t] = vol < 0.01 ? 0.01 : vol;
+    }
+}
+
+SweepResult simulate_sweep_run(const SweepParams& params, const PricePaths& paths, size_t path,
+                               FillSimulator& fills) {
+    QuoteEngine engine(params.gamma, params.T, params.min_spread);
+    const double* prices = paths.prices(path);
+    const double* sigma = paths.sigma(path);
+    const double print_vol = paths.config().model.step_vol;
+
+    MarketState state{};
+    state.trade_size = params.trade_size;
+    state.k = SWEEP_ORDER_INTENSITY;
+
+    SweepResult result{};
+    double cash = 0.0;
+    double inventory = 0.0;
+    double peak = 0.0;
+    double equity = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    for (size_t t = 0; t < paths.steps(); ++t) {
+        double S = prices[t];
+        state.price = S;
+        state.sigma = sigma[t];
+        Quote quote = engine.quote(state, inventory);
+        Fill fill = fills.simulate(quote, S, S * print_vol, inventory);
+
+        if (fill.side == FillSide::Buy) {
+            inventory += params.trade_size;
+            cash -= fill.price * params.trade_size;
+            ++result.fills;
+        } else if (fill.side == FillSide::Sell) {
+            inventory -= params.trade_size;
+            cash += fill.price * params.trade_size;
+            ++result.fills;
+        }
+
+        equity = cash + inventory * S;
+        peak = std::max(peak, equity);
+        result.max_drawdown = std::max(result.max_drawdown, peak - equity);
+
+        // Welford по инвентарю после шага
+        double delta = inventory - mean;
+        mean += delta / static_cast<double>(t + 1);
+        m2 += delta * (inventory - mean);
+    }
+
+    result.pnl = equity;
+    result.final_inventory = inventory;
+    result.inventory_variance = paths.steps() > 1 ? m2 / static_cast<double>(paths.steps() - 1) : 0.0;
+    return result;
+}
+
+std::vector<SweepResult> run_parameter_sweep(const std::vector<SweepParams>& params, const PricePaths& paths,
+                                             WorkStealingPool& pool, uint64_t seed) {
+    std::vector<SweepResult> results(params.size() * paths.paths());
+    const bool common = paths.config().model.common_random_numbers;
+    pool.parallel_for(results.size(), [&](size_t run, size_t) {
+        FillSimulator fills;
+        fills.seed(seed, SWEEP_RUN_STREAM_BASE + (common ? run % paths.paths() : run));
+        results[run] = simulate_sweep_run(params[run / paths.paths()], paths, run % paths.paths(), fills);
+    });
+    return results;
+}
+
+bool write_sweep_results(const std::string& path, const std::vector<SweepParams>& params, size_t paths,
+                         const std::vector<SweepResult>& results) {
+    ColumnWriter writer(path, {{"combo", ColumnType::U64},
+                               {"path", ColumnType::U64},
+                               {"gamma", ColumnType::F64},
+                               {"T", ColumnType::F64},
+                               {"min_spread", ColumnType::F64},
+                               {"trade_size", ColumnType::F64},
+                               {"pnl", ColumnType::F64},
+                               {"inventory_variance", ColumnType::F64},
+                               {"max_drawdown", ColumnType::F64},
+                               {"final_inventory", ColumnType::F64},
+                               {"fills", ColumnType::U64}});
+    if (!writer.is_open()) return false;
+    for (size_t run = 0; run < results.size(); ++run) {
+        const SweepParams& p = params[run / paths];
+        const SweepResult& r = results[run];
+        writer.append({uint64_t(run / paths), uint64_t(run % paths), p.gamma, p.T, p.min_spread, p.trade_size,
+                       r.pnl, r.inventory_variance, r.max_drawdown, r.final_inventory, r.fills});
+    }
+    return writer.close();
+}
@@ -0,0 +1,168 @@
+#include "parameter_sweep.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Перебор gamma, T, минимального спреда и объема сделки на общих ценовых путях.
+// Сетка — все сочетания списков; --random=N — N наборов, равномерно в пределах
+// [min, max] каждого списка. Результаты всех прогонов — в колоночный файл.
+//   parameter_sweep --gamma=0.05,0.1,0.2 --horizon=60,300 --min-spread=0.0005,0.001
+//                   --trade-size=0.5,1 [--random=N] [--paths=16] [--steps=3600]
+//                   [--vol=0.0005] [--model=gbm|merton|regime] [--antithetic] [--crn]
+//                   [--seed=42] [--threads=0] [--pin] [--out=sweep.mmcol]
+
+namespace {
+
+bool parse_list(const std::string& text, std::vector<double>& out) {
+    out.clear();
+    std::stringstream list(text);
+    std::string value;
+    while (std::getline(list, value, ',')) {
+        if (!value.empty()) out.push_back(std::atof(value.c_str()));
+    }
+    return !out.empty();
+}
+
+bool parse_model(const std::string& name, PathModel& model) {
+    if (name == "gbm") {
+        model = PathModel::Gbm;
+    } else if (name == "merton") {
+        model = PathModel::MertonJump;
+    } else if (name == "regime") {
+        model = PathModel::RegimeSwitching;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void print_usage() {
+    std::cerr << "Usage: parameter_sweep [options]\n"
+              << "  --gamma=LIST --horizon=LIST --min-spread=LIST --trade-size=LIST   comma-separated values\n"
+              << "  --random=N          N random sets within [min, max] of each list instead of the grid\n"
+              << "  --paths=N --steps=N --vol=X   shared price paths (X = return stddev per step)\n"
+              << "  --model=NAME        gbm (default), merton (jumps) or regime (two-state volatility)\n"
+              << "  --antithetic        paths in antithetic pairs\n"
+              << "  --crn               common random numbers: path shocks independent of model\n"
+              << "                      parameters, market trades shared by all parameter sets\n"
+              << "  --seed=N            paths, random sets and fill streams\n"
+              << "  --threads=N --pin   worker threads (0 = all cores), pin worker i to core i\n"
+              << "  --out=FILE          columnar results (default sweep.mmcol)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<double> gamma{0.05, 0.1, 0.2, 0.5};
+    std::vector<double> horizon{60.0, 300.0, 900.0};
+    std::vector<double> min_spread{0.0005, 0.001, 0.002};
+    std::vector<double> trade_size{0.5, 1.0};
+    size_t random = 0;
+    size_t threads = 0;
+    bool pin = false;
+    std::string out = "sweep.mmcol";
+    PricePaths::Config path_config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool ok = true;
+        if (arg.rfind("--gamma=", 0) == 0) {
+            ok = parse_list(arg.substr(8), gamma);
+        } else if (arg.rfind("--horizon=", 0) == 0) {
+            ok = parse_list(arg.substr(10), horizon);
+        } else if (arg.rfind("--min-spread=", 0) == 0) {
+            ok = parse_list(arg.substr(13), min_spread);
+        } else if (arg.rfind("--trade-size=", 0) == 0) {
+            ok = parse_list(arg.substr(13), trade_size);
+        } else if (arg.rfind("--random=", 0) == 0) {
+            random = std::strtoull(arg.c_str() + 9, nullptr, 10);
+        } else if (arg.rfind("--paths=", 0) == 0) {
+            path_config.paths = std::strtoull(arg.c_str() + 8, nullptr, 10);
+        } else if (arg.rfind("--steps=", 0) == 0) {
+            path_config.model.steps = std::strtoull(arg.c_str() + 8, nullptr, 10);
+        } else if (arg.rfind("--vol=", 0) == 0) {
+            path_config.model.step_vol = std::atof(arg.c_str() + 6);
+        } else if (arg.rfind("--model=", 0) == 0) {
+            ok = parse_model(arg.substr(8), path_config.model.model);
+        } else if (arg == "--antithetic") {
+            path_config.model.antithetic = true;
+        } else if (arg == "--crn") {
+            path_config.model.common_random_numbers = true;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            path_config.model.seed = std::strtoull(arg.c_str() + 7, nullptr, 10);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = std::strtoull(arg.c_str() + 10, nullptr, 10);
+        } else if (arg == "--pin") {
+            pin = true;
+        } else if (arg.rfind("--out=", 0) == 0) {
+            out = arg.substr(6);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            print_usage();
+            return 1;
+        }
+    }
+    if (path_config.paths == 0 || path_config.model.steps == 0) {
+        print_usage();
+        return 1;
+    }
+
+    std::vector<SweepParams> params;
+    if (random > 0) {
+        // Отдельный поток Rng: наборы не пересекаются с путями и прогонами
+        Rng rng(path_config.model.seed, SWEEP_RUN_STREAM_BASE - 1);
+        auto draw = [&rng](const std::vector<double>& values) {
+            auto [low, high] = std::minmax_element(values.begin(), values.end());
+            return *low + (*high - *low) * rng.uniform();
+        };
+        for (size_t i = 0; i < random; ++i) {
+            params.push_back(SweepParams{draw(gamma), draw(horizon), draw(min_spread), draw(trade_size)});
+        }
+    } else {
+        for (double g : gamma)
+            for (double T : horizon)
+                for (double s : min_spread)
+                    for (double q : trade_size) params.push_back(SweepParams{g, T, s, q});
+    }
+
+    WorkStealingPool pool(threads, pin);
+    auto start = std::chrono::steady_clock::now();
+    PricePaths paths(path_config, &pool);
+    auto built = std::chrono::steady_clock::now();
+    std::vector<SweepResult> results = run_parameter_sweep(params, paths, pool, path_config.model.seed);
+    auto finished = std::chrono::steady_clock::now();
+    if (!write_sweep_results(out, params, paths.paths(), results)) return 1;
+
+    double path_sec = std::chrono::duration<double>(built - start).count();
+    double run_sec = std::chrono::duration<double>(finished - built).count();
+    WorkStealingPool::Stats stats = pool.stats();
+    std::cout << "Sweep: " << params.size() << " parameter sets x " << paths.paths() << " paths x "
+              << paths.steps() << " steps on " << pool.size() << " threads" << std::endl;
+    std::cout << "Paths built in " << path_sec << " s, runs in " << run_sec << " s ("
+              << results.size() / run_sec << " runs/s, "
+              << results.size() * paths.steps() / run_sec / 1e6 << " M steps/s), steals " << stats.steals
+              << std::endl;
+
+    // Лучшие наборы по среднему PnL на путях
+    std::vector<std::pair<double, size_t>> ranking;
+    for (size_t c = 0; c < params.size(); ++c) {
+        double sum = 0.0;
+        for (size_t p = 0; p < paths.paths(); ++p) sum += results[c * paths.paths() + p].pnl;
+        ranking.emplace_back(sum / paths.paths(), c);
+    }
+    std::sort(ranking.rbegin(), ranking.rend());
+    for (size_t i = 0; i < std::min<size_t>(5, ranking.size()); ++i) {
+        const SweepParams& p = params[ranking[i].second];
+        std::cout << "  gamma " << p.gamma << ", T " << p.T << ", min spread " << p.min_spread
+                  << ", trade size " << p.trade_size << ": mean PnL " << ranking[i].first << std::endl;
+    }
+    std::cout << "Results: " << out << " (" << results.size() << " rows)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "path_generator.hpp"
+#include "quote_batch.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Потоки Rng пути: диффузия, скачки (моменты и размеры), смены режима
+enum PathStream : uint64_t {
+    DIFFUSION_STREAM = 0,
+    JUMP_STREAM = 1,
+    REGIME_STREAM = 2,
+    STREAMS_PER_PATH = 3
+};
+
+uint64_t mix(uint64_t h, uint64_t value) {
+    // splitmix64 от h ^ value
+    uint64_t z = h ^ value;
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t mix(uint64_t h, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return mix(h, bits);
+}
+
+uint64_t parameter_hash(const PathConfig& c) {
+    uint64_t h = mix(0, static_cast<uint64_t>(c.model));
+    for (double value : {c.s0, c.drift, c.step_vol, c.jump_rate, c.jump_mean, c.jump_vol,
+                         c.high_vol, c.p_enter_high, c.p_exit_high}) {
+        h = mix(h, value);
+    }
+    return h;
+}
+
+} // namespace
+
+PathGenerator::PathGenerator(PathConfig config)
+    : config_(config),
+      // Старший бит и хеш выше номеров путей: не пересекается с потоками при CRN
+      stream_offset_(config.common_random_numbers ? 0 : (parameter_hash(config) | (1ull << 63)) & ~0xFFFFFFFFFFull),
+      jump_compensator_(config.model == PathModel::MertonJump
+                            ? -config.jump_rate *
+                                  (std::exp(config.jump_mean + 0.5 * config.jump_vol * config.jump_vol) - 1.0)
+                            : 0.0) {}
+
+void PathGenerator::generate(size_t first, size_t count, double* out) const {
+    const size_t steps = config_.steps;
+    if (steps == 0 || count == 0) return;
+
+    std::vector<double> scratch(steps);
+    for (size_t i = 0; i < count; ++i) log_increments(first + i, out + i * steps, scratch.data());
+    // Одна экспонента на всю пачку — самая дорогая часть, векторно
+    batch_exp(out, out, count * steps);
+}
+
+void PathGenerator::generate_path(size_t path, double* out, double* scratch) const {
+    if (config_.steps == 0) return;
+    log_increments(path, out, scratch);
+    batch_exp(out, out, config_.steps);
+}
+
+void PathGenerator::log_increments(size_t path, double* out, double* scratch) const {
+    const size_t steps = config_.steps;
+    // Антитетическая пара (2i, 2i + 1) берет шоки пути 2i
+    const bool mirrored = config_.antithetic && (path & 1) != 0;
+    const uint64_t base = config_.antithetic ? path & ~size_t(1) : path;
+    const uint64_t stream = stream_offset_ + base * STREAMS_PER_PATH;
+    const double sign = mirrored ? -1.0 : 1.0;
+
+    // out[t] — шок шага t (t >= 1); out[0] займет ln s0
+    Rng(config_.seed, stream + DIFFUSION_STREAM).fill_normal(out + 1, steps - 1);
+
+    switch (config_.model) {
+        case PathModel::Gbm: {
+            const double vol = sign * config_.step_vol;
+            const double mu = config_.drift - 0.5 * config_.step_vol * config_.step_vol;
+            for (size_t t = 1; t < steps; ++t) out[t] = mu + vol * out[t];
+            break;
+        }
+        case PathModel::MertonJump: {
+            const double vol = sign * config_.step_vol;
+            const double mu = config_.drift - 0.5 * config_.step_vol * config_.step_vol + jump_compensator_;
+            for (size_t t = 1; t < steps; ++t) out[t] = mu + vol * out[t];
+
+            // Скачки редки: вместо равномерной величины на каждом шаге — геометрические
+            // интервалы между скачками, затем размер скачка. Пара берет одни и те же моменты.
+            if (config_.jump_rate <= 0.0) break;
+            Rng jumps(config_.seed, stream + JUMP_STREAM);
+            const double log_no_jump = std::log1p(-std::min(config_.jump_rate, 1.0 - 1e-16));
+            double t = 0.0;
+            while (true) {
+                t += 1.0 + std::floor(std::log1p(-jumps.uniform()) / log_no_jump);
+                if (t >= static_cast<double>(steps)) break;
+                out[static_cast<size_t>(t)] += config_.jump_mean + sign * config_.jump_vol * jumps.normal();
+            }
+            break;
+        }
+        case PathModel::RegimeSwitching: {
+            // Цепь режимов последовательна, но дешева: массив волатильностей шагов,
+            // затем общий векторизуемый цикл
+            double* vol = scratch;
+            Rng(config_.seed, stream + REGIME_STREAM).fill_uniform(vol + 1, steps - 1);
+            bool high = false;
+            for (size_t t = 1; t < steps; ++t) {
+                high = high ? vol[t] >= config_.p_exit_high : vol[t] < config_.p_enter_high;
+                vol[t] = high ? config_.high_vol : config_.step_vol;
+            }
+            for (size_t t = 1; t < steps; ++t) {
+                out[t] = config_.drift - 0.5 * vol[t] * vol[t] + sign * vol[t] * out[t];
+            }
+            break;
+        }
+    }
+
+    out[0] = std::log(config_.s0);
+    for (size_t t = 1; t < steps; ++t) out[t] += out[t - 1];
+}
@@ -0,0 +1,171 @@
+#include "path_generator.hpp"
+#include "rng.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Пути пачкой (PathGenerator) против прежнего пошагового построения
+// (Rng::normal и std::exp на каждом шаге) на одном и том же числе путей.
+// Проверки: E[S_T] = s0 для всех моделей, снижение дисперсии оценки
+// E[max(S_T - K, 0)] антитетическими путями и разности двух волатильностей
+// на общих случайных числах.
+//   path_generator_bench [paths] [steps]
+
+namespace {
+
+volatile double sink = 0.0;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<double> terminal_prices(const PathConfig& config, size_t paths) {
+    std::vector<double> prices(paths * config.steps);
+    PathGenerator(config).generate(0, paths, prices.data());
+    std::vector<double> terminal(paths);
+    for (size_t p = 0; p < paths; ++p) terminal[p] = prices[(p + 1) * config.steps - 1];
+    return terminal;
+}
+
+// Среднее и стандартная ошибка по независимым наблюдениям
+void mean_error(const std::vector<double>& values, double& mean, double& error) {
+    mean = 0.0;
+    for (double v : values) mean += v;
+    mean /= values.size();
+    double m2 = 0.0;
+    for (double v : values) m2 += (v - mean) * (v - mean);
+    error = std::sqrt(m2 / (values.size() - 1) / values.size());
+}
+
+double call_payoff(double S, double strike) {
+    return std::max(S - strike, 0.0);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t paths = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    size_t steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 3600;
+    paths += paths & 1;  // Антитетические пары
+
+    PathConfig config;
+    config.steps = steps;
+
+    // Прежний способ: шок и экспонента на каждом шаге
+    std::vector<double> reference(paths * steps);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < paths; ++p) {
+        Rng rng(config.seed, p);
+        double S = config.s0;
+        double drift = -0.5 * config.step_vol * config.step_vol;
+        for (size_t t = 0; t < steps; ++t) {
+            if (t > 0) S *= std::exp(drift + config.step_vol * rng.normal());
+            reference[p * steps + t] = S;
+        }
+    }
+    double reference_sec = seconds_since(start);
+    sink = reference[reference.size() - 1];
+
+    const char* names[] = {"gbm", "merton", "regime"};
+    const PathModel models[] = {PathModel::Gbm, PathModel::MertonJump, PathModel::RegimeSwitching};
+    std::vector<double> batch(paths * steps);
+    std::cout << "Paths: " << paths << " x " << steps << " steps" << std::endl;
+    std::cout << "  per-step normal + exp: " << reference_sec * 1e9 / (paths * steps) << " ns/step" << std::endl;
+    for (size_t m = 0; m < 3; ++m) {
+        PathConfig model = config;
+        model.model = models[m];
+        PathGenerator generator(model);
+        start = std::chrono::steady_clock::now();
+        generator.generate(0, paths, batch.data());
+        double sec = seconds_since(start);
+        sink = batch[batch.size() - 1];
+        std::cout << "  " << names[m] << " batch: " << sec * 1e9 / (paths * steps) << " ns/step ("
+                  << reference_sec / sec << "x)" << std::endl;
+    }
+
+    // E[S_T] = s0 (мартингал) — с допуском в 4 стандартные ошибки
+    bool ok = true;
+    for (size_t m = 0; m < 3; ++m) {
+        PathConfig model = config;
+        model.model = models[m];
+        double mean, error;
+        mean_error(terminal_prices(model, paths), mean, error);
+        bool pass = std::abs(mean - config.s0) < 4.0 * error;
+        ok = ok && pass;
+        std::cout << "  " << names[m] << " E[S_T] = " << mean << " +- " << error
+                  << (pass ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Антитетические пары: оценка по средним пар против тех же путей без зеркала
+    const double strike = config.s0;
+    {
+        PathConfig plain = config;
+        PathConfig mirrored = config;
+        mirrored.antithetic = true;
+        std::vector<double> independent = terminal_prices(plain, paths);
+        std::vector<double> antithetic = terminal_prices(mirrored, paths);
+        std::vector<double> plain_pairs(paths / 2), mirrored_pairs(paths / 2);
+        for (size_t i = 0; i < paths / 2; ++i) {
+            plain_pairs[i] = 0.5 * (call_payoff(independent[2 * i], strike) +
+                                    call_payoff(independent[2 * i + 1], strike));
+            mirrored_pairs[i] = 0.5 * (call_payoff(antithetic[2 * i], strike) +
+                                       call_payoff(antithetic[2 * i + 1], strike));
+        }
+        double plain_mean, plain_error, mirrored_mean, mirrored_error;
+        mean_error(plain_pairs, plain_mean, plain_error);
+        mean_error(mirrored_pairs, mirrored_mean, mirrored_error);
+        bool pass = mirrored_error < plain_error;
+        ok = ok && pass;
+        std::cout << "  call payoff: independent " << plain_mean << " +- " << plain_error
+                  << ", antithetic " << mirrored_mean << " +- " << mirrored_error << " ("
+                  << (plain_error / mirrored_error) * (plain_error / mirrored_error)
+                  << "x fewer paths)" << (pass ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Разность двух волатильностей: общие случайные числа против независимых путей
+    {
+        PathConfig low = config;
+        PathConfig high = config;
+        high.step_vol = config.step_vol * 1.1;
+        std::vector<double> difference(paths);
+
+        auto difference_error = [&](bool common) {
+            low.common_random_numbers = common;
+            high.common_random_numbers = common;
+            std::vector<double> a = terminal_prices(low, paths);
+            std::vector<double> b = terminal_prices(high, paths);
+            for (size_t p = 0; p < paths; ++p) difference[p] = call_payoff(b[p], strike) - call_payoff(a[p], strike);
+            double mean, error;
+            mean_error(difference, mean, error);
+            return std::make_pair(mean, error);
+        };
+        auto [independent_mean, independent_error] = difference_error(false);
+        auto [common_mean, common_error] = difference_error(true);
+        bool pass = common_error < independent_error;
+        ok = ok && pass;
+        std::cout << "  vol +10% payoff difference: independent " << independent_mean << " +- "
+                  << independent_error << ", common random numbers " << common_mean << " +- " << common_error
+                  << " (" << (independent_error / common_error) * (independent_error / common_error)
+                  << "x fewer paths)" << (pass ? "" : "  MISMATCH") << std::endl;
+    }
+
+    // Пачки любого размера дают те же пути
+    {
+        PathConfig model = config;
+        model.model = PathModel::MertonJump;
+        model.antithetic = true;
+        PathGenerator generator(model);
+        std::vector<double> whole(paths * steps), parts(paths * steps);
+        generator.generate(0, paths, whole.data());
+        for (size_t first = 0; first < paths; first += 3) {
+            generator.generate(first, std::min<size_t>(3, paths - first), parts.data() + first * steps);
+        }
+        bool pass = whole == parts;
+        ok = ok && pass;
+        std::cout << "  batch split: " << (pass ? "identical" : "MISMATCH") << std::endl;
+    }
+    return ok ? 0 : 1;
+}
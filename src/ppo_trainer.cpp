@@ -2,6 +2,7 @@
 #include <torch/torch.h>
 #include <torch/script.h>
 #include <iostream>
+#include <string>
 
 class PPOTrainer {
 public:
@@ -81,9 +82,36 @@ private:
     torch::optim::Adam optimizer_;
 };
 
-int main() {
+// ppo_trainer [--history=DIR --symbol=ETHUSDT [--from=YYYY-MM-DD] [--to=YYYY-MM-DD]]
+// С историей эпизоды — окна минутных свечей из кэша history_import, иначе заглушки.
+int main(int argc, char* argv[]) {
+    std::string history, symbol, from, to;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--history=", 0) == 0) {
+            history = arg.substr(10);
+        } else if (arg.rfind("--symbol=", 0) == 0) {
+            symbol = arg.substr(9);
+        } else if (arg.rfind("--from=", 0) == 0) {
+            from = arg.substr(7);
+        } else if (arg.rfind("--to=", 0) == 0) {
+            to = arg.substr(5);
+        } else {
+            std::cerr << "Usage: ppo_trainer [--history=DIR --symbol=SYMBOL [--from=DATE] [--to=DATE]]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Kline> klines;
+    if (!history.empty() && !HistoryStore(history).load_klines(symbol, from, to, klines)) {
+        std::cerr << "No cached klines for " << symbol << " in " << history << std::endl;
+        return 1;
+    }
+    KlineEpisodes episodes(std::move(klines));
+
     MarketMaker mm;
     MarketMakingEnv env(mm);
+    if (episodes.size() > 0) env.set_episodes(&episodes);
     PPOTrainer trainer(env);
     
     trainer.train(1000);
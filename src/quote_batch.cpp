@@ -0,0 +1,402 @@
+#include "quote_batch.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+namespace {
+
+// Коэффициенты log из fdlibm (e_log.c): log(1+f) = f - hfsq + s*(hfsq+R)
+constexpr double LG1 = 6.666666666666735130e-01;
+constexpr double LG2 = 3.999999999940941908e-01;
+constexpr double LG3 = 2.857142874366239149e-01;
+constexpr double LG4 = 2.222219843214978396e-01;
+constexpr double LG5 = 1.818357216161805012e-01;
+constexpr double LG6 = 1.531383769920937332e-01;
+constexpr double LG7 = 1.479819860511658591e-01;
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double SQRT2 = 1.41421356237309504880;
+
+// Коэффициенты exp из fdlibm (e_exp.c): exp(r) = 1 + r + r*c/(2 - c), c = r - r²·P(r²)
+constexpr double EP1 = 1.66666666666666019037e-01;
+constexpr double EP2 = -2.77777777770155933842e-03;
+constexpr double EP3 = 6.61375632143793436117e-05;
+constexpr double EP4 = -1.65339022054652515390e-06;
+constexpr double EP5 = 4.13813679705723846039e-08;
+constexpr double INV_LN2 = 1.44269504088896338700e+00;
+constexpr double EXP_MIN = -708.0;  // Результат остается нормальным числом
+constexpr double EXP_MAX = 709.0;
+constexpr double ROUND_MAGIC = 6755399441055744.0;  // 1.5·2^52: целая часть в младших битах
+
+constexpr uint64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFull;
+constexpr uint64_t ONE_BITS = 0x3FF0000000000000ull;
+constexpr uint64_t TWO52_BITS = 0x4330000000000000ull;  // 2^52: целое в младших битах мантиссы
+constexpr double TWO52 = 4503599627370496.0;
+
+constexpr double FALLBACK_SPREAD = 0.1;  // Как в calculate_spreads при ask <= bid
+
+// Скалярный вариант той же последовательности операций, что и в SIMD-ядрах
+inline double log_poly(double x) {
+    uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    double e = static_cast<double>(static_cast<int64_t>(bits >> 52)) - 1023.0;
+    uint64_t mantissa_bits = (bits & MANTISSA_MASK) | ONE_BITS;
+    double m;
+    std::memcpy(&m, &mantissa_bits, sizeof(m));
+
+    // m в [1, 2) -> [sqrt(2)/2, sqrt(2))
+    bool big = m > SQRT2;
+    m = big ? m * 0.5 : m;
+    e = big ? e + 1.0 : e;
+
+    double f = m - 1.0;
+    double hfsq = 0.5 * f * f;
+    double s = f / (2.0 + f);
+    double z = s * s;
+    double w = z * z;
+    double t1 = w * (LG2 + w * (LG4 + w * LG6));
+    double t2 = z * (LG1 + w * (LG3 + w * (LG5 + w * LG7)));
+    double r = t2 + t1;
+    return e * LN2_HI - ((hfsq - (s * (hfsq + r) + e * LN2_LO)) - f);
+}
+
+// exp(x) = 2^k · exp(r), k = round(x / ln 2); 2^k добавляется к показателю напрямую
+inline double exp_poly(double x) {
+    x = x < EXP_MIN ? EXP_MIN : (x > EXP_MAX ? EXP_MAX : x);
+    double k = std::nearbyint(x * INV_LN2);
+    double hi = x - k * LN2_HI;
+    double lo = k * LN2_LO;
+    double r = hi - lo;
+    double t = r * r;
+    double c = r - t * (EP1 + t * (EP2 + t * (EP3 + t * (EP4 + t * EP5))));
+    double y = 1.0 - ((lo - (r * c) / (2.0 - c)) - hi);
+
+    uint64_t bits;
+    std::memcpy(&bits, &y, sizeof(bits));
+    bits += static_cast<uint64_t>(static_cast<int64_t>(k)) << 52;
+    std::memcpy(&y, &bits, sizeof(y));
+    return y;
+}
+
+inline void quote_scalar(double gamma, double T, double min_fraction, double S, double sigma, double k, double q,
+                         double& ask, double& bid) {
+    double spread_term = log_poly(1.0 + gamma / k) / gamma;
+    double inventory_term = q * sigma * sigma * T;
+    double a = S + spread_term + inventory_term;
+    double b = S - spread_term - inventory_term;
+
+    double mid = (a + b) * 0.5;
+    double min_spread = S * min_fraction;
+    bool narrow = a - b < min_spread;
+    a = narrow ? mid + min_spread * 0.5 : a;
+    b = narrow ? mid - min_spread * 0.5 : b;
+
+    bool invalid = a <= b;
+    ask = invalid ? mid + FALLBACK_SPREAD * 0.5 : a;
+    bid = invalid ? mid - FALLBACK_SPREAD * 0.5 : b;
+}
+
+void spreads_scalar(double gamma, double T, double min_fraction, const double* S_t, const double* sigma,
+                    const double* k, const double* q, double* ask, double* bid, size_t begin, size_t n) {
+    for (size_t i = begin; i < n; ++i) {
+        double a;
+        double b;
+        quote_scalar(gamma, T, min_fraction, S_t[i], sigma[i], k[i], q[i], a, b);
+        ask[i] = a;
+        bid[i] = b;
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256d log_avx2(__m256d x) {
+    __m256i bits = _mm256_castpd_si256(x);
+    __m256i exponent_bits = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                            _mm256_set1_epi64x(static_cast<long long>(TWO52_BITS)));
+    __m256d e = _mm256_sub_pd(_mm256_sub_pd(_mm256_castsi256_pd(exponent_bits), _mm256_set1_pd(TWO52)),
+                              _mm256_set1_pd(1023.0));
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+        _mm256_and_si256(bits, _mm256_set1_epi64x(static_cast<long long>(MANTISSA_MASK))),
+        _mm256_set1_epi64x(static_cast<long long>(ONE_BITS))));
+
+    __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(SQRT2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, _mm256_set1_pd(1.0)));
+
+    __m256d f = _mm256_sub_pd(m, _mm256_set1_pd(1.0));
+    __m256d hfsq = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), f), f);
+    __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+    __m256d z = _mm256_mul_pd(s, s);
+    __m256d w = _mm256_mul_pd(z, z);
+    __m256d t1 = _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(LG2), _mm256_mul_pd(w,
+                 _mm256_add_pd(_mm256_set1_pd(LG4), _mm256_mul_pd(w, _mm256_set1_pd(LG6))))));
+    __m256d t2 = _mm256_mul_pd(z, _mm256_add_pd(_mm256_set1_pd(LG1), _mm256_mul_pd(w,
+                 _mm256_add_pd(_mm256_set1_pd(LG3), _mm256_mul_pd(w,
+                 _mm256_add_pd(_mm256_set1_pd(LG5), _mm256_mul_pd(w, _mm256_set1_pd(LG7))))))));
+    __m256d r = _mm256_add_pd(t2, t1);
+
+    __m256d inner = _mm256_add_pd(_mm256_mul_pd(s, _mm256_add_pd(hfsq, r)),
+                                  _mm256_mul_pd(e, _mm256_set1_pd(LN2_LO)));
+    return _mm256_sub_pd(_mm256_mul_pd(e, _mm256_set1_pd(LN2_HI)),
+                         _mm256_sub_pd(_mm256_sub_pd(hfsq, inner), f));
+}
+
+__attribute__((target("avx2")))
+void spreads_avx2(double gamma, double T, double min_fraction, const double* S_t, const double* sigma, const double* k,
+                  const double* q, double* ask, double* bid, size_t n) {
+    const __m256d vgamma = _mm256_set1_pd(gamma);
+    const __m256d vT = _mm256_set1_pd(T);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    const __m256d vmin_fraction = _mm256_set1_pd(min_fraction);
+    const __m256d fallback_half = _mm256_set1_pd(FALLBACK_SPREAD * 0.5);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d S = _mm256_loadu_pd(S_t + i);
+        __m256d sig = _mm256_loadu_pd(sigma + i);
+        __m256d vk = _mm256_loadu_pd(k + i);
+        __m256d vq = _mm256_loadu_pd(q + i);
+
+        __m256d spread_term = _mm256_div_pd(log_avx2(_mm256_add_pd(one, _mm256_div_pd(vgamma, vk))), vgamma);
+        __m256d inventory_term = _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(vq, sig), sig), vT);
+        __m256d a = _mm256_add_pd(_mm256_add_pd(S, spread_term), inventory_term);
+        __m256d b = _mm256_sub_pd(_mm256_sub_pd(S, spread_term), inventory_term);
+
+        __m256d mid = _mm256_mul_pd(_mm256_add_pd(a, b), half);
+        __m256d min_spread = _mm256_mul_pd(S, vmin_fraction);
+        __m256d min_half = _mm256_mul_pd(min_spread, half);
+        __m256d narrow = _mm256_cmp_pd(_mm256_sub_pd(a, b), min_spread, _CMP_LT_OQ);
+        a = _mm256_blendv_pd(a, _mm256_add_pd(mid, min_half), narrow);
+        b = _mm256_blendv_pd(b, _mm256_sub_pd(mid, min_half), narrow);
+
+        __m256d invalid = _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+        _mm256_storeu_pd(ask + i, _mm256_blendv_pd(a, _mm256_add_pd(mid, fallback_half), invalid));
+        _mm256_storeu_pd(bid + i, _mm256_blendv_pd(b, _mm256_sub_pd(mid, fallback_half), invalid));
+    }
+    spreads_scalar(gamma, T, min_fraction, S_t, sigma, k, q, ask, bid, i, n);
+}
+
+__attribute__((target("avx512f")))
+inline __m512d log_avx512(__m512d x) {
+    __m512i bits = _mm512_castpd_si512(x);
+    // maskz-вариант: у _mm512_srli_epi64 в GCC 12 ложное предупреждение о неинициализированном регистре
+    __m512i exponent_bits = _mm512_or_si512(_mm512_maskz_srli_epi64(0xFF, bits, 52),
+                                            _mm512_set1_epi64(static_cast<long long>(TWO52_BITS)));
+    __m512d e = _mm512_sub_pd(_mm512_sub_pd(_mm512_castsi512_pd(exponent_bits), _mm512_set1_pd(TWO52)),
+                              _mm512_set1_pd(1023.0));
+    __m512d m = _mm512_castsi512_pd(_mm512_or_si512(
+        _mm512_and_si512(bits, _mm512_set1_epi64(static_cast<long long>(MANTISSA_MASK))),
+        _mm512_set1_epi64(static_cast<long long>(ONE_BITS))));
+
+    __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(SQRT2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, big, e, _mm512_set1_pd(1.0));
+
+    __m512d f = _mm512_sub_pd(m, _mm512_set1_pd(1.0));
+    __m512d hfsq = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(0.5), f), f);
+    __m512d s = _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+    __m512d z = _mm512_mul_pd(s, s);
+    __m512d w = _mm512_mul_pd(z, z);
+    __m512d t1 = _mm512_mul_pd(w, _mm512_add_pd(_mm512_set1_pd(LG2), _mm512_mul_pd(w,
+                 _mm512_add_pd(_mm512_set1_pd(LG4), _mm512_mul_pd(w, _mm512_set1_pd(LG6))))));
+    __m512d t2 = _mm512_mul_pd(z, _mm512_add_pd(_mm512_set1_pd(LG1), _mm512_mul_pd(w,
+                 _mm512_add_pd(_mm512_set1_pd(LG3), _mm512_mul_pd(w,
+                 _mm512_add_pd(_mm512_set1_pd(LG5), _mm512_mul_pd(w, _mm512_set1_pd(LG7))))))));
+    __m512d r = _mm512_add_pd(t2, t1);
+
+    __m512d inner = _mm512_add_pd(_mm512_mul_pd(s, _mm512_add_pd(hfsq, r)),
+                                  _mm512_mul_pd(e, _mm512_set1_pd(LN2_LO)));
+    return _mm512_sub_pd(_mm512_mul_pd(e, _mm512_set1_pd(LN2_HI)),
+                         _mm512_sub_pd(_mm512_sub_pd(hfsq, inner), f));
+}
+
+__attribute__((target("avx512f")))
+void spreads_avx512(double gamma, double T, double min_fraction, const double* S_t, const double* sigma,
+                    const double* k, const double* q, double* ask, double* bid, size_t n) {
+    const __m512d vgamma = _mm512_set1_pd(gamma);
+    const __m512d vT = _mm512_set1_pd(T);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d half = _mm512_set1_pd(0.5);
+    const __m512d vmin_fraction = _mm512_set1_pd(min_fraction);
+    const __m512d fallback_half = _mm512_set1_pd(FALLBACK_SPREAD * 0.5);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d S = _mm512_loadu_pd(S_t + i);
+        __m512d sig = _mm512_loadu_pd(sigma + i);
+        __m512d vk = _mm512_loadu_pd(k + i);
+        __m512d vq = _mm512_loadu_pd(q + i);
+
+        __m512d spread_term = _mm512_div_pd(log_avx512(_mm512_add_pd(one, _mm512_div_pd(vgamma, vk))), vgamma);
+        __m512d inventory_term = _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(vq, sig), sig), vT);
+        __m512d a = _mm512_add_pd(_mm512_add_pd(S, spread_term), inventory_term);
+        __m512d b = _mm512_sub_pd(_mm512_sub_pd(S, spread_term), inventory_term);
+
+        __m512d mid = _mm512_mul_pd(_mm512_add_pd(a, b), half);
+        __m512d min_spread = _mm512_mul_pd(S, vmin_fraction);
+        __m512d min_half = _mm512_mul_pd(min_spread, half);
+        __mmask8 narrow = _mm512_cmp_pd_mask(_mm512_sub_pd(a, b), min_spread, _CMP_LT_OQ);
+        a = _mm512_mask_blend_pd(narrow, a, _mm512_add_pd(mid, min_half));
+        b = _mm512_mask_blend_pd(narrow, b, _mm512_sub_pd(mid, min_half));
+
+        __mmask8 invalid = _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ);
+        _mm512_storeu_pd(ask + i, _mm512_mask_blend_pd(invalid, a, _mm512_add_pd(mid, fallback_half)));
+        _mm512_storeu_pd(bid + i, _mm512_mask_blend_pd(invalid, b, _mm512_sub_pd(mid, fallback_half)));
+    }
+    spreads_scalar(gamma, T, min_fraction, S_t, sigma, k, q, ask, bid, i, n);
+}
+
+__attribute__((target("avx2")))
+void log_array_avx2(const double* x, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, log_avx2(_mm256_loadu_pd(x + i)));
+    for (; i < n; ++i) out[i] = log_poly(x[i]);
+}
+
+__attribute__((target("avx512f")))
+void log_array_avx512(const double* x, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(out + i, log_avx512(_mm512_loadu_pd(x + i)));
+    for (; i < n; ++i) out[i] = log_poly(x[i]);
+}
+
+__attribute__((target("avx2")))
+inline __m256d exp_avx2(__m256d x) {
+    x = _mm256_min_pd(_mm256_max_pd(x, _mm256_set1_pd(EXP_MIN)), _mm256_set1_pd(EXP_MAX));
+    __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(INV_LN2)),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d hi = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(LN2_HI)));
+    __m256d lo = _mm256_mul_pd(k, _mm256_set1_pd(LN2_LO));
+    __m256d r = _mm256_sub_pd(hi, lo);
+    __m256d t = _mm256_mul_pd(r, r);
+    __m256d p = _mm256_add_pd(_mm256_set1_pd(EP1), _mm256_mul_pd(t,
+                _mm256_add_pd(_mm256_set1_pd(EP2), _mm256_mul_pd(t,
+                _mm256_add_pd(_mm256_set1_pd(EP3), _mm256_mul_pd(t,
+                _mm256_add_pd(_mm256_set1_pd(EP4), _mm256_mul_pd(t, _mm256_set1_pd(EP5)))))))));
+    __m256d c = _mm256_sub_pd(r, _mm256_mul_pd(t, p));
+    __m256d y = _mm256_sub_pd(_mm256_set1_pd(1.0),
+                              _mm256_sub_pd(_mm256_sub_pd(lo, _mm256_div_pd(_mm256_mul_pd(r, c),
+                                                                            _mm256_sub_pd(_mm256_set1_pd(2.0), c))),
+                                            hi));
+
+    // k в целое без AVX-512DQ: k + 1.5·2^52 хранит k в младших битах мантиссы
+    __m256i magic = _mm256_castpd_si256(_mm256_set1_pd(ROUND_MAGIC));
+    __m256i ki = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(ROUND_MAGIC))), magic);
+    return _mm256_castsi256_pd(_mm256_add_epi64(_mm256_castpd_si256(y), _mm256_slli_epi64(ki, 52)));
+}
+
+__attribute__((target("avx512f")))
+inline __m512d exp_avx512(__m512d x) {
+    x = _mm512_maskz_min_pd(0xFF, _mm512_maskz_max_pd(0xFF, x, _mm512_set1_pd(EXP_MIN)), _mm512_set1_pd(EXP_MAX));
+    __m512d k = _mm512_maskz_roundscale_pd(0xFF, _mm512_mul_pd(x, _mm512_set1_pd(INV_LN2)),
+                                           _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d hi = _mm512_sub_pd(x, _mm512_mul_pd(k, _mm512_set1_pd(LN2_HI)));
+    __m512d lo = _mm512_mul_pd(k, _mm512_set1_pd(LN2_LO));
+    __m512d r = _mm512_sub_pd(hi, lo);
+    __m512d t = _mm512_mul_pd(r, r);
+    __m512d p = _mm512_add_pd(_mm512_set1_pd(EP1), _mm512_mul_pd(t,
+                _mm512_add_pd(_mm512_set1_pd(EP2), _mm512_mul_pd(t,
+                _mm512_add_pd(_mm512_set1_pd(EP3), _mm512_mul_pd(t,
+                _mm512_add_pd(_mm512_set1_pd(EP4), _mm512_mul_pd(t, _mm512_set1_pd(EP5)))))))));
+    __m512d c = _mm512_sub_pd(r, _mm512_mul_pd(t, p));
+    __m512d y = _mm512_sub_pd(_mm512_set1_pd(1.0),
+                              _mm512_sub_pd(_mm512_sub_pd(lo, _mm512_div_pd(_mm512_mul_pd(r, c),
+                                                                            _mm512_sub_pd(_mm512_set1_pd(2.0), c))),
+                                            hi));
+
+    __m512i magic = _mm512_castpd_si512(_mm512_set1_pd(ROUND_MAGIC));
+    __m512i ki = _mm512_sub_epi64(_mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(ROUND_MAGIC))), magic);
+    // maskz-вариант сдвига — по той же причине, что и в log_avx512
+    return _mm512_castsi512_pd(_mm512_add_epi64(_mm512_castpd_si512(y), _mm512_maskz_slli_epi64(0xFF, ki, 52)));
+}
+
+__attribute__((target("avx2")))
+void exp_array_avx2(const double* x, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) _mm256_storeu_pd(out + i, exp_avx2(_mm256_loadu_pd(x + i)));
+    for (; i < n; ++i) out[i] = exp_poly(x[i]);
+}
+
+__attribute__((target("avx512f")))
+void exp_array_avx512(const double* x, double* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) _mm512_storeu_pd(out + i, exp_avx512(_mm512_loadu_pd(x + i)));
+    for (; i < n; ++i) out[i] = exp_poly(x[i]);
+}
+
+SimdLevel clamp_level(SimdLevel level) {
+    SimdLevel available = detect_simd_level();
+    return static_cast<int>(level) > static_cast<int>(available) ? available : level;
+}
+
+} // namespace
+
+SimdLevel detect_simd_level() {
+    static const SimdLevel level = []() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::Avx512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+        return SimdLevel::Scalar;
+    }();
+    return level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx512: return "avx512";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Scalar: break;
+    }
+    return "scalar";
+}
+
+void calculate_spreads_batch(double gamma, double T, double min_spread,
+                             const double* S_t, const double* sigma, const double* k, const double* q,
+                             double* ask, double* bid, size_t n) {
+    calculate_spreads_batch(gamma, T, min_spread, S_t, sigma, k, q, ask, bid, n, detect_simd_level());
+}
+
+void calculate_spreads_batch(double gamma, double T, double min_spread,
+                             const double* S_t, const double* sigma, const double* k, const double* q,
+                             double* ask, double* bid, size_t n, SimdLevel level) {
+    switch (clamp_level(level)) {
+        case SimdLevel::Avx512:
+            spreads_avx512(gamma, T, min_spread, S_t, sigma, k, q, ask, bid, n);
+            return;
+        case SimdLevel::Avx2:
+            spreads_avx2(gamma, T, min_spread, S_t, sigma, k, q, ask, bid, n);
+            return;
+        case SimdLevel::Scalar:
+            spreads_scalar(gamma, T, min_spread, S_t, sigma, k, q, ask, bid, 0, n);
+            return;
+    }
+}
+
+void batch_log(const double* x, double* out, size_t n, SimdLevel level) {
+    switch (clamp_level(level)) {
+        case SimdLevel::Avx512:
+            log_array_avx512(x, out, n);
+            return;
+        case SimdLevel::Avx2:
+            log_array_avx2(x, out, n);
+            return;
+        case SimdLevel::Scalar:
+            for (size_t i = 0; i < n; ++i) out[i] = log_poly(x[i]);
+            return;
+    }
+}
+
+void batch_exp(const double* x, double* out, size_t n, SimdLevel level) {
+    switch (clamp_level(level)) {
+        case SimdLevel::Avx512:
+            exp_array_avx512(x, out, n);
+            return;
+        case SimdLevel::Avx2:
+            exp_array_avx2(x, out, n);
+            return;
+        case SimdLevel::Scalar:
+            for (size_t i = 0; i < n; ++i) out[i] = exp_poly(x[i]);
+            return;
+    }
+}
@@ -0,0 +1,87 @@
+#include "market_maker.hpp"
+#include "quote_batch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Пакетный расчет котировок против поштучного MarketMaker::calculate_spreads:
+// время на котировку по каждому ядру и максимальное расхождение с эталоном.
+//   quote_batch_bench [n] [rounds]
+
+namespace {
+
+volatile double sink = 0.0;
+
+template <class F>
+double ns_per_quote(F&& f, size_t n, int rounds) {
+    f();  // Прогрев
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) f();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (static_cast<double>(n) * rounds);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+
+    const double gamma = 0.1;
+    const double T = 300.0;
+    MarketMaker mm(gamma, T);
+    const double min_spread = mm.quote_engine().min_spread();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> price(1000.0, 3000.0);
+    std::uniform_real_distribution<double> vol(0.001, 0.05);
+    std::uniform_real_distribution<double> intensity(0.05, 50.0);
+    std::uniform_real_distribution<double> inventory(-10.0, 10.0);
+
+    std::vector<double> S(n), sigma(n), k(n), q(n);
+    for (size_t i = 0; i < n; ++i) {
+        S[i] = price(rng);
+        sigma[i] = vol(rng);
+        k[i] = intensity(rng);
+        q[i] = inventory(rng);
+    }
+
+    std::vector<double> ref_ask(n), ref_bid(n), ask(n), bid(n);
+    double scalar_ns = ns_per_quote([&]() {
+        for (size_t i = 0; i < n; ++i) {
+            auto [a, b] = mm.calculate_spreads(S[i], sigma[i], k[i], q[i]);
+            ref_ask[i] = a;
+            ref_bid[i] = b;
+        }
+        sink = sink + ref_ask[n - 1];
+    }, n, rounds);
+
+    std::cout << "Quotes per call: " << n << ", detected: " << simd_level_name(detect_simd_level()) << std::endl;
+    std::cout << "calculate_spreads: " << scalar_ns << " ns/quote" << std::endl;
+
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (static_cast<int>(level) > static_cast<int>(detect_simd_level())) continue;
+
+        double ns = ns_per_quote([&]() {
+            calculate_spreads_batch(gamma, T, min_spread, S.data(), sigma.data(), k.data(), q.data(),
+                                    ask.data(), bid.data(), n, level);
+            sink = sink + ask[n - 1];
+        }, n, rounds);
+
+        double max_error = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            double scale = std::max(1.0, std::abs(S[i]));
+            max_error = std::max(max_error, std::abs(ask[i] - ref_ask[i]) / scale);
+            max_error = std::max(max_error, std::abs(bid[i] - ref_bid[i]) / scale);
+        }
+        std::cout << "batch " << simd_level_name(level) << ": " << ns << " ns/quote ("
+                  << scalar_ns / ns << "x), max error " << max_error
+                  << (max_error <= QUOTE_BATCH_TOLERANCE ? " within " : " EXCEEDS ")
+                  << QUOTE_BATCH_TOLERANCE << std::endl;
+    }
+    return 0;
+}
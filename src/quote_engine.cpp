@@ -0,0 +1,71 @@
+#include "quote_engine.hpp"
+#include <algorithm>
+#include <cmath>
+
+Quote QuoteEngine::quote(const MarketState& state, double inventory) const noexcept {
+    Quote quote;
+    quote.k = state.k > 0 ? state.k : order_intensity(state.bid, state.ask, state.bid_qty, state.ask_qty);
+    spreads(state.price, state.sigma, quote.k, inventory, quote.base_ask, quote.base_bid);
+
+    // Задержка onchain сдвигает обе стороны на одинаковую величину
+    quote.ask = quote.base_ask + state.latency_shift;
+    quote.bid = quote.base_bid + state.latency_shift;
+    quote.gas_cost = gas_cost(state.gas_price, state.trade_size);
+    return quote;
+}
+
+void QuoteEngine::spreads(double S_t, double sigma, double k, double q_t, double& ask, double& bid) const noexcept {
+    // Точная формула Avellaneda-Stoikov
+    double spread_term = (1.0 / gamma_) * std::log(1.0 + gamma_ / k);
+    double inventory_term = q_t * sigma * sigma * T_;
+
+    double delta_a = S_t + spread_term + inventory_term;  // Ask price
+    double delta_b = S_t - spread_term - inventory_term;  // Bid price
+
+    // Обеспечиваем минимальный спред (0.1% от цены по умолчанию)
+    double min_spread = S_t * min_spread_;
+    if (delta_a - delta_b < min_spread) {
+        double mid = (delta_a + delta_b) / 2;
+        delta_a = mid + min_spread / 2;
+        delta_b = mid - min_spread / 2;
+    }
+
+    // Неположительная цена: минимальный спред для корректности ask > bid
+    if (delta_a <= delta_b) {
+        double mid = (delta_a + delta_b) / 2;
+        delta_a = mid + 0.05;
+        delta_b = mid - 0.05;
+    }
+
+    ask = delta_a;
+    bid = delta_b;
+}
+
+size_t QuoteEngine::ladder(double S_t, double sigma, double k, double q_t, const LadderLevel* levels, size_t n,
+                           double* ask, double* bid, double* size, size_t capacity) const noexcept {
+    size_t count = std::min(n, capacity);
+
+    // Общие члены для всех уровней
+    double spread_term = (1.0 / gamma_) * std::log(1.0 + gamma_ / k);
+    double inventory_term = q_t * sigma * sigma * T_;
+    double min_spread = S_t * min_spread_;
+
+    // Условия через выбор, а не ветвления: цикл без переходов по данным
+    for (size_t i = 0; i < count; ++i) {
+        double distance = spread_term + levels[i].offset * S_t;
+        double shift = levels[i].skew * inventory_term;
+        double delta_a = S_t + distance + shift;
+        double delta_b = S_t - distance - shift;
+        double mid = (delta_a + delta_b) / 2;
+
+        bool narrow = delta_a - delta_b < min_spread;
+        delta_a = narrow ? mid + min_spread / 2 : delta_a;
+        delta_b = narrow ? mid - min_spread / 2 : delta_b;
+
+        bool crossed = delta_a <= delta_b;
+        ask[i] = crossed ? mid + 0.05 : delta_a;
+        bid[i] = crossed ? mid - 0.05 : delta_b;
+        size[i] = levels[i].size;
+    }
+    return count;
+}
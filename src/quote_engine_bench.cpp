@@ -0,0 +1,112 @@
+#include "latency_histogram.hpp"
+#include "quote_engine.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+// Время QuoteEngine::quote на котировку и отсутствие аллокаций на горячем пути.
+// Состояния генерируются заранее, включая граничные случаи (узкий стакан,
+// срабатывание минимального спреда, неположительная цена), чтобы показать,
+// что время не зависит от ветки.
+//   quote_engine_bench [states] [rounds]
+
+// Счетчик аллокаций: в замеряемом цикле должен остаться нулевым
+static size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+volatile double sink = 0.0;
+
+// Замер блоками: одиночный вызов короче разрешения часов
+constexpr size_t BLOCK = 16;
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 500;
+    n = (n + BLOCK - 1) / BLOCK * BLOCK;
+
+    QuoteEngine engine(0.1, 300.0);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> price(1000.0, 3000.0);
+    std::uniform_real_distribution<double> half_spread(0.0, 2.0);
+    std::uniform_real_distribution<double> qty(0.0, 50.0);
+    std::uniform_real_distribution<double> vol(0.001, 0.05);
+    std::uniform_real_distribution<double> shift(-1.0, 1.0);
+    std::uniform_real_distribution<double> inv(-10.0, 10.0);
+
+    std::vector<MarketState> states(n);
+    std::vector<double> inventory(n);
+    for (size_t i = 0; i < n; ++i) {
+        MarketState& s = states[i];
+        double mid = price(rng);
+        double half = half_spread(rng);
+        s.price = mid;
+        s.bid = mid - half;
+        s.ask = mid + half;
+        s.bid_qty = qty(rng);
+        s.ask_qty = qty(rng);
+        s.sigma = vol(rng);
+        s.gas_price = 50e9;
+        s.trade_size = 1.0;
+        s.latency_shift = shift(rng);
+        inventory[i] = inv(rng);
+
+        switch (i % 8) {
+        case 0: s.ask = s.bid; break;            // Пустой спред стакана: k упирается в предел
+        case 1: inventory[i] = 0.0; break;       // Срабатывает минимальный спред 0.1%
+        case 2: s.price = 0.0; break;            // Неположительная цена: запасной спред
+        default: break;
+        }
+    }
+
+    std::vector<Quote> quotes(n);
+    for (size_t i = 0; i < n; ++i) quotes[i] = engine.quote(states[i], inventory[i]);  // Прогрев
+
+    LatencyHistogram histogram;  // Нс на блок из BLOCK котировок
+    size_t allocations_before = allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n; i += BLOCK) {
+            auto block_start = std::chrono::steady_clock::now();
+            for (size_t j = i; j < i + BLOCK; ++j) quotes[j] = engine.quote(states[j], inventory[j]);
+            auto block_end = std::chrono::steady_clock::now();
+            histogram.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(block_end - block_start).count()));
+        }
+        sink = sink + quotes[n - 1].ask;
+    }
+    double elapsed_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    size_t allocations = allocation_count - allocations_before;
+
+    size_t invalid = 0;
+    for (const Quote& q : quotes) {
+        if (!(q.ask > q.bid)) ++invalid;
+    }
+
+    auto snapshot = histogram.snapshot();
+    std::cout << "Quotes: " << n * rounds << " (" << n << " states x " << rounds << " rounds)" << std::endl;
+    std::cout << "Mean: " << elapsed_ns / (static_cast<double>(n) * rounds) << " ns/quote"
+              << " (including timer reads per block of " << BLOCK << ")" << std::endl;
+    std::cout << "Per quote, block-averaged: p50 " << snapshot.percentile(50) / double(BLOCK)
+              << " ns, p99 " << snapshot.percentile(99) / double(BLOCK)
+              << " ns, p99.9 " << snapshot.percentile(99.9) / double(BLOCK)
+              << " ns, max " << snapshot.max() / double(BLOCK) << " ns" << std::endl;
+    std::cout << "Allocations in timed loop: " << allocations << std::endl;
+    std::cout << "Crossed quotes: " << invalid << std::endl;
+    return allocations == 0 && invalid == 0 ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+#include "quote_engine.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+// Лестница котировок на 5, 20 и 100 уровней: QuoteEngine::ladder (общие члены
+// один раз на лестницу) против вызова spreads на каждый уровень. Проверяется
+// совпадение уровней со spreads и отсутствие аллокаций.
+//   quote_ladder_bench [states] [rounds]
+
+// Счетчик аллокаций: в замеряемом цикле должен остаться нулевым
+static size_t allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr size_t MAX_LEVELS = 100;
+
+volatile double sink = 0.0;
+
+struct State {
+    double S_t;
+    double sigma;
+    double k;
+    double q;
+};
+
+// Уровни: объем растет, отступ по 2 б.п. на уровень, дальние уровни слабее реагируют на инвентарь
+std::vector<LadderLevel> make_levels(size_t n) {
+    std::vector<LadderLevel> levels(n);
+    for (size_t i = 0; i < n; ++i) {
+        levels[i].size = 0.5 * (i + 1);
+        levels[i].offset = 0.0002 * i;
+        levels[i].skew = 1.0 / (1.0 + 0.1 * i);
+    }
+    return levels;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    QuoteEngine engine(0.1, 300.0);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> price(1000.0, 3000.0);
+    std::uniform_real_distribution<double> vol(0.001, 0.05);
+    std::uniform_real_distribution<double> intensity(0.1, 100.0);
+    std::uniform_real_distribution<double> inv(-10.0, 10.0);
+    std::vector<State> states(n);
+    for (State& s : states) s = State{price(rng), vol(rng), intensity(rng), inv(rng)};
+
+    QuoteLadder<MAX_LEVELS> ladder;
+    bool matches = true;
+
+    for (size_t level_count : {5, 20, 100}) {
+        std::vector<LadderLevel> levels = make_levels(level_count);
+
+        // Без отступов уровень лестницы совпадает со spreads при том же инвентарном члене
+        // (с отступом минимальный спред проверяется уже после отступа)
+        std::vector<LadderLevel> unshifted = levels;
+        for (LadderLevel& level : unshifted) level.offset = 0.0;
+        for (const State& s : states) {
+            engine.ladder(s.S_t, s.sigma, s.k, s.q, unshifted.data(), level_count, ladder);
+            for (size_t i = 0; i < level_count; ++i) {
+                double ask, bid;
+                engine.spreads(s.S_t, s.sigma, s.k, s.q * levels[i].skew, ask, bid);
+                if (std::fabs(ladder.ask[i] - ask) > 1e-9 * s.S_t || std::fabs(ladder.bid[i] - bid) > 1e-9 * s.S_t ||
+                    ladder.size[i] != levels[i].size) {
+                    matches = false;
+                }
+            }
+            // Первый уровень (skew = 1) — те же операции, что и в spreads: точное совпадение
+            double ask, bid;
+            engine.spreads(s.S_t, s.sigma, s.k, s.q, ask, bid);
+            if (ladder.ask[0] != ask || ladder.bid[0] != bid) matches = false;
+        }
+
+        size_t allocations_before = allocation_count;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (const State& s : states) {
+                engine.ladder(s.S_t, s.sigma, s.k, s.q, levels.data(), level_count, ladder);
+                sink = sink + ladder.ask[level_count - 1];
+            }
+        }
+        double ladder_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        size_t allocations = allocation_count - allocations_before;
+
+        // Прежний путь: spreads (с логарифмом) на каждый уровень и отступ поверх
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            for (const State& s : states) {
+                for (size_t i = 0; i < level_count; ++i) {
+                    double ask, bid;
+                    engine.spreads(s.S_t, s.sigma, s.k, s.q * levels[i].skew, ask, bid);
+                    double offset = levels[i].offset * s.S_t;
+                    ladder.ask[i] = ask + offset;
+                    ladder.bid[i] = bid - offset;
+                }
+                sink = sink + ladder.ask[level_count - 1];
+            }
+        }
+        double spreads_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        double ladders = static_cast<double>(n) * rounds;
+        std::cout << level_count << " levels: ladder " << ladder_ns / ladders << " ns ("
+                  << ladder_ns / (ladders * level_count) << " ns/level), spreads per level "
+                  << spreads_ns / ladders << " ns (" << spreads_ns / ladder_ns << "x), allocations "
+                  << allocations << std::endl;
+    }
+
+    std::cout << "Levels match spreads: " << (matches ? "yes" : "NO") << std::endl;
+    return matches ? 0 : 1;
+}
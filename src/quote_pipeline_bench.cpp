@@ -0,0 +1,125 @@
+#include "market_maker.hpp"
+#include "quote_engine.hpp"
+#include "quote_pipeline.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Собранные из политик QuotePipeline против монолитного расчета MarketMaker
+// (calculate_spreads + adjust_spreads_for_onchain + calculate_gas_cost +
+// adjust_spreads_for_pmm, все шаги при каждом вызове) и QuoteEngine.
+//   quote_pipeline_bench [states] [rounds]
+
+namespace {
+
+volatile double sink = 0.0;
+
+template <class F>
+double ns_per_quote(F&& f, size_t n, int rounds) {
+    f();  // Прогрев
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) f();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (static_cast<double>(n) * rounds);
+}
+
+template <class Pipeline>
+double run_pipeline(const char* name, const Pipeline& pipeline, const std::vector<MarketState>& states,
+                    const std::vector<double>& inventory, std::vector<Quote>& quotes, int rounds,
+                    double monolithic_ns) {
+    size_t n = states.size();
+    double ns = ns_per_quote([&]() {
+        for (size_t i = 0; i < n; ++i) quotes[i] = pipeline.quote(states[i], inventory[i]);
+        sink = sink + quotes[n - 1].ask;
+    }, n, rounds);
+    std::cout << name << ": " << ns << " ns/quote (" << monolithic_ns / ns << "x)" << std::endl;
+    return ns;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4096;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    const double gamma = 0.1;
+    const double T = 300.0;
+    const double latency = 12.0;
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> price(1000.0, 3000.0);
+    std::uniform_real_distribution<double> half_spread(0.01, 2.0);
+    std::uniform_real_distribution<double> qty(0.0, 50.0);
+    std::uniform_real_distribution<double> vol(0.001, 0.05);
+    std::uniform_real_distribution<double> shift(-1.0, 1.0);
+    std::uniform_real_distribution<double> depth(1.0, 1000.0);
+    std::uniform_real_distribution<double> inv(-10.0, 10.0);
+
+    std::vector<MarketState> states(n);
+    std::vector<double> inventory(n);
+    for (size_t i = 0; i < n; ++i) {
+        MarketState& s = states[i];
+        double mid = price(rng);
+        double half = half_spread(rng);
+        s.price = mid;
+        s.bid = mid - half;
+        s.ask = mid + half;
+        s.bid_qty = qty(rng);
+        s.ask_qty = qty(rng);
+        s.sigma = vol(rng);
+        s.gas_price = 50e9;
+        s.trade_size = 1.0;
+        s.latency_shift = shift(rng);
+        s.pool_depth = depth(rng);
+        inventory[i] = inv(rng);
+    }
+
+    // Монолитный путь: все onchain-корректировки, включая случайный сдвиг задержки
+    MarketMaker mm(gamma, T);
+    std::vector<double> mono_ask(n), mono_bid(n);
+    double gas_total = 0.0;
+    double monolithic_ns = ns_per_quote([&]() {
+        for (size_t i = 0; i < n; ++i) {
+            const MarketState& s = states[i];
+            double k = mm.estimate_order_intensity(s.bid, s.ask, s.bid_qty, s.ask_qty);
+            auto [a, b] = mm.calculate_spreads(s.price, s.sigma, k, inventory[i]);
+            auto [la, lb] = mm.adjust_spreads_for_onchain(s.price, a, b, latency, s.sigma,
+                                                          s.gas_price, s.trade_size);
+            double gas = mm.calculate_gas_cost(s.gas_price, s.trade_size);
+            auto [pa, pb] = mm.adjust_spreads_for_pmm(s.price, la, lb, s.pool_depth);
+            mono_ask[i] = pa;
+            mono_bid[i] = pb;
+            gas_total += gas;
+        }
+        sink = sink + mono_ask[n - 1] + gas_total;
+    }, n, rounds);
+    std::cout << "monolithic MarketMaker: " << monolithic_ns << " ns/quote" << std::endl;
+
+    QuoteEngine engine(gamma, T);
+    std::vector<Quote> reference(n), quotes(n);
+    double engine_ns = ns_per_quote([&]() {
+        for (size_t i = 0; i < n; ++i) reference[i] = engine.quote(states[i], inventory[i]);
+        sink = sink + reference[n - 1].ask;
+    }, n, rounds);
+    std::cout << "QuoteEngine: " << engine_ns << " ns/quote (" << monolithic_ns / engine_ns << "x)" << std::endl;
+
+    run_pipeline("CexQuotePipeline", CexQuotePipeline(gamma, T), states, inventory, quotes, rounds, monolithic_ns);
+    run_pipeline("DexQuotePipeline", DexQuotePipeline(gamma, T), states, inventory, quotes, rounds, monolithic_ns);
+    run_pipeline("PmmQuotePipeline", PmmQuotePipeline(gamma, T), states, inventory, quotes, rounds, monolithic_ns);
+    run_pipeline("OnchainQuotePipeline", OnchainQuotePipeline(gamma, T), states, inventory, quotes, rounds,
+                 monolithic_ns);
+
+    // Без ветвлений минимальный спред может отличаться от QuoteEngine на единицы ulp
+    double max_error = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double scale = std::max(1.0, std::abs(states[i].price));
+        max_error = std::max(max_error, std::abs(quotes[i].ask - reference[i].ask) / scale);
+        max_error = std::max(max_error, std::abs(quotes[i].bid - reference[i].bid) / scale);
+    }
+    std::cout << "OnchainQuotePipeline vs QuoteEngine: max relative error " << max_error << std::endl;
+    return max_error <= 1e-12 ? 0 : 1;
+}
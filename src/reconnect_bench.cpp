@@ -0,0 +1,173 @@
+#include "binance_client.hpp"
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Бенчмарк переподключения: локальный TLS WebSocket сервер вместо Binance
+// держит каждое соединение hold_ms и закрывает его. Клиент переподключается
+// без задержки, измеряется время resolve + TCP + TLS + WebSocket handshake
+// с возобновлением TLS-сессии и без него.
+
+namespace {
+
+// Самоподписанный сертификат EC P-256 в памяти
+void use_self_signed_certificate(ssl::context& ctx) {
+    EVP_PKEY* pkey = nullptr;
+    EVP_PKEY_CTX* kctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    EVP_PKEY_keygen_init(kctx);
+    EVP_PKEY_CTX_set_ec_paramgen_curve_nid(kctx, NID_X9_62_prime256v1);
+    EVP_PKEY_keygen(kctx, &pkey);
+    EVP_PKEY_CTX_free(kctx);
+
+    X509* cert = X509_new();
+    X509_set_version(cert, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+    X509_set_pubkey(cert, pkey);
+    X509_NAME* name = X509_get_subject_name(cert);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                               reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert, name);
+    X509_sign(cert, pkey, EVP_sha256());
+
+    SSL_CTX_use_certificate(ctx.native_handle(), cert);
+    SSL_CTX_use_PrivateKey(ctx.native_handle(), pkey);
+    X509_free(cert);
+    EVP_PKEY_free(pkey);
+}
+
+const char* SNAPSHOT_BODY =
+    R"({"lastUpdateId":100,"bids":[["2000.00000000","1.00000000"]],"asks":[["2001.00000000","1.00000000"]]})";
+const char* DEPTH_FRAME =
+    R"({"stream":"ethusdt@depth@100ms","data":{"e":"depthUpdate","E":1700000000000,"s":"ETHUSDT","U":101,"u":101,)"
+    R"("b":[["2000.00000000","2.00000000"]],"a":[]}})";
+
+// Одно соединение: WebSocket-апгрейд или REST-снапшот на том же порту
+void serve_connection(tcp::socket socket, ssl::context& ctx, std::chrono::milliseconds hold) {
+    beast::error_code ec;
+    websocket::stream<beast::ssl_stream<tcp::socket>> ws(std::move(socket), ctx);
+    ws.next_layer().handshake(ssl::stream_base::server, ec);
+    if (ec) return;
+
+    beast::flat_buffer buffer;
+    http::request<http::string_body> req;
+    http::read(ws.next_layer(), buffer, req, ec);
+    if (ec) return;
+
+    if (websocket::is_upgrade(req)) {
+        ws.accept(req, ec);
+        if (ec) return;
+        ws.write(net::buffer(std::string(DEPTH_FRAME)), ec);
+        std::this_thread::sleep_for(hold);
+        ws.close(websocket::close_code::going_away, ec);
+        return;
+    }
+
+    http::response<http::string_body> res{http::status::ok, req.version()};
+    res.set(http::field::content_type, "application/json");
+    res.body() = SNAPSHOT_BODY;
+    res.prepare_payload();
+    http::write(ws.next_layer(), res, ec);
+    ws.next_layer().shutdown(ec);
+}
+
+struct Result {
+    std::vector<double> connect_us;
+    uint64_t resumed;
+};
+
+Result run_client(unsigned short port, bool resumption, int reconnects) {
+    net::io_context ioc;
+    BinanceClient client(ioc);
+
+    BinanceClient::TransportConfig transport;
+    transport.host = transport.rest_host = "127.0.0.1";
+    transport.port = transport.rest_port = std::to_string(port);
+    transport.verify_peer = false;
+    transport.session_resumption = resumption;
+    client.set_transport(transport);
+
+    BinanceClient::ReconnectPolicy policy;
+    policy.initial_delay = std::chrono::milliseconds(0);
+    policy.jitter = 0.0;
+    client.set_reconnect_policy(policy);
+
+    client.connect_and_subscribe(std::vector<std::string>{"ethusdt"}, [](const BinanceClient::MarketData&) {});
+    std::thread io([&ioc]() { ioc.run(); });
+
+    Result result{};
+    uint64_t seen = 0;
+    while (result.connect_us.size() < static_cast<size_t>(reconnects) + 1) {
+        auto stats = client.connection_stats();
+        if (stats.connects != seen) {
+            seen = stats.connects;
+            result.connect_us.push_back(stats.last_connect_ns / 1e3);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    result.resumed = client.connection_stats().tls_resumed;
+
+    ioc.stop();
+    io.join();
+
+    // Первое подключение всегда с полным handshake
+    result.connect_us.erase(result.connect_us.begin());
+    return result;
+}
+
+void report(const char* name, Result result) {
+    auto& v = result.connect_us;
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    std::cout << name << ": mean " << sum / v.size() << " us, p50 " << v[v.size() / 2]
+              << " us, p99 " << v[std::min(v.size() - 1, v.size() * 99 / 100)]
+              << " us, max " << v.back() << " us, resumed " << result.resumed
+              << "/" << v.size() + 1 << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int reconnects = argc > 1 ? std::atoi(argv[1]) : 200;
+    std::chrono::milliseconds hold(argc > 2 ? std::atoi(argv[2]) : 5);
+
+    ssl::context server_ctx(ssl::context::tls_server);
+    use_self_signed_certificate(server_ctx);
+
+    net::io_context server_ioc;
+    tcp::acceptor acceptor(server_ioc, tcp::endpoint(net::ip::make_address("127.0.0.1"), 0));
+    unsigned short port = acceptor.local_endpoint().port();
+
+    std::atomic<bool> stopping{false};
+    std::thread server([&]() {
+        for (;;) {
+            beast::error_code ec;
+            tcp::socket socket(server_ioc);
+            acceptor.accept(socket, ec);
+            if (ec || stopping) return;
+            socket.set_option(tcp::no_delay(true), ec);
+            std::thread(serve_connection, std::move(socket), std::ref(server_ctx), hold).detach();
+        }
+    });
+
+    std::cout << "Reconnects: " << reconnects << ", hold: " << hold.count() << " ms" << std::endl;
+    report("Full handshake", run_client(port, false, reconnects));
+    report("Session resumption", run_client(port, true, reconnects));
+
+    // Блокирующий accept не прерывается закрытием сокета: будим его подключением
+    stopping = true;
+    beast::error_code ec;
+    tcp::socket wakeup(server_ioc);
+    wakeup.connect(acceptor.local_endpoint(), ec);
+    server.join();
+    return 0;
+}
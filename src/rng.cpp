@@ -0,0 +1,274 @@
+#include "rng.hpp"
+#include "quote_batch.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <immintrin.h>
+#include <mutex>
+#include <random>
+
+namespace {
+
+// Таблицы ziggurat для N(0, 1): 128 слоев равной площади (Marsaglia, Tsang; вариант ZIGNOR)
+struct ZigguratTables {
+    static constexpr int LAYERS = 128;
+    static constexpr double R = 3.442619855899;          // Начало хвоста
+    static constexpr double V = 9.91256303526217e-3;     // Площадь слоя
+
+    double x[LAYERS + 1];
+    double ratio[LAYERS];  // x[i + 1] / x[i]: доля слоя, целиком лежащая под кривой
+
+    ZigguratTables() {
+        double f = std::exp(-0.5 * R * R);
+        x[0] = V / f;  // Основание с хвостом как прямоугольник той же площади
+        x[1] = R;
+        x[LAYERS] = 0.0;
+        for (int i = 2; i < LAYERS; ++i) {
+            x[i] = std::sqrt(-2.0 * std::log(V / x[i - 1] + f));
+            f = std::exp(-0.5 * x[i] * x[i]);
+        }
+        for (int i = 0; i < LAYERS; ++i) ratio[i] = x[i + 1] / x[i];
+    }
+};
+
+const ZigguratTables ziggurat;
+
+// Хвост |x| > R (Marsaglia, 1964)
+double normal_tail(Rng& rng, bool negative) {
+    double x, y;
+    do {
+        x = std::log(1.0 - rng.uniform()) / ZigguratTables::R;
+        y = std::log(1.0 - rng.uniform());
+    } while (-2.0 * y < x * x);
+    return negative ? x - ZigguratTables::R : ZigguratTables::R - x;
+}
+
+// next_bits — источник 64-битных чисел для основного пути (поштучно из rng
+// или из заранее сгенерированного буфера); редкий медленный путь берет числа из rng
+template <class NextBits>
+inline double ziggurat_normal(NextBits&& next_bits, Rng& rng) {
+    for (;;) {
+        // Старшие 53 бита — u в [-1, 1), младшие 7 — номер слоя
+        uint64_t bits = next_bits();
+        double u = static_cast<double>(bits >> 11) * 0x1.0p-52 - 1.0;
+        int i = static_cast<int>(bits & (ZigguratTables::LAYERS - 1));
+
+        // Быстрый путь (~99%): точка в прямоугольнике под кривой
+        if (std::fabs(u) < ziggurat.ratio[i]) return u * ziggurat.x[i];
+        if (i == 0) return normal_tail(rng, u < 0);
+
+        double x = u * ziggurat.x[i];
+        double f0 = std::exp(-0.5 * (ziggurat.x[i] * ziggurat.x[i] - x * x));
+        double f1 = std::exp(-0.5 * (ziggurat.x[i + 1] * ziggurat.x[i + 1] - x * x));
+        if (f1 + rng.uniform() * (f0 - f1) < 1.0) return x;
+    }
+}
+
+const uint32_t PHILOX_M0 = 0xD2511F53u;
+const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+const uint32_t PHILOX_W0 = 0x9E3779B9u;  // Приращения ключа между раундами
+const uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+inline void philox_round(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1) {
+    uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c0;
+    uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c2;
+    uint32_t x0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    uint32_t x2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c1 = static_cast<uint32_t>(p1);
+    c3 = static_cast<uint32_t>(p0);
+    c0 = x0;
+    c2 = x2;
+}
+
+inline void philox_block(uint64_t key, uint64_t stream, uint64_t counter, uint64_t* out) {
+    uint32_t c0 = static_cast<uint32_t>(counter);
+    uint32_t c1 = static_cast<uint32_t>(counter >> 32);
+    uint32_t c2 = static_cast<uint32_t>(stream);
+    uint32_t c3 = static_cast<uint32_t>(stream >> 32);
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+
+    for (int round = 0; round < 10; ++round) {
+        philox_round(c0, c1, c2, c3, k0, k1);
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = (static_cast<uint64_t>(c1) << 32) | c0;
+    out[1] = (static_cast<uint64_t>(c3) << 32) | c2;
+}
+
+// SIMD-ядра: каждое 32-битное слово счетчика лежит в своей 64-битной дорожке,
+// mul_epu32 дает полное 64-битное произведение (hi и lo одного раунда).
+// maskz-варианты с полной маской — обход ложного -Wmaybe-uninitialized в GCC 12
+__attribute__((target("avx2")))
+void philox_blocks_avx2(uint64_t key, uint64_t stream, uint64_t counter, size_t blocks, uint64_t* out) {
+    const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFFll);
+    const __m256i m0 = _mm256_set1_epi64x(PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi64x(PHILOX_M1);
+    const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+    const __m256i s0 = _mm256_set1_epi64x(static_cast<uint32_t>(stream));
+    const __m256i s1 = _mm256_set1_epi64x(static_cast<uint32_t>(stream >> 32));
+
+    size_t i = 0;
+    for (; i + 4 <= blocks; i += 4) {
+        __m256i ctr = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<int64_t>(counter + i)), lane);
+        __m256i c0 = _mm256_and_si256(ctr, low32);
+        __m256i c1 = _mm256_srli_epi64(ctr, 32);
+        __m256i c2 = s0;
+        __m256i c3 = s1;
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+
+        for (int round = 0; round < 10; ++round) {
+            __m256i p0 = _mm256_mul_epu32(m0, c0);
+            __m256i p1 = _mm256_mul_epu32(m1, c2);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p1, 32), c1), _mm256_set1_epi64x(k0));
+            c2 = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_epi64(p0, 32), c3), _mm256_set1_epi64x(k1));
+            c1 = _mm256_and_si256(p1, low32);
+            c3 = _mm256_and_si256(p0, low32);
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        // Слова блока: (c1:c0), (c3:c2); чередуем блоки в порядке счетчика
+        __m256i v0 = _mm256_or_si256(_mm256_slli_epi64(c1, 32), c0);
+        __m256i v1 = _mm256_or_si256(_mm256_slli_epi64(c3, 32), c2);
+        __m256i lo = _mm256_unpacklo_epi64(v0, v1);
+        __m256i hi = _mm256_unpackhi_epi64(v0, v1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 4), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    for (; i < blocks; ++i) philox_block(key, stream, counter + i, out + 2 * i);
+}
+
+__attribute__((target("avx512f")))
+void philox_blocks_avx512(uint64_t key, uint64_t stream, uint64_t counter, size_t blocks, uint64_t* out) {
+    const __m512i low32 = _mm512_set1_epi64(0xFFFFFFFFll);
+    const __m512i m0 = _mm512_set1_epi64(PHILOX_M0);
+    const __m512i m1 = _mm512_set1_epi64(PHILOX_M1);
+    const __m512i lane = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m512i s0 = _mm512_set1_epi64(static_cast<uint32_t>(stream));
+    const __m512i s1 = _mm512_set1_epi64(static_cast<uint32_t>(stream >> 32));
+    const __m512i first = _mm512_setr_epi64(0, 8, 1, 9, 2, 10, 3, 11);
+    const __m512i second = _mm512_setr_epi64(4, 12, 5, 13, 6, 14, 7, 15);
+
+    size_t i = 0;
+    for (; i + 8 <= blocks; i += 8) {
+        __m512i ctr = _mm512_add_epi64(_mm512_set1_epi64(static_cast<int64_t>(counter + i)), lane);
+        __m512i c0 = _mm512_and_si512(ctr, low32);
+        __m512i c1 = _mm512_maskz_srli_epi64(0xFF, ctr, 32);
+        __m512i c2 = s0;
+        __m512i c3 = s1;
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+
+        for (int round = 0; round < 10; ++round) {
+            __m512i p0 = _mm512_maskz_mul_epu32(0xFF, m0, c0);
+            __m512i p1 = _mm512_maskz_mul_epu32(0xFF, m1, c2);
+            c0 = _mm512_xor_si512(_mm512_xor_si512(_mm512_maskz_srli_epi64(0xFF, p1, 32), c1),
+                                  _mm512_set1_epi64(k0));
+            c2 = _mm512_xor_si512(_mm512_xor_si512(_mm512_maskz_srli_epi64(0xFF, p0, 32), c3),
+                                  _mm512_set1_epi64(k1));
+            c1 = _mm512_and_si512(p1, low32);
+            c3 = _mm512_and_si512(p0, low32);
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+
+        __m512i v0 = _mm512_or_si512(_mm512_maskz_slli_epi64(0xFF, c1, 32), c0);
+        __m512i v1 = _mm512_or_si512(_mm512_maskz_slli_epi64(0xFF, c3, 32), c2);
+        _mm512_storeu_si512(out + 2 * i, _mm512_permutex2var_epi64(v0, first, v1));
+        _mm512_storeu_si512(out + 2 * i + 8, _mm512_permutex2var_epi64(v0, second, v1));
+    }
+    for (; i < blocks; ++i) philox_block(key, stream, counter + i, out + 2 * i);
+}
+
+std::mutex seed_mutex;
+std::atomic<bool> seed_set{false};
+uint64_t seed_value = 0;
+
+// Потоки генераторов по умолчанию — в старшей половине, чтобы не пересекаться
+// с явно заданными номерами потоков
+std::atomic<uint64_t> next_default_stream{uint64_t(1) << 63};
+
+} // namespace
+
+Rng::Rng() {
+    seed(global_seed(), next_default_stream.fetch_add(1, std::memory_order_relaxed));
+}
+
+double Rng::normal() {
+    return ziggurat_normal([this]() { return next_u64(); }, *this);
+}
+
+// Массивы заполняются порциями: блоки Philox для порции считаются пачкой
+// (generate_blocks), затем ziggurat читает биты из буфера. Последовательность
+// отличается от поштучных вызовов normal(), но так же воспроизводима.
+void Rng::fill_normal(double* out, size_t n, double mean, double stddev) {
+    uint64_t bits[2 * BULK_BLOCKS];
+    size_t i = 0;
+    while (i < n) {
+        // Запас на отказы ziggurat (~1%): буфер не исчерпается раньше порции
+        size_t chunk = std::min(n - i, 2 * BULK_BLOCKS * 7 / 8);
+        generate_blocks(counter_, BULK_BLOCKS, bits);
+        counter_ += BULK_BLOCKS;
+
+        size_t pos = 0;
+        auto next_bits = [&]() { return pos < 2 * BULK_BLOCKS ? bits[pos++] : next_u64(); };
+        for (size_t end = i + chunk; i < end; ++i) out[i] = mean + stddev * ziggurat_normal(next_bits, *this);
+    }
+}
+
+void Rng::fill_uniform(double* out, size_t n) {
+    uint64_t bits[2 * BULK_BLOCKS];
+    size_t i = 0;
+    while (i < n) {
+        size_t chunk = std::min(n - i, 2 * BULK_BLOCKS);
+        size_t blocks = (chunk + 1) / 2;
+        generate_blocks(counter_, blocks, bits);
+        counter_ += blocks;
+        for (size_t j = 0; j < chunk; ++j) out[i + j] = static_cast<double>(bits[j] >> 11) * 0x1.0p-53;
+        i += chunk;
+    }
+}
+
+void Rng::generate_block(uint64_t counter, uint64_t out[2]) const {
+    philox_block(key_, stream_, counter, out);
+}
+
+void Rng::generate_blocks(uint64_t counter, size_t blocks, uint64_t* out) const {
+    switch (detect_simd_level()) {
+        case SimdLevel::Avx512:
+            philox_blocks_avx512(key_, stream_, counter, blocks, out);
+            return;
+        case SimdLevel::Avx2:
+            philox_blocks_avx2(key_, stream_, counter, blocks, out);
+            return;
+        case SimdLevel::Scalar:
+            for (size_t i = 0; i < blocks; ++i) philox_block(key_, stream_, counter + i, out + 2 * i);
+            return;
+    }
+}
+
+void set_global_seed(uint64_t seed) {
+    std::lock_guard<std::mutex> lock(seed_mutex);
+    seed_value = seed;
+    seed_set.store(true, std::memory_order_release);
+}
+
+uint64_t global_seed() {
+    if (seed_set.load(std::memory_order_acquire)) return seed_value;
+    std::lock_guard<std::mutex> lock(seed_mutex);
+    if (!seed_set.load(std::memory_order_relaxed)) {
+        std::random_device rd;
+        seed_value = (static_cast<uint64_t>(rd()) << 32) | rd();
+        seed_set.store(true, std::memory_order_release);
+    }
+    return seed_value;
+}
+
+Rng& thread_rng() {
+    thread_local Rng rng;
+    return rng;
+}
@@ -0,0 +1,94 @@
+#include "rng.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Нормальные величины: std::mt19937 + std::normal_distribution (прежний
+// utils::normal_dist) против Rng (Philox + ziggurat) поштучно и массивом.
+// Проверяются моменты распределения и воспроизводимость по seed.
+//   rng_bench [n] [rounds]
+
+namespace {
+
+volatile double sink = 0.0;
+
+template <class F>
+double ns_per_value(F&& f, size_t n, int rounds) {
+    f();  // Прогрев
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) f();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (static_cast<double>(n) * rounds);
+}
+
+void print_moments(const char* name, const std::vector<double>& values) {
+    double mean = 0.0, m2 = 0.0, m4 = 0.0;
+    for (double v : values) mean += v;
+    mean /= values.size();
+    for (double v : values) {
+        double d = v - mean;
+        m2 += d * d;
+        m4 += d * d * d * d;
+    }
+    m2 /= values.size();
+    m4 /= values.size();
+    std::cout << "  " << name << ": mean " << mean << ", variance " << m2
+              << ", kurtosis " << m4 / (m2 * m2) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1 << 16;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 200;
+
+    std::vector<double> reference(n), values(n);
+
+    std::mt19937 mt(42);
+    std::normal_distribution<double> dist(0.0, 1.0);
+    double mt_ns = ns_per_value([&]() {
+        for (size_t i = 0; i < n; ++i) reference[i] = dist(mt);
+        sink = sink + reference[n - 1];
+    }, n, rounds);
+
+    Rng rng(42);
+    double scalar_ns = ns_per_value([&]() {
+        for (size_t i = 0; i < n; ++i) values[i] = rng.normal();
+        sink = sink + values[n - 1];
+    }, n, rounds);
+
+    double bulk_ns = ns_per_value([&]() {
+        rng.fill_normal(values.data(), n);
+        sink = sink + values[n - 1];
+    }, n, rounds);
+
+    double uniform_ns = ns_per_value([&]() {
+        rng.fill_uniform(values.data(), n);
+        sink = sink + values[n - 1];
+    }, n, rounds);
+
+    std::cout << "mt19937 + normal_distribution: " << mt_ns << " ns/value" << std::endl;
+    std::cout << "Rng::normal: " << scalar_ns << " ns/value (" << mt_ns / scalar_ns << "x)" << std::endl;
+    std::cout << "Rng::fill_normal: " << bulk_ns << " ns/value (" << mt_ns / bulk_ns << "x)" << std::endl;
+    std::cout << "Rng::fill_uniform: " << uniform_ns << " ns/value" << std::endl;
+
+    std::cout << "Moments (N(0, 1): mean 0, variance 1, kurtosis 3):" << std::endl;
+    print_moments("mt19937", reference);
+    rng.fill_normal(values.data(), n);
+    print_moments("Rng", values);
+
+    // Тот же seed и поток — та же последовательность; другой поток — другая
+    Rng a(7, 3), b(7, 3), c(7, 4);
+    bool same = true, distinct = false;
+    for (int i = 0; i < 1000; ++i) {
+        double x = a.normal();
+        same = same && x == b.normal();
+        distinct = distinct || x != c.normal();
+    }
+    std::cout << "Reproducible: " << (same ? "yes" : "NO")
+              << ", streams independent: " << (distinct ? "yes" : "NO") << std::endl;
+    return same && distinct ? 0 : 1;
+}
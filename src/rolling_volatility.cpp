@@ -0,0 +1,177 @@
+#include "rolling_volatility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+RollingVolatility::Horizon RollingVolatility::Horizon::rolling(size_t window) {
+    Horizon h;
+    h.kind = Kind::Window;
+    h.window = window;
+    return h;
+}
+
+RollingVolatility::Horizon RollingVolatility::Horizon::timed(uint64_t duration_ns) {
+    Horizon h;
+    h.kind = Kind::TimeWindow;
+    h.duration_ns = duration_ns;
+    return h;
+}
+
+RollingVolatility::Horizon RollingVolatility::Horizon::ewma(double alpha) {
+    Horizon h;
+    h.kind = Kind::Ewma;
+    h.alpha = alpha;
+    return h;
+}
+
+RollingVolatility::Horizon RollingVolatility::Horizon::ewma_halflife(uint64_t halflife_ns) {
+    Horizon h;
+    h.kind = Kind::Ewma;
+    h.halflife_ns = halflife_ns;
+    return h;
+}
+
+RollingVolatility::RollingVolatility(std::vector<Horizon> horizons, size_t capacity, double scale)
+    : scale_(scale) {
+    size_t longest = 1;
+    for (const Horizon& h : horizons) {
+        if (h.kind == Kind::Window) longest = std::max(longest, h.window);
+        states_.push_back(State{h});
+    }
+    if (capacity == 0) capacity = longest;
+    // Окно не может быть длиннее буфера
+    for (State& state : states_) {
+        if (state.horizon.kind == Kind::Window) {
+            state.horizon.window = std::max<size_t>(1, std::min(state.horizon.window, capacity));
+        }
+    }
+    returns_.assign(capacity, 0.0);
+    times_.assign(capacity, 0);
+}
+
+void RollingVolatility::reset() {
+    for (State& state : states_) state = State{state.horizon};
+    head_ = 0;
+    last_price_ = 0.0;
+    last_time_ = 0;
+    has_price_ = false;
+}
+
+void RollingVolatility::update(double price, uint64_t time_ns) {
+    if (!(price > 0.0)) return;
+    if (!has_price_) {
+        last_price_ = price;
+        last_time_ = time_ns;
+        has_price_ = true;
+        return;
+    }
+
+    double r = std::log(price / last_price_);
+    uint64_t dt = time_ns > last_time_ ? time_ns - last_time_ : 0;
+    last_price_ = price;
+    last_time_ = time_ns;
+
+    // Сначала вытесняем старые доходности: после этого слот head_ свободен во всех окнах
+    const size_t capacity = returns_.size();
+    for (State& state : states_) {
+        switch (state.horizon.kind) {
+            case Kind::Window:
+                if (state.n == state.horizon.window) remove_oldest(state);
+                break;
+            case Kind::TimeWindow:
+                while (state.n && times_[state.tail % capacity] + state.horizon.duration_ns <= time_ns) {
+                    remove_oldest(state);
+                }
+                if (state.n == capacity) remove_oldest(state);
+                break;
+            case Kind::Ewma:
+                break;
+        }
+    }
+
+    returns_[head_ % capacity] = r;
+    times_[head_ % capacity] = time_ns;
+    ++head_;
+
+    for (State& state : states_) {
+        if (state.horizon.kind == Kind::Ewma) {
+            update_ewma(state, r, dt);
+        } else {
+            add(state, r);
+        }
+    }
+}
+
+void RollingVolatility::add(State& state, double value) {
+    ++state.n;
+    double delta = value - state.mean;
+    state.mean += delta / static_cast<double>(state.n);
+    state.m2 += delta * (value - state.mean);
+}
+
+void RollingVolatility::remove_oldest(State& state) {
+    double value = returns_[state.tail % returns_.size()];
+    ++state.tail;
+    if (--state.n == 0) {
+        state.mean = 0.0;
+        state.m2 = 0.0;
+        state.removals = 0;
+        return;
+    }
+
+    double delta = value - state.mean;
+    state.mean -= delta / static_cast<double>(state.n);
+    state.m2 -= delta * (value - state.mean);
+    if (state.m2 < 0.0) state.m2 = 0.0;
+
+    // Вычитание накапливает ошибку округления: раз в окно пересчитываем
+    // сумму заново, в среднем это O(1) на тик
+    if (++state.removals >= returns_.size()) resync(state);
+}
+
+void RollingVolatility::resync(State& state) {
+    const size_t capacity = returns_.size();
+    double mean = 0.0;
+    double m2 = 0.0;
+    size_t n = 0;
+    for (uint64_t seq = state.tail; n < state.n; ++seq) {
+        double value = returns_[seq % capacity];
+        ++n;
+        double delta = value - mean;
+        mean += delta / static_cast<double>(n);
+        m2 += delta * (value - mean);
+    }
+    state.mean = mean;
+    state.m2 = m2;
+    state.removals = 0;
+}
+
+void RollingVolatility::update_ewma(State& state, double value, uint64_t dt_ns) {
+    double alpha = state.horizon.alpha;
+    if (state.horizon.halflife_ns) {
+        alpha = 1.0 - std::exp(-0.6931471805599453 * static_cast<double>(dt_ns) /
+                               static_cast<double>(state.horizon.halflife_ns));
+    }
+
+    if (state.n++ == 0) {
+        state.mean = value;
+        state.m2 = 0.0;
+        return;
+    }
+    // Инкрементальные EWMA среднего и дисперсии (West, 1979)
+    double delta = value - state.mean;
+    double increment = alpha * delta;
+    state.mean += increment;
+    state.m2 = (1.0 - alpha) * (state.m2 + delta * increment);
+}
+
+double RollingVolatility::variance(size_t horizon) const {
+    const State& state = states_[horizon];
+    if (state.n < 2) return 0.0;
+    if (state.horizon.kind == Kind::Ewma) return state.m2;
+    return state.m2 / static_cast<double>(state.n - 1);
+}
+
+double RollingVolatility::volatility(size_t horizon) const {
+    return std::sqrt(variance(horizon)) * scale_;
+}
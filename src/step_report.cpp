@@ -0,0 +1,30 @@
+#include "step_report.hpp"
+
+void print_step_report(std::ostream& out, const StepReport& report) {
+    const Quote& quote = report.quote;
+    const Fill& fill = report.fill;
+
+    if (fill.conflict) {
+        out << "Warning: Both buy and sell conditions triggered! "
+            << "Market price: " << fill.market_price
+            << ", Ask: " << quote.ask
+            << ", Bid: " << quote.bid << std::endl;
+    }
+
+    if (fill.side == FillSide::Buy) {
+        out << "Trade: BUY at " << fill.price << " (Market price: " << fill.market_price
+            << ", Gas cost: " << quote.gas_cost << ") ";
+    } else if (fill.side == FillSide::Sell) {
+        out << "Trade: SELL at " << fill.price << " (Market price: " << fill.market_price
+            << ", Gas cost: " << quote.gas_cost << ") ";
+    } else {
+        out << "No trade ";
+    }
+
+    out << "S_t: " << report.S_t
+        << ", Inventory: " << report.inventory
+        << ", Base Ask: " << quote.base_ask << ", Base Bid: " << quote.base_bid
+        << ", Adjusted Ask: " << quote.ask << ", Adjusted Bid: " << quote.bid
+        << ", Market Price: " << fill.market_price
+        << std::endl;
+}
@@ -0,0 +1,42 @@
+#include "tls_session_cache.hpp"
+
+TlsSessionCache::~TlsSessionCache() {
+    clear();
+}
+
+int TlsSessionCache::ex_index() {
+    static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+    return index;
+}
+
+void TlsSessionCache::enable(SSL_CTX* ctx) {
+    // Сессии храним сами (по одной на хост), внутренний кэш OpenSSL не нужен
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx, &TlsSessionCache::on_new_session);
+}
+
+void TlsSessionCache::attach(SSL* ssl) {
+    SSL_set_ex_data(ssl, ex_index(), this);
+    if(session_) SSL_set_session(ssl, session_);
+}
+
+void TlsSessionCache::clear() {
+    if(session_) {
+        SSL_SESSION_free(session_);
+        session_ = nullptr;
+    }
+}
+
+void TlsSessionCache::mark_closed(SSL* ssl) {
+    SSL_set_shutdown(ssl, SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN);
+}
+
+int TlsSessionCache::on_new_session(SSL* ssl, SSL_SESSION* session) {
+    auto* cache = static_cast<TlsSessionCache*>(SSL_get_ex_data(ssl, ex_index()));
+    if(!cache) return 0;
+
+    // В TLS 1.3 тикеты приходят после handshake, каждый следующий свежее
+    cache->clear();
+    cache->session_ = session;
+    return 1;  // Владение сессией переходит к нам
+}
@@ -0,0 +1,113 @@
+#include "work_stealing_pool.hpp"
+#include "thread_util.hpp"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(size_t threads, bool pin) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    ranges_ = std::make_unique<Range[]>(threads);
+    threads_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back(&WorkStealingPool::worker_loop, this, i, pin);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& thread : threads_) thread.join();
+}
+
+void WorkStealingPool::parallel_for(size_t n, const Task& task) {
+    if (n == 0) return;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Равные непрерывные диапазоны: соседние индексы (часто общие данные) — в одном потоке
+    size_t workers = threads_.size();
+    for (size_t i = 0; i < workers; ++i) {
+        std::lock_guard<std::mutex> range_lock(ranges_[i].mutex);
+        ranges_[i].begin = n * i / workers;
+        ranges_[i].end = n * (i + 1) / workers;
+    }
+    task_ = &task;
+    error_ = nullptr;
+    active_ = workers;
+    ++generation_;
+    start_.notify_all();
+
+    done_.wait(lock, [this]() { return active_ == 0; });
+    task_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+}
+
+WorkStealingPool::Stats WorkStealingPool::stats() const {
+    return Stats{tasks_.load(std::memory_order_relaxed), steals_.load(std::memory_order_relaxed)};
+}
+
+void WorkStealingPool::worker_loop(size_t worker, bool pin) {
+    if (pin) pin_current_thread(static_cast<int>(worker));
+
+    uint64_t seen = 0;
+    while (true) {
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            task = task_;
+        }
+
+        uint64_t executed = 0;
+        size_t index;
+        while (pop(worker, index) || (steal(worker) && pop(worker, index))) {
+            try {
+                (*task)(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+            ++executed;
+        }
+        tasks_.fetch_add(executed, std::memory_order_relaxed);
+
+        // Работы не осталось ни у кого: последний поток будит parallel_for
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0) done_.notify_one();
+    }
+}
+
+bool WorkStealingPool::pop(size_t worker, size_t& index) {
+    Range& range = ranges_[worker];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if (range.begin == range.end) return false;
+    index = range.begin++;
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t worker) {
+    // Обход жертв по кругу начиная со следующего потока; забираем конец самого
+    // первого непустого диапазона — половину, но не меньше одного индекса
+    size_t workers = threads_.size();
+    for (size_t offset = 1; offset < workers; ++offset) {
+        Range& victim = ranges_[(worker + offset) % workers];
+        size_t begin, end;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            size_t left = victim.end - victim.begin;
+            if (left == 0) continue;
+            end = victim.end;
+            begin = end - (left + 1) / 2;
+            victim.end = begin;
+        }
+        Range& own = ranges_[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        own.begin = begin;
+        own.end = end;
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}